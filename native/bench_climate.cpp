@@ -0,0 +1,121 @@
+/**
+ * bench_climate.cpp - DHT22 frame decoder check and benchmark
+ *
+ * Feeds ClimateSensor::decodeFrame the high-pulse durations the RMT
+ * receiver records for known DHT22 frames: positive and negative
+ * temperatures, with and without the sensor's 80 us response pulse ahead
+ * of the data, a frame with one corrupted bit and a truncated frame. Every
+ * one must decode to the expected reading or status before the decode time
+ * is measured.
+ *
+ * Usage: .pio/build/native/program bench-climate [--iterations <n>]
+ */
+
+#include "Arduino.h"
+#include "benchutil.h"
+#include "climatesensor.h"
+
+namespace {
+
+// High pulse widths of the DHT22 (datasheet: 26-28 us for 0, 70 us for 1)
+const uint16_t ZERO_US = 27;
+const uint16_t ONE_US = 70;
+const uint16_t RESPONSE_US = 80;
+
+const size_t MAX_PULSES = ClimateSensor::FRAME_BITS + 1;
+
+struct Frame {
+    uint16_t pulses[MAX_PULSES];
+    size_t count;
+};
+
+// Frame for humidity and temperature in tenths, checksum included
+Frame encodeFrame(uint16_t humidityTenths, int16_t temperatureTenths, bool response) {
+    uint16_t temperature = temperatureTenths < 0 ? (uint16_t)(-temperatureTenths) | 0x8000
+                                                 : (uint16_t)temperatureTenths;
+    uint8_t bytes[5] = {
+        (uint8_t)(humidityTenths >> 8), (uint8_t)humidityTenths,
+        (uint8_t)(temperature >> 8), (uint8_t)temperature, 0
+    };
+    bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+
+    Frame frame;
+    frame.count = 0;
+    if (response) {
+        frame.pulses[frame.count++] = RESPONSE_US;
+    }
+    for (size_t bit = 0; bit < ClimateSensor::FRAME_BITS; bit++) {
+        bool one = bytes[bit / 8] & (0x80 >> (bit % 8));
+        frame.pulses[frame.count++] = one ? ONE_US : ZERO_US;
+    }
+    return frame;
+}
+
+struct Case {
+    const char* name;
+    Frame frame;
+    ClimateStatus status;
+    float temperature;
+    float humidity;
+};
+
+bool checkCase(const Case& c) {
+    float temperature = 0, humidity = 0;
+    ClimateStatus status = ClimateSensor::decodeFrame(c.frame.pulses, c.frame.count,
+                                                      temperature, humidity);
+    bool ok = status == c.status &&
+              (status != CLIMATE_OK || (fabsf(temperature - c.temperature) < 0.01f &&
+                                        fabsf(humidity - c.humidity) < 0.01f));
+    printf("  %-28s %-8s %6.1f C %5.1f %%  %s\n", c.name, climateStatusName(status),
+           status == CLIMATE_OK ? temperature : 0.0f, status == CLIMATE_OK ? humidity : 0.0f,
+           ok ? "ok" : "FAILED");
+    return ok;
+}
+
+} // namespace
+
+int runClimateBenchmark(int argc, char** argv) {
+    unsigned long iterations = 1000000;
+    if (!bench::parseIterations(argc, argv, iterations)) {
+        return 2;
+    }
+
+    Case cases[] = {
+        {"23.1 C, 65.2 %", encodeFrame(652, 231, false), CLIMATE_OK, 23.1f, 65.2f},
+        {"23.1 C, 65.2 % with response", encodeFrame(652, 231, true), CLIMATE_OK, 23.1f, 65.2f},
+        {"-10.1 C, 45.0 %", encodeFrame(450, -101, true), CLIMATE_OK, -10.1f, 45.0f},
+        {"-0.3 C, 99.9 %", encodeFrame(999, -3, false), CLIMATE_OK, -0.3f, 99.9f},
+        {"corrupted bit", encodeFrame(652, 231, true), CLIMATE_CHECKSUM, 0, 0},
+        {"truncated frame", encodeFrame(652, 231, false), CLIMATE_TIMEOUT, 0, 0},
+    };
+    // Flip one humidity bit; drop the last data bit
+    Frame& corrupted = cases[4].frame;
+    corrupted.pulses[12] = corrupted.pulses[12] == ONE_US ? ZERO_US : ONE_US;
+    cases[5].frame.count--;
+
+    printf("Frame checks:\n");
+    bool ok = true;
+    for (const Case& c : cases) {
+        ok = checkCase(c) && ok;
+    }
+    if (!ok) {
+        fprintf(stderr, "DHT22 frame decoding failed\n");
+        return 1;
+    }
+
+    float temperature = 0, humidity = 0, sum = 0;
+    unsigned long long allocStart = bench::allocationCount();
+    uint64_t start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        const Frame& frame = cases[i & 3].frame;
+        ClimateSensor::decodeFrame(frame.pulses, frame.count, temperature, humidity);
+        sum += temperature;
+    }
+    uint64_t elapsed = bench::nowNanos() - start;
+    bench::doNotOptimize(sum);
+
+    printf("\n%lu iterations\n", iterations);
+    bench::printResult("decodeFrame", elapsed, iterations,
+                       bench::allocationCount() - allocStart, "");
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * bench_command.cpp - Command parsing and dispatch benchmark
+ *
+ * Compares the previous MQTTManager command path (payload copied into a
+ * String byte by byte, copied again, upper-cased, trimmed and compared with
+ * a String == chain) with the in-place perfect-hash parser, and measures
+ * end-to-end dispatch into the ControlTask command queue.
+ *
+ * Usage: .pio/build/native/program bench-command [--iterations <n>]
+ */
+
+#include "Arduino.h"
+#include "benchutil.h"
+#include "commandparser.h"
+
+namespace {
+
+// Payloads as they arrive from the broker: mixed case, stray whitespace, junk
+const char* const PAYLOADS[] = {"OPEN", "close", " Stop\n", "TOGGLE", "Open", "bogus", "CLOSE\r\n", "stop"};
+const size_t PAYLOAD_COUNT = sizeof(PAYLOADS) / sizeof(PAYLOADS[0]);
+
+// Previous MQTTManager::_onMessageReceived + _handleCommand parsing
+bool parseWithString(const uint8_t* payload, unsigned int length, GateCommand& command) {
+    String message;
+    message.reserve(length + 1);
+    for (unsigned int i = 0; i < length; i++) {
+        message += (char)payload[i];
+    }
+
+    String upperCommand = message;
+    upperCommand.toUpperCase();
+    upperCommand.trim();
+
+    if (upperCommand == "OPEN") {
+        command = GATE_COMMAND_OPEN;
+    } else if (upperCommand == "CLOSE") {
+        command = GATE_COMMAND_CLOSE;
+    } else if (upperCommand == "STOP") {
+        command = GATE_COMMAND_STOP;
+    } else if (upperCommand == "TOGGLE") {
+        command = GATE_COMMAND_TOGGLE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int runCommandBenchmark(int argc, char** argv) {
+    unsigned long iterations = 5000000;
+    if (!bench::parseIterations(argc, argv, iterations)) {
+        return 2;
+    }
+
+    size_t lengths[PAYLOAD_COUNT];
+    for (size_t i = 0; i < PAYLOAD_COUNT; i++) {
+        lengths[i] = strlen(PAYLOADS[i]);
+    }
+
+    // Both parsers must agree on every payload
+    for (size_t i = 0; i < PAYLOAD_COUNT; i++) {
+        GateCommand expected = GATE_COMMAND_STOP, actual = GATE_COMMAND_STOP;
+        bool legacy = parseWithString((const uint8_t*)PAYLOADS[i], lengths[i], expected);
+        bool parsed = parseGateCommand(PAYLOADS[i], lengths[i], actual);
+        if (legacy != parsed || (parsed && expected != actual)) {
+            fprintf(stderr, "Parser mismatch for \"%s\"\n", PAYLOADS[i]);
+            return 1;
+        }
+    }
+
+    unsigned long matched = 0;
+    GateCommand command;
+    unsigned long long allocStart = bench::allocationCount();
+    uint64_t start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        size_t p = i % PAYLOAD_COUNT;
+        matched += parseWithString((const uint8_t*)PAYLOADS[p], lengths[p], command);
+        bench::doNotOptimize(command);
+    }
+    uint64_t stringElapsed = bench::nowNanos() - start;
+    unsigned long long stringAllocs = bench::allocationCount() - allocStart;
+
+    allocStart = bench::allocationCount();
+    start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        size_t p = i % PAYLOAD_COUNT;
+        matched += parseGateCommand(PAYLOADS[p], lengths[p], command);
+        bench::doNotOptimize(command);
+    }
+    uint64_t parseElapsed = bench::nowNanos() - start;
+    unsigned long long parseAllocs = bench::allocationCount() - allocStart;
+
+    // Parse + post into the real command queue; a gate-less ControlTask
+    // drains it so the queue never fills
+    ControlTask controlTask(nullptr, nullptr, nullptr);
+    unsigned long rejected = 0;
+    allocStart = bench::allocationCount();
+    start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        size_t p = i % PAYLOAD_COUNT;
+        if (dispatchGateCommand(&controlTask, PAYLOADS[p], lengths[p], COMMAND_SOURCE_MQTT, 0,
+                                command) == COMMAND_QUEUE_FULL) {
+            rejected++;
+        }
+        if ((i & 3) == 3) {
+            controlTask.runOnce();
+        }
+    }
+    uint64_t dispatchElapsed = bench::nowNanos() - start;
+    unsigned long long dispatchAllocs = bench::allocationCount() - allocStart;
+
+    char rate[32];
+    printf("%lu iterations over %zu payloads\n", iterations, PAYLOAD_COUNT);
+    snprintf(rate, sizeof(rate), "%.1f M cmd/s", iterations / (stringElapsed / 1000.0));
+    bench::printResult("String copy + compare", stringElapsed, iterations, stringAllocs, rate);
+    snprintf(rate, sizeof(rate), "%.1f M cmd/s", iterations / (parseElapsed / 1000.0));
+    bench::printResult("parseGateCommand", parseElapsed, iterations, parseAllocs, rate);
+    snprintf(rate, sizeof(rate), "%.1f M cmd/s", iterations / (dispatchElapsed / 1000.0));
+    bench::printResult("dispatch + queue drain", dispatchElapsed, iterations, dispatchAllocs, rate);
+    printf("Speedup: %.1fx (%lu queue-full)\n", (double)stringElapsed / parseElapsed, rejected);
+    bench::doNotOptimize(matched);
+    return 0;
+}
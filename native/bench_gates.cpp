@@ -0,0 +1,123 @@
+/**
+ * bench_gates.cpp - Multi-gate update benchmark
+ *
+ * Measures one control-loop pass (update() plus msUntilNextEvent()) as the
+ * gate count grows: the one- and two-gate boards and a synthetic,
+ * host-only three-gate layout. The struct-of-arrays controller advances all
+ * gates in one pass; the baseline runs one single-gate controller per gate,
+ * which is what driving several gates looked like before. Both are timed with the gates idle (closed) and
+ * moving (closing with the relay held), on a frozen virtual clock so every
+ * pass does the same work.
+ *
+ * Usage: .pio/build/native/program bench-gates [--iterations <n>]
+ */
+
+#include "Arduino.h"
+#include "benchutil.h"
+#include "gate.h"
+#include "native_hal.h"
+
+namespace {
+
+// Sensor level for every gate of a policy (HIGH = closed)
+template <typename Policy>
+void setSensors(int level) {
+    for (uint8_t gate = 0; gate < Policy::GATE_COUNT; gate++) {
+        hal::setPinLevel(Policy::GATE_POSITION_SENSOR[gate], level);
+    }
+}
+
+// One struct-of-arrays controller driving every gate of the policy
+// (moving: the sensor reads open at boot and a close is in progress)
+template <typename Policy>
+uint64_t timeController(bool moving, unsigned long iterations) {
+    Scheduler scheduler;
+    setSensors<Policy>(moving ? LOW : HIGH);
+    bench::releaseFusionInputs<Policy>();
+    GateController<Policy> controller(scheduler);
+    controller.initialize();
+    for (uint8_t gate = 0; moving && gate < Policy::GATE_COUNT; gate++) {
+        controller.closeGate(gate);
+    }
+
+    uint32_t next = 0;
+    uint64_t start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        controller.update();
+        next += controller.msUntilNextEvent();
+    }
+    uint64_t elapsed = bench::nowNanos() - start;
+    bench::doNotOptimize(next);
+    return elapsed;
+}
+
+// One single-gate controller per gate, updated one after the other
+template <uint8_t N>
+uint64_t timeSeparateControllers(bool moving, unsigned long iterations) {
+    Scheduler scheduler;
+    setSensors<GateGuardianBoard>(moving ? LOW : HIGH);
+    bench::releaseFusionInputs<GateGuardianBoard>();
+    GateController<GateGuardianBoard>* controllers[N];
+    for (uint8_t i = 0; i < N; i++) {
+        controllers[i] = new GateController<GateGuardianBoard>(scheduler);
+        controllers[i]->initialize();
+        if (moving) {
+            controllers[i]->closeGate(0);
+        }
+    }
+
+    uint32_t next = 0;
+    uint64_t start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        uint32_t soonest = SCHEDULE_IDLE;
+        for (uint8_t c = 0; c < N; c++) {
+            controllers[c]->update();
+            uint32_t wait = controllers[c]->msUntilNextEvent();
+            if (wait < soonest) soonest = wait;
+        }
+        next += soonest;
+    }
+    uint64_t elapsed = bench::nowNanos() - start;
+    bench::doNotOptimize(next);
+
+    for (uint8_t i = 0; i < N; i++) {
+        delete controllers[i];
+    }
+    return elapsed;
+}
+
+void printRow(const char* layout, uint8_t gates, const char* state,
+              uint64_t elapsedNanos, unsigned long iterations) {
+    double perPass = (double)elapsedNanos / iterations;
+    printf("%-22s %5u  %-7s %10.1f %10.1f\n", layout, gates, state, perPass, perPass / gates);
+}
+
+template <typename Policy, uint8_t N>
+void runGateCount(unsigned long iterations) {
+    static_assert(Policy::GATE_COUNT == N, "Policy gate count mismatch");
+    for (int moving = 0; moving <= 1; moving++) {
+        const char* state = moving ? "moving" : "idle";
+        printRow("struct-of-arrays", N, state, timeController<Policy>(moving, iterations), iterations);
+        printRow("one controller/gate", N, state, timeSeparateControllers<N>(moving, iterations), iterations);
+    }
+}
+
+} // namespace
+
+int runGateBenchmark(int argc, char** argv) {
+    unsigned long iterations = 2000000;
+    if (!bench::parseIterations(argc, argv, iterations)) {
+        return 2;
+    }
+
+    // Frozen clock: relay pulses and travel timeouts never expire mid-run
+    hal::useVirtualClock(1000000);
+    hal::setSerialEcho(false);
+
+    printf("%lu passes of update() + msUntilNextEvent()\n", iterations);
+    printf("%-22s %5s  %-7s %10s %10s\n", "Layout", "Gates", "State", "ns/pass", "ns/gate");
+    runGateCount<GateGuardianBoard, 1>(iterations);
+    runGateCount<GateGuardianDualBoard, 2>(iterations);
+    runGateCount<HostSyntheticTripleGateBoard, 3>(iterations);
+    return 0;
+}
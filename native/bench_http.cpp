@@ -0,0 +1,386 @@
+/**
+ * bench_http.cpp - HTTP server load test
+ *
+ * Drives the unmodified HttpServer with simulated clients connected through
+ * the HAL's in-process network. Each client sends a request, waits for the
+ * complete response (Content-Length or chunked), records the latency and
+ * sends the next one, on a persistent connection unless --close is given.
+ * Stalled clients model the cases that used to hold up the synchronous
+ * WebServer: half of them send half a request line and then nothing, the
+ * other half request /metrics and never read the response.
+ *
+ * Event stream subscribers connect to /events while a transition event is
+ * published every millisecond; slow subscribers never read and should be
+ * dropped once the shared ring laps them, without delaying anyone else.
+ *
+ * Reports requests per second, request latency percentiles and how long a
+ * single update() call took, which is the time the network task is busy
+ * with HTTP per loop iteration.
+ *
+ * Usage: .pio/build/native/program bench-http [--clients <n>] [--stalled <n>]
+ *                                             [--duration <ms>] [--close]
+ *                                             [--subscribers <n>] [--slow-subscribers <n>]
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "native_hal.h"
+#include "benchutil.h"
+
+#include "commandparser.h"
+#include "controltask.h"
+#include "eventstream.h"
+#include "httpserver.h"
+#include "metrics.h"
+
+namespace {
+
+const uint16_t HTTP_PORT = 80;
+
+// Requests cycled through by every client
+const char* const PATHS[] = {"/", "/gate/toggle", "/metrics", "/gate/bogus"};
+const size_t PATH_COUNT = sizeof(PATHS) / sizeof(PATHS[0]);
+
+struct LoadOptions {
+    unsigned clients = 8;
+    unsigned stalled = 2;
+    unsigned long durationMs = 2000;
+    bool keepAlive = true;
+    unsigned subscribers = 0;
+    unsigned slowSubscribers = 0;
+};
+
+bool parseLoadOptions(int argc, char** argv, LoadOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--clients") == 0 && hasValue) {
+            options.clients = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--stalled") == 0 && hasValue) {
+            options.stalled = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--duration") == 0 && hasValue) {
+            options.durationMs = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--subscribers") == 0 && hasValue) {
+            options.subscribers = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--slow-subscribers") == 0 && hasValue) {
+            options.slowSubscribers = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--close") == 0) {
+            options.keepAlive = false;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    if (options.clients == 0 || options.durationMs == 0) {
+        fprintf(stderr, "--clients and --duration must be greater than zero\n");
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// SIMULATED CLIENT
+// ============================================================================
+class LoadClient : public hal::NetworkPeer {
+public:
+    enum Behavior { ACTIVE, SLOW_HEADER, NO_READ, SUBSCRIBER, SLOW_SUBSCRIBER };
+
+    LoadClient(Behavior behavior, bool keepAlive, size_t firstPath)
+        : _behavior(behavior), _keepAlive(keepAlive), _nextPath(firstPath) {}
+
+    void start() {
+        _connect();
+    }
+
+    // Server -> client: response bytes
+    void receive(const uint8_t* data, size_t length, std::vector<uint8_t>& reply) override {
+        if (_behavior == SUBSCRIBER) {
+            // Every event ends with a blank line; the header block ends in "\r\n\r\n"
+            for (size_t i = 0; i < length; i++) {
+                if (data[i] == '\n' && _lastByte == '\n') {
+                    _events++;
+                }
+                _lastByte = data[i];
+            }
+            return;
+        }
+        _response.insert(_response.end(), data, data + length);
+        while (_responseComplete()) {
+            _finishRequest();
+        }
+    }
+
+    // Client -> server: pending request bytes
+    void pump(std::vector<uint8_t>& reply) override {
+        reply.insert(reply.end(), _outbound.begin(), _outbound.end());
+        _outbound.clear();
+    }
+
+    void close() override {
+        // Server closed the connection: reconnect for the next request
+        _connected = false;
+        if (_behavior == ACTIVE) {
+            if (_awaiting) {
+                _failed++;
+                _awaiting = false;
+            }
+            _connect();
+        }
+    }
+
+    size_t writable() override { return _behavior == NO_READ || _behavior == SLOW_SUBSCRIBER ? 0 : SIZE_MAX; }
+    bool open() override { return _connected; }
+
+    const std::vector<uint64_t>& latencies() const { return _latencies; }
+    unsigned long failed() const { return _failed; }
+    unsigned long connects() const { return _connects; }
+    unsigned long events() const { return _events; }
+    bool connected() const { return _connected; }
+
+private:
+    Behavior _behavior;
+    bool _keepAlive;
+    size_t _nextPath;
+    bool _connected = false;
+    bool _awaiting = false;
+    uint64_t _requestStart = 0;
+    std::vector<uint8_t> _outbound;
+    std::vector<uint8_t> _response;
+    std::vector<uint64_t> _latencies;
+    unsigned long _failed = 0;
+    unsigned long _connects = 0;
+    size_t _bodyEnd = 0;
+    bool _serverCloses = false;     // Response carried "Connection: close"
+    unsigned long _events = 0;      // Events received by a subscriber
+    uint8_t _lastByte = 0;
+
+    void _connect() {
+        _connected = true;
+        _connects++;
+        _response.clear();
+        hal::connectToServer(HTTP_PORT, this);
+        _sendRequest();
+    }
+
+    void _sendRequest() {
+        char request[160];
+        int length;
+        if (_behavior == SLOW_HEADER) {
+            length = snprintf(request, sizeof(request), "GET /met");
+        } else if (_behavior == SUBSCRIBER || _behavior == SLOW_SUBSCRIBER) {
+            length = snprintf(request, sizeof(request), "GET /events HTTP/1.1\r\nHost: gate\r\n"
+                              "Accept: text/event-stream\r\n\r\n");
+        } else {
+            const char* path = _behavior == NO_READ ? "/metrics" : PATHS[_nextPath++ % PATH_COUNT];
+            length = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: gate\r\n%s\r\n",
+                              path, _keepAlive ? "" : "Connection: close\r\n");
+        }
+        _outbound.insert(_outbound.end(), request, request + length);
+        _requestStart = bench::nowNanos();
+        _awaiting = true;
+    }
+
+    // Complete response at the front of _response? Sets _bodyEnd.
+    bool _responseComplete() {
+        std::string text(_response.begin(), _response.end());
+        size_t headerEnd = text.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) {
+            return false;
+        }
+        size_t body = headerEnd + 4;
+        size_t closeHeader = text.find("Connection: close");
+        _serverCloses = closeHeader != std::string::npos && closeHeader < headerEnd;
+        size_t lengthHeader = text.find("Content-Length: ");
+        if (lengthHeader != std::string::npos && lengthHeader < headerEnd) {
+            size_t length = strtoul(text.c_str() + lengthHeader + 16, nullptr, 10);
+            _bodyEnd = body + length;
+            return text.size() >= _bodyEnd;
+        }
+
+        // Chunked: walk the chunk sizes up to the last (empty) chunk
+        size_t pos = body;
+        while (true) {
+            size_t lineEnd = text.find("\r\n", pos);
+            if (lineEnd == std::string::npos) {
+                return false;
+            }
+            size_t size = strtoul(text.c_str() + pos, nullptr, 16);
+            pos = lineEnd + 2 + size + 2;
+            if (pos > text.size()) {
+                return false;
+            }
+            if (size == 0) {
+                _bodyEnd = pos;
+                return true;
+            }
+        }
+    }
+
+    void _finishRequest() {
+        _response.erase(_response.begin(), _response.begin() + _bodyEnd);
+        if (!_awaiting) {
+            return;
+        }
+        _awaiting = false;
+        _latencies.push_back(bench::nowNanos() - _requestStart);
+        if (_serverCloses) {
+            // The server closes after this response; close() reconnects
+        } else if (_keepAlive) {
+            _sendRequest();
+        } else {
+            // Close our end; the server drops the slot and close() reconnects
+            _connected = false;
+        }
+    }
+};
+
+// ============================================================================
+// ROUTES (as registered by the sketch)
+// ============================================================================
+ControlTask* loadControlTask = nullptr;
+Metrics loadMetrics;
+EventStream loadEvents;
+
+void handleRoot(HttpRequest& request, void*) {
+    request.send(200, "text/plain", "Hi! This is GateGuardian");
+}
+
+void handleGate(HttpRequest& request, void*) {
+    const char* name = strrchr(request.path(), '/') + 1;
+    GateCommand command;
+    switch (dispatchGateCommand(loadControlTask, name, strlen(name), COMMAND_SOURCE_HTTP, 0, command)) {
+        case COMMAND_QUEUED:
+            request.send(200, "text/plain", "Gate toggling...");
+            break;
+        case COMMAND_QUEUE_FULL:
+            request.send(503, "text/plain", "Command queue full");
+            break;
+        default:
+            request.send(404, "text/plain", "Unknown gate command");
+            break;
+    }
+}
+
+bool streamMetrics(HttpBody& body, uint32_t& section, uint32_t, void*) {
+    return loadMetrics.writePrometheus(section, HttpBody::sink, &body);
+}
+
+void handleMetrics(HttpRequest& request, void*) {
+    request.stream(200, "text/plain; version=0.0.4", streamMetrics, nullptr);
+}
+
+void handleEvents(HttpRequest& request, void*) {
+    char initial[64];
+    size_t length = EventStream::format(initial, sizeof(initial), "state", "{\"gate\":0,\"state\":\"CLOSED\"}", 0);
+    request.subscribe(loadEvents, initial, length);
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    return sorted[(size_t)(fraction * (sorted.size() - 1))];
+}
+
+} // namespace
+
+int runHttpLoadTest(int argc, char** argv) {
+    LoadOptions options;
+    if (!parseLoadOptions(argc, argv, options)) {
+        return 2;
+    }
+    hal::setSerialEcho(false);
+
+    ControlTask controlTask(nullptr, nullptr, nullptr);
+    loadControlTask = &controlTask;
+    loadMetrics.begin();
+
+    HttpServer server(HTTP_PORT);
+    server.on("/", handleRoot);
+    server.on("/gate/toggle", handleGate);
+    server.on("/gate/bogus", handleGate);
+    server.on("/metrics", HTTP_METHOD_GET, handleMetrics);
+    server.on("/events", HTTP_METHOD_GET, handleEvents);
+    server.begin();
+
+    // Subscribers and stalled clients connect first so they hold slots from the start
+    std::vector<LoadClient*> clients;
+    for (unsigned i = 0; i < options.subscribers + options.slowSubscribers; i++) {
+        clients.push_back(new LoadClient(i < options.subscribers ? LoadClient::SUBSCRIBER
+                                                                 : LoadClient::SLOW_SUBSCRIBER, true, 0));
+    }
+    unsigned firstActive = options.subscribers + options.slowSubscribers + options.stalled;
+    for (unsigned i = 0; i < options.stalled; i++) {
+        clients.push_back(new LoadClient(i % 2 ? LoadClient::NO_READ : LoadClient::SLOW_HEADER, true, 0));
+    }
+    for (unsigned i = 0; i < options.clients; i++) {
+        clients.push_back(new LoadClient(LoadClient::ACTIVE, options.keepAlive, i));
+    }
+    for (LoadClient* client : clients) {
+        client->start();
+    }
+
+    std::vector<uint64_t> updateTimes;
+    uint64_t start = bench::nowNanos();
+    uint64_t end = start + options.durationMs * 1000000ULL;
+    uint64_t now = start;
+    uint64_t nextPublish = start;
+    unsigned long published = 0;
+    uint64_t publishNanos = 0;
+    while (now < end) {
+        if (options.subscribers + options.slowSubscribers > 0 && now >= nextPublish) {
+            // One serialization per event, however many subscribers
+            char json[96];
+            snprintf(json, sizeof(json), "{\"gate\":0,\"from\":\"OPEN\",\"to\":\"CLOSING\",\"source\":\"mqtt\",\"uptime_ms\":%lu}",
+                     (unsigned long)(published * 1000));
+            uint64_t before = bench::nowNanos();
+            loadEvents.publish("transition", json);
+            publishNanos += bench::nowNanos() - before;
+            published++;
+            nextPublish += 1000000;
+        }
+        server.update();
+        uint64_t after = bench::nowNanos();
+        updateTimes.push_back(after - now);
+        now = after;
+        controlTask.runOnce();
+    }
+    double seconds = (now - start) / 1e9;
+
+    std::vector<uint64_t> latencies;
+    unsigned long failed = 0;
+    unsigned long connects = 0;
+    for (unsigned i = firstActive; i < clients.size(); i++) {
+        latencies.insert(latencies.end(), clients[i]->latencies().begin(), clients[i]->latencies().end());
+        failed += clients[i]->failed();
+        connects += clients[i]->connects();
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::sort(updateTimes.begin(), updateTimes.end());
+
+    printf("HTTP load: %u clients (%s), %u stalled, %lu ms, %u connection slots\n",
+           options.clients, options.keepAlive ? "keep-alive" : "close", options.stalled,
+           options.durationMs, HttpServer::MAX_CONNECTIONS);
+    printf("Requests:            %zu (%.0f/s), %lu failed\n", latencies.size(), latencies.size() / seconds, failed);
+    printf("Connections:         %lu opened by active clients, %lu accepted, %lu timed out\n",
+           connects, (unsigned long)server.connectionsAccepted(), (unsigned long)server.connectionsTimedOut());
+    printf("Latency (us):        p50 %.1f  p99 %.1f  max %.1f\n", percentile(latencies, 0.50) / 1e3,
+           percentile(latencies, 0.99) / 1e3, percentile(latencies, 1.0) / 1e3);
+    printf("update() (us):       p50 %.1f  p99 %.1f  max %.1f (%zu calls)\n", percentile(updateTimes, 0.50) / 1e3,
+           percentile(updateTimes, 0.99) / 1e3, percentile(updateTimes, 1.0) / 1e3, updateTimes.size());
+    if (published > 0) {
+        printf("Events:              %lu published, %.2f us per publish\n", published, publishNanos / 1e3 / published);
+        for (unsigned i = 0; i < options.subscribers; i++) {
+            // The initial state event arrives on top of the published ones
+            printf("  subscriber %u:      %lu events received%s\n", i, clients[i]->events(),
+                   clients[i]->connected() ? "" : " (disconnected)");
+        }
+        printf("  slow subscribers:  %lu of %u dropped\n", (unsigned long)server.subscribersDropped(),
+               options.slowSubscribers);
+    }
+
+    for (LoadClient* client : clients) {
+        delete client;
+    }
+    return 0;
+}
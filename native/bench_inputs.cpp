@@ -0,0 +1,133 @@
+/**
+ * bench_inputs.cpp - Discrete input scanner benchmark
+ *
+ * Times one sample of the four discrete inputs with the bit-parallel
+ * InputScanner against the per-pin approach the commented-out Debounce16
+ * instances would have taken (one digitalRead and one 16-bit history
+ * register per pin). Both read the same simulated pins, which bounce for a
+ * few samples around every change, and report how many debounced changes
+ * they accepted against the number of clean changes fed in.
+ *
+ * On the host the scanner assembles its register word with digitalRead, so
+ * the difference shown is the debounce work only; on the ESP32 the four
+ * reads also collapse into two register reads.
+ *
+ * Usage: .pio/build/native/program bench-inputs [--iterations <n>]
+ */
+
+#include "Arduino.h"
+#include "benchutil.h"
+#include "boardpolicy.h"
+#include "inputscanner.h"
+#include "native_hal.h"
+
+namespace {
+
+typedef GateGuardianBoard Board;
+
+const uint8_t PINS[] = {
+    Board::PIN_GATE_LIGHTS, Board::PIN_GATE_LOCK, Board::PIN_EXTERNAL_RELAY, Board::PIN_PHOTO_EYE
+};
+const size_t PIN_COUNT = sizeof(PINS);
+
+// Every pin settles on a new level every PERIOD samples, after bouncing
+// during the first BOUNCE samples of the period
+const unsigned long PERIOD = 64;
+const unsigned long BOUNCE = 3;
+
+// Pin levels for one sample of the input pattern (pins are staggered)
+void driveInputs(unsigned long sample) {
+    for (size_t i = 0; i < PIN_COUNT; i++) {
+        unsigned long t = sample + i * (PERIOD / PIN_COUNT);
+        bool level = (t / PERIOD) & 1;
+        if (t % PERIOD < BOUNCE) {
+            level = (t & 1) ? level : !level;
+        }
+        hal::setPinLevel(PINS[i], level);
+    }
+}
+
+// Debounce16-style filter: a level is accepted once the last 16 reads agree
+struct ShiftDebounce {
+    uint16_t history;
+    bool state;
+
+    bool update(bool level) {
+        history = (history << 1) | level;
+        bool stable = history == 0xFFFF || history == 0x0000;
+        if (stable && level != state) {
+            state = level;
+            return true;
+        }
+        return false;
+    }
+};
+
+unsigned long cleanChanges(unsigned long iterations) {
+    // Each pin changes once per period after its first
+    unsigned long changes = 0;
+    for (size_t i = 0; i < PIN_COUNT; i++) {
+        unsigned long offset = i * (PERIOD / PIN_COUNT);
+        changes += (iterations + offset) / PERIOD - offset / PERIOD;
+    }
+    return changes;
+}
+
+} // namespace
+
+int runInputBenchmark(int argc, char** argv) {
+    unsigned long iterations = 2000000;
+    if (!bench::parseIterations(argc, argv, iterations)) {
+        return 2;
+    }
+    hal::setSerialEcho(false);
+
+    printf("%lu samples of %zu inputs, %lu clean changes fed in (time per sample, pin driving subtracted)\n",
+           iterations, PIN_COUNT, cleanChanges(iterations));
+
+    // Cost of driving the simulated pins alone
+    uint64_t start = bench::nowNanos();
+    for (unsigned long i = 1; i <= iterations; i++) {
+        driveInputs(i);
+    }
+    uint64_t baseline = bench::nowNanos() - start;
+
+    // Bit-parallel vertical counter over the register word
+    {
+        driveInputs(0);
+        InputScanner scanner;
+        scanner.begin(PINS, PIN_COUNT);
+        start = bench::nowNanos();
+        for (unsigned long i = 1; i <= iterations; i++) {
+            driveInputs(i);
+            bench::doNotOptimize(scanner.sample());
+        }
+        uint64_t elapsed = bench::nowNanos() - start;
+        char extra[32];
+        snprintf(extra, sizeof(extra), "%lu changes", (unsigned long)scanner.changes());
+        bench::printResult("bit-parallel", elapsed > baseline ? elapsed - baseline : 0, iterations, 0, extra);
+    }
+
+    // One digitalRead and shift register per pin
+    {
+        driveInputs(0);
+        ShiftDebounce filters[PIN_COUNT];
+        for (size_t p = 0; p < PIN_COUNT; p++) {
+            filters[p].state = digitalRead(PINS[p]);
+            filters[p].history = filters[p].state ? 0xFFFF : 0x0000;
+        }
+        unsigned long changes = 0;
+        start = bench::nowNanos();
+        for (unsigned long i = 1; i <= iterations; i++) {
+            driveInputs(i);
+            for (size_t p = 0; p < PIN_COUNT; p++) {
+                changes += filters[p].update(digitalRead(PINS[p]));
+            }
+        }
+        uint64_t elapsed = bench::nowNanos() - start;
+        char extra[32];
+        snprintf(extra, sizeof(extra), "%lu changes", changes);
+        bench::printResult("per-pin shift register", elapsed > baseline ? elapsed - baseline : 0, iterations, 0, extra);
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * bench_log.cpp - Logging cost benchmark
+ *
+ * Compares the Serial.print sequence a gate state change used to emit
+ * (state change, relay, LED status and status publish lines) with the same
+ * four lines queued through the asynchronous logger, and measures what the
+ * log task then spends formatting them.
+ *
+ * The host Serial never blocks, so the UART stall is modeled: the ESP32's
+ * Serial has a 128-byte TX FIFO and no software buffer by default, so every
+ * byte of a burst beyond the FIFO holds up the printing task for one
+ * character time at 115200 baud. With the logger that wait moves to the
+ * log task.
+ *
+ * Usage: .pio/build/native/program bench-log [--iterations <n>]
+ */
+
+#include "Arduino.h"
+#include "benchutil.h"
+#include "gate.h"
+#include "logger.h"
+
+namespace {
+
+const uint32_t UART_BAUD = 115200;
+const size_t UART_FIFO_BYTES = 128;
+const double UART_BYTE_US = 10 * 1e6 / UART_BAUD;     // 8N1: ten bits per character
+
+// Bursts queued between two drains; fits the ring with room to spare
+const unsigned long BURSTS_PER_DRAIN = 8;
+
+// Previous _logStateChange, _activateRelay, LEDManager::setStatus and
+// _logPublishEvent output for one transition
+void serialBurst(uint8_t gate, GateState oldState, GateState newState) {
+    Serial.print("[STATE] Gate ");
+    Serial.print(gate);
+    Serial.print(" state changed: ");
+    Serial.print(gateStateName(oldState));
+    Serial.print(" -> ");
+    Serial.println(gateStateName(newState));
+
+    Serial.print("[RELAY] Gate ");
+    Serial.print(gate);
+    Serial.print(" ");
+    Serial.print("Open");
+    Serial.println(" relay activated");
+
+    Serial.print("[LED] Setting LED status for gate state: ");
+    Serial.println("OPENING (blinking green)");
+
+    Serial.print("[MQTT] Status published: ");
+    Serial.print(254);
+    Serial.println(" bytes JSON");
+}
+
+// The same lines through the logger, with the firmware's format strings
+void loggerBurst(uint8_t gate, GateState oldState, GateState newState) {
+    logger.write(LOG_LEVEL_INFO, "[STATE] Gate %u state changed: %s -> %s", gate,
+                 gateStateName(oldState), gateStateName(newState));
+    logger.write(LOG_LEVEL_INFO, "[RELAY] Gate %u %s relay activated", gate, "Open");
+    logger.write(LOG_LEVEL_INFO, "[LED] Setting LED status for gate state: OPENING (blinking green)");
+    logger.write(LOG_LEVEL_INFO, "[MQTT] Status published: %s, %u bytes %s",
+                 gateStateName(newState), 254, "JSON");
+}
+
+// Log task sink: count the formatted bytes instead of writing them
+void countBytes(const char* line, size_t length, void* context) {
+    *static_cast<unsigned long long*>(context) += length;
+}
+
+double uartStallUs(double bytes) {
+    return bytes > UART_FIFO_BYTES ? (bytes - UART_FIFO_BYTES) * UART_BYTE_US : 0;
+}
+
+} // namespace
+
+int runLogBenchmark(int argc, char** argv) {
+    unsigned long iterations = 1000000;
+    if (!bench::parseIterations(argc, argv, iterations)) {
+        return 2;
+    }
+    hal::setSerialEcho(false);
+
+    // Serial.print: the caller formats and writes every byte
+    unsigned long long serialStart = hal::serialBytesWritten();
+    unsigned long long allocStart = bench::allocationCount();
+    uint64_t start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        serialBurst(i & 1, GATE_CLOSED, GATE_OPENING);
+    }
+    uint64_t serialElapsed = bench::nowNanos() - start;
+    unsigned long long serialAllocs = bench::allocationCount() - allocStart;
+    double serialBytes = (double)(hal::serialBytesWritten() - serialStart) / iterations;
+
+    // Logger: the caller queues records; the drain stands in for the log
+    // task and is timed separately
+    unsigned long long loggedBytes = 0;
+    logger.addSink(countBytes, &loggedBytes);
+    uint32_t droppedStart = logger.dropped();
+    uint64_t queueElapsed = 0, drainElapsed = 0;
+    allocStart = bench::allocationCount();
+    for (unsigned long i = 0; i < iterations; i += BURSTS_PER_DRAIN) {
+        unsigned long batch = iterations - i < BURSTS_PER_DRAIN ? iterations - i : BURSTS_PER_DRAIN;
+        start = bench::nowNanos();
+        for (unsigned long b = 0; b < batch; b++) {
+            loggerBurst((i + b) & 1, GATE_CLOSED, GATE_OPENING);
+        }
+        uint64_t queued = bench::nowNanos();
+        logger.drain();
+        drainElapsed += bench::nowNanos() - queued;
+        queueElapsed += queued - start;
+    }
+    unsigned long long loggerAllocs = bench::allocationCount() - allocStart;
+    double loggerBytes = (double)loggedBytes / iterations;
+
+    char extra[64];
+    printf("%lu state change bursts of 4 lines\n", iterations);
+    snprintf(extra, sizeof(extra), "%.0f bytes/burst", serialBytes);
+    bench::printResult("Serial.print burst", serialElapsed, iterations, serialAllocs, extra);
+    snprintf(extra, sizeof(extra), "%u dropped", logger.dropped() - droppedStart);
+    bench::printResult("LOG_* burst (queue)", queueElapsed, iterations, loggerAllocs, extra);
+    snprintf(extra, sizeof(extra), "%.0f bytes/burst", loggerBytes);
+    bench::printResult("log task drain (format)", drainElapsed, iterations, 0, extra);
+    printf("Modeled UART stall of the logging task per burst (%u baud, %zu-byte FIFO):\n",
+           UART_BAUD, UART_FIFO_BYTES);
+    printf("  Serial.print: %8.0f us   logger: %8.0f us in the caller, %.0f us in the log task\n",
+           uartStallUs(serialBytes), 0.0, uartStallUs(loggerBytes));
+    printf("Caller time per burst including the stall: Serial.print %.0f us, logger %.2f us\n",
+           serialElapsed / 1000.0 / iterations + uartStallUs(serialBytes),
+           queueElapsed / 1000.0 / iterations);
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * bench_status.cpp - Status message serialization benchmark
+ *
+ * Compares the allocation-free serializeStatusJson() with the String
+ * concatenation that MQTTManager::_formatStatusMessage used before, both
+ * producing the same document, and the CBOR encoding with JSON in encode
+ * time and payload size. CBOR output is checked by decoding it back.
+ *
+ * Usage: .pio/build/native/program bench-status [--iterations <n>]
+ */
+
+#include "Arduino.h"
+#include "benchutil.h"
+#include "statusdecoder.h"
+#include "statusserializer.h"
+
+namespace {
+
+// Previous MQTTManager::_formatStatusMessage approach, extended to the same fields
+String formatStatusWithString(const GateStatus& status) {
+    String message = "{";
+    message += "\"device_id\":\"" + String(status.deviceId) + "\",";
+    message += "\"timestamp\":" + String(status.timestamp) + ",";
+    message += "\"state\":\"" + String(gateStateName(status.state)) + "\",";
+    message += "\"sensor_raw\":" + String(status.sensorRaw ? "true" : "false") + ",";
+    message += "\"inputs\":{";
+    message += "\"gate_lights\":" + String(status.gateLights ? "true" : "false") + ",";
+    message += "\"gate_lock\":" + String(status.gateLock ? "true" : "false") + ",";
+    message += "\"external_relay\":" + String(status.externalRelay ? "true" : "false") + ",";
+    message += "\"photo_eye\":" + String(status.photoEye ? "true" : "false") + "},";
+    message += "\"temperature\":" + String(status.temperature, 2) + ",";
+    message += "\"humidity\":" + String(status.humidity, 1) + ",";
+    message += "\"uptime\":" + String(status.uptime) + ",";
+    message += "\"traffic\":{";
+    message += "\"passes\":" + String(status.passes) + ",";
+    message += "\"last_pass_ms\":" + String(status.lastPassMs) + "}";
+    message += "}";
+    return message;
+}
+
+GateStatus sampleStatus(uint32_t i) {
+    GateStatus status;
+    status.deviceId = "esp32_gate_A1B2C3";
+    status.timestamp = 86400 + i;
+    status.state = (GateState)(i % 5);
+    status.sensorRaw = i & 1;
+    status.gateLights = i & 2;
+    status.gateLock = i & 4;
+    status.externalRelay = i & 8;
+    status.photoEye = i & 16;
+    status.climateValid = true;
+    status.temperature = 21.25f + (i % 8) * 0.5f;
+    status.humidity = 48.5f + (i % 4);
+    status.uptime = 86400 + i;
+    status.passes = 1200 + i;
+    status.lastPassMs = 850 + (i % 16) * 100;
+    return status;
+}
+
+// Fields the CBOR encoding must carry through unchanged (climate at its resolution)
+bool sameStatus(const GateStatus& a, const GateStatus& b) {
+    return strcmp(a.deviceId, b.deviceId) == 0 && a.timestamp == b.timestamp &&
+           a.state == b.state && a.sensorRaw == b.sensorRaw && a.gateLights == b.gateLights &&
+           a.gateLock == b.gateLock && a.externalRelay == b.externalRelay &&
+           a.photoEye == b.photoEye && a.climateValid == b.climateValid &&
+           (!a.climateValid || (fabsf(a.temperature - b.temperature) < 0.006f &&
+                                fabsf(a.humidity - b.humidity) < 0.06f)) &&
+           a.uptime == b.uptime && a.passes == b.passes && a.lastPassMs == b.lastPassMs;
+}
+
+} // namespace
+
+int runStatusBenchmark(int argc, char** argv) {
+    unsigned long iterations = 1000000;
+    if (!bench::parseIterations(argc, argv, iterations)) {
+        return 2;
+    }
+
+    // Both paths must produce the same document
+    char buffer[STATUS_JSON_MAX_SIZE];
+    GateStatus check = sampleStatus(7);
+    size_t length = serializeStatusJson(check, buffer, sizeof(buffer));
+    String legacy = formatStatusWithString(check);
+    if (length == 0 || legacy != buffer) {
+        fprintf(stderr, "Serializer output mismatch:\n  %s\n  %s\n", buffer, legacy.c_str());
+        return 1;
+    }
+    printf("Document (%zu bytes): %s\n\n", length, buffer);
+
+    size_t totalLength = 0;
+    unsigned long long allocStart = bench::allocationCount();
+    uint64_t start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        String message = formatStatusWithString(sampleStatus(i));
+        totalLength += message.length();
+        bench::doNotOptimize(message);
+    }
+    uint64_t stringElapsed = bench::nowNanos() - start;
+    unsigned long long stringAllocs = bench::allocationCount() - allocStart;
+
+    allocStart = bench::allocationCount();
+    start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        totalLength += serializeStatusJson(sampleStatus(i), buffer, sizeof(buffer));
+        bench::doNotOptimize(buffer);
+    }
+    uint64_t bufferElapsed = bench::nowNanos() - start;
+    unsigned long long bufferAllocs = bench::allocationCount() - allocStart;
+
+    printf("%lu iterations\n", iterations);
+    bench::printResult("String concatenation", stringElapsed, iterations, stringAllocs, "");
+    bench::printResult("serializeStatusJson", bufferElapsed, iterations, bufferAllocs, "");
+    printf("Speedup: %.1fx\n", (double)stringElapsed / bufferElapsed);
+
+    // CBOR must decode back to the snapshot it was built from
+    uint8_t cbor[STATUS_CBOR_MAX_SIZE];
+    char deviceId[32];
+    for (uint32_t i = 0; i < 64; i++) {
+        GateStatus original = sampleStatus(i);
+        original.climateValid = i % 3 != 0;
+        GateStatus decoded;
+        size_t cborLength = serializeStatusCbor(original, cbor, sizeof(cbor));
+        if (cborLength == 0 || !decodeStatusCbor(cbor, cborLength, decoded, deviceId, sizeof(deviceId)) ||
+            !sameStatus(original, decoded)) {
+            fprintf(stderr, "CBOR round trip failed for sample %u\n", i);
+            return 1;
+        }
+    }
+
+    size_t jsonBytes = 0;
+    allocStart = bench::allocationCount();
+    start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        jsonBytes += serializeStatusJson(sampleStatus(i), buffer, sizeof(buffer));
+        bench::doNotOptimize(buffer);
+    }
+    uint64_t jsonElapsed = bench::nowNanos() - start;
+    unsigned long long jsonAllocs = bench::allocationCount() - allocStart;
+
+    size_t cborBytes = 0;
+    allocStart = bench::allocationCount();
+    start = bench::nowNanos();
+    for (unsigned long i = 0; i < iterations; i++) {
+        cborBytes += serializeStatusCbor(sampleStatus(i), cbor, sizeof(cbor));
+        bench::doNotOptimize(cbor);
+    }
+    uint64_t cborElapsed = bench::nowNanos() - start;
+    unsigned long long cborAllocs = bench::allocationCount() - allocStart;
+
+    char jsonSize[32], cborSize[32];
+    snprintf(jsonSize, sizeof(jsonSize), "%.1f B/msg", (double)jsonBytes / iterations);
+    snprintf(cborSize, sizeof(cborSize), "%.1f B/msg", (double)cborBytes / iterations);
+    printf("\nPayload format\n");
+    bench::printResult("JSON", jsonElapsed, iterations, jsonAllocs, jsonSize);
+    bench::printResult("CBOR", cborElapsed, iterations, cborAllocs, cborSize);
+    printf("Size ratio: %.1fx, encode speedup: %.1fx\n", (double)jsonBytes / cborBytes,
+           (double)jsonElapsed / cborElapsed);
+
+    bench::doNotOptimize(totalLength);
+    return 0;
+}
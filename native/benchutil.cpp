@@ -0,0 +1,83 @@
+/**
+ * benchutil.cpp - Native benchmark helpers
+ *
+ * Implementation of timing and allocation counting.
+ */
+
+#include "benchutil.h"
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+std::atomic<unsigned long long> allocations(0);
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+namespace bench {
+
+uint64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+unsigned long long allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+bool parseIterations(int argc, char** argv, unsigned long& iterations) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    if (iterations == 0) {
+        fprintf(stderr, "--iterations must be greater than zero\n");
+        return false;
+    }
+    return true;
+}
+
+void printResult(const char* name, uint64_t elapsedNanos, unsigned long iterations,
+                 unsigned long long allocations, const char* extra) {
+    printf("%-28s %10.1f ns/op  %8.2f allocs/op  %s\n", name,
+           (double)elapsedNanos / iterations, (double)allocations / iterations,
+           extra ? extra : "");
+}
+
+} // namespace bench
@@ -0,0 +1,78 @@
+/**
+ * benchutil.h - Native benchmark helpers
+ *
+ * Timing, heap-allocation counting and option parsing shared by the native
+ * benchmarks. Allocation counting works by replacing the global operator
+ * new, so it covers String and any other C++ allocation in the process.
+ */
+
+#ifndef benchutil_h
+#define benchutil_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "boardpolicy.h"
+#include "native_hal.h"
+
+namespace bench {
+
+/**
+ * Monotonic time in nanoseconds
+ */
+uint64_t nowNanos();
+
+/**
+ * Number of operator new calls since process start
+ */
+unsigned long long allocationCount();
+
+/**
+ * Keep the compiler from optimizing away a computed value
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Parse "--iterations <n>" style options; unknown options are rejected
+ * @return false (after printing a message) if parsing failed
+ */
+bool parseIterations(int argc, char** argv, unsigned long& iterations);
+
+/**
+ * Print one result row: name, ns/op, allocations/op and an extra column
+ */
+void printResult(const char* name, uint64_t elapsedNanos, unsigned long iterations,
+                 unsigned long long allocations, const char* extra);
+
+/**
+ * Drive every gate's warning light and lock input to its inactive level,
+ * as the board's pull-ups do (host pins start LOW, which reads as active)
+ */
+template <typename Policy>
+void releaseFusionInputs() {
+    for (uint8_t gate = 0; gate < Policy::GATE_COUNT; gate++) {
+        if (Policy::GATE_MOTION_INPUT[gate] != NO_PIN) {
+            hal::setPinLevel(Policy::GATE_MOTION_INPUT[gate], !Policy::FUSION_INPUT_ACTIVE_LEVEL);
+        }
+        if (Policy::GATE_LOCK_INPUT[gate] != NO_PIN) {
+            hal::setPinLevel(Policy::GATE_LOCK_INPUT[gate], !Policy::FUSION_INPUT_ACTIVE_LEVEL);
+        }
+    }
+}
+
+} // namespace bench
+
+// Benchmark entry points (argv[0] is the subcommand name)
+int runStatusBenchmark(int argc, char** argv);
+int runCommandBenchmark(int argc, char** argv);
+int runGateBenchmark(int argc, char** argv);
+int runHttpLoadTest(int argc, char** argv);
+int runInputBenchmark(int argc, char** argv);
+int runLogBenchmark(int argc, char** argv);
+int runClimateBenchmark(int argc, char** argv);
+int runReplay(int argc, char** argv);
+
+#endif // benchutil_h
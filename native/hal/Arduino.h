@@ -0,0 +1,103 @@
+/**
+ * Arduino.h - Native (Linux) HAL shim
+ *
+ * Minimal stand-in for the Arduino-ESP32 core so the gate controller classes
+ * compile and run as a host process. Only the API surface the firmware uses
+ * is provided; pin levels and the clock are backed by the simulation in
+ * native_hal.h.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================================
+// TYPES AND CONSTANTS
+// ============================================================================
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define PULLUP          0x04
+#define INPUT_PULLUP    0x05
+#define PULLDOWN        0x08
+#define INPUT_PULLDOWN  0x09
+
+#define RISING    0x01
+#define FALLING   0x02
+#define CHANGE    0x03
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define IRAM_ATTR
+
+// ============================================================================
+// TIMING
+// ============================================================================
+// 32 bits wide like unsigned long on the ESP32, so wrap-around arithmetic
+// (millis() every 49.7 days, micros() every 71.6 minutes) matches the device
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// ============================================================================
+// GPIO
+// ============================================================================
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+
+// ============================================================================
+// INTERRUPTS
+// ============================================================================
+// Handlers run synchronously from hal::setPinLevel() on a matching edge
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+// ============================================================================
+// MISC
+// ============================================================================
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// ============================================================================
+// CHIP
+// ============================================================================
+// Cycle counter emulated from the (host or virtual) clock at CPU_FREQ_MHZ
+class EspClass {
+public:
+    static const uint32_t CPU_FREQ_MHZ = 240;
+
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return CPU_FREQ_MHZ; }
+    uint32_t getFreeHeap() { return 0; }
+};
+
+extern EspClass ESP;
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+#include "HardwareSerial.h"
+
+#endif // Arduino_h
@@ -0,0 +1,13 @@
+/**
+ * ETH.h - Native (Linux) HAL shim
+ *
+ * The host build has no Ethernet MAC; networking goes through the simulated
+ * NetworkClient in Network.h.
+ */
+
+#ifndef ETH_h
+#define ETH_h
+
+#include "Network.h"
+
+#endif // ETH_h
@@ -0,0 +1,67 @@
+/**
+ * FS.h - Native (Linux) HAL shim
+ *
+ * Subset of the arduino-esp32 fs::FS / fs::File API backed by a host
+ * directory (see hal::setFilesystemRoot), so code written against LittleFS
+ * runs unchanged in the native build.
+ */
+
+#ifndef FS_h
+#define FS_h
+
+#include <memory>
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class File {
+public:
+    File() {}
+    explicit File(FILE* handle) : _handle(handle, fclose) {}
+
+    size_t write(const uint8_t* buffer, size_t size);
+    size_t read(uint8_t* buffer, size_t size);
+    bool seek(uint32_t position, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close() { _handle.reset(); }
+    operator bool() const { return (bool)_handle; }
+
+private:
+    std::shared_ptr<FILE> _handle;
+};
+
+class FS {
+public:
+    virtual ~FS() {}
+
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool mkdir(const char* path);
+
+protected:
+    bool _mounted = false;
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // FS_h
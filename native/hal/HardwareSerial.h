@@ -0,0 +1,32 @@
+/**
+ * HardwareSerial.h - Native (Linux) HAL shim
+ *
+ * Serial port backed by stdout. Output can be muted from native_hal.h so
+ * that throughput measurements are not dominated by terminal I/O; the byte
+ * count is kept either way.
+ */
+
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include "Stream.h"
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // HardwareSerial_h
@@ -0,0 +1,37 @@
+/**
+ * IPAddress.h - Native (Linux) HAL shim
+ *
+ * IPv4-only Arduino IPAddress for the host build.
+ */
+
+#ifndef IPAddress_h
+#define IPAddress_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include "Print.h"
+
+class IPAddress : public Printable {
+public:
+    IPAddress() : _address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    IPAddress(uint32_t address) : _address(address) {}
+
+    operator uint32_t() const { return _address; }
+    uint8_t operator[](int index) const { return (_address >> (index * 8)) & 0xFF; }
+    bool operator==(const IPAddress& other) const { return _address == other._address; }
+
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return String(buf);
+    }
+
+    size_t printTo(Print& p) const override { return p.print(toString()); }
+
+private:
+    uint32_t _address;  // Network byte order, as on the ESP32
+};
+
+#endif // IPAddress_h
@@ -0,0 +1,26 @@
+/**
+ * LittleFS.h - Native (Linux) HAL shim
+ *
+ * LittleFS instance of the host-directory filesystem in FS.h.
+ */
+
+#ifndef LittleFS_h
+#define LittleFS_h
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    void end() { _mounted = false; }
+    bool format();
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // LittleFS_h
@@ -0,0 +1,76 @@
+/**
+ * Network.h - Native (Linux) HAL shim
+ *
+ * NetworkClient connected to an in-process hal::NetworkPeer instead of a
+ * socket, so MQTT traffic can be generated and counted without a broker.
+ * NetworkServer hands out clients for peers queued with
+ * hal::connectToServer().
+ */
+
+#ifndef Network_h
+#define Network_h
+
+#include <deque>
+#include "Arduino.h"
+#include "Client.h"
+#include "native_hal.h"
+
+class NetworkClient : public Client {
+public:
+    NetworkClient() : _peer(nullptr), _connected(false) {}
+    explicit NetworkClient(hal::NetworkPeer* peer) : _peer(peer), _connected(false) {}
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override { return _connected && peer()->open(); }
+    operator bool() override { return _connected; }
+    using Print::write;
+
+    hal::NetworkPeer* peer() const { return _peer ? _peer : hal::defaultPeer(); }
+
+    // No socket behind a simulated client
+    int fd() const { return -1; }
+
+private:
+    friend class NetworkServer;
+
+    hal::NetworkPeer* _peer;
+    bool _connected;
+    std::deque<uint8_t> _rx;
+    std::vector<uint8_t> _reply;
+
+    void _deliver();
+};
+
+class NetworkServer {
+public:
+    explicit NetworkServer(uint16_t port = 80) : _port(port), _listening(false) {}
+
+    void begin() { _listening = true; }
+    void end() { _listening = false; }
+    void setNoDelay(bool) {}
+
+    /**
+     * A connection is waiting to be accepted
+     */
+    bool hasClient();
+
+    /**
+     * Take the oldest waiting connection (an unconnected client if none)
+     */
+    NetworkClient accept();
+
+private:
+    uint16_t _port;
+    bool _listening;
+};
+
+#endif // Network_h
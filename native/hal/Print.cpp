@@ -0,0 +1,51 @@
+/**
+ * Print.cpp - Native (Linux) HAL shim
+ *
+ * Formatting helpers for the host Print implementation.
+ */
+
+#include "Print.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++)) n++;
+        else break;
+    }
+    return n;
+}
+
+size_t Print::write(const char* str) {
+    if (!str) return 0;
+    return write((const uint8_t*)str, strlen(str));
+}
+
+size_t Print::printf(const char* format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len >= sizeof(buf)) len = sizeof(buf) - 1;
+    return write((const uint8_t*)buf, len);
+}
+
+size_t Print::print(const char* str) { return write(str); }
+size_t Print::print(const String& str) { return write(str.c_str()); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char value, int base) { return print(String(value, base)); }
+size_t Print::print(int value, int base) { return print(String(value, base)); }
+size_t Print::print(unsigned int value, int base) { return print(String(value, base)); }
+size_t Print::print(long value, int base) { return print(String(value, base)); }
+size_t Print::print(unsigned long value, int base) { return print(String(value, base)); }
+size_t Print::print(long long value, int base) { return print(String(value, base)); }
+size_t Print::print(unsigned long long value, int base) { return print(String(value, base)); }
+size_t Print::print(double value, int digits) { return print(String(value, digits)); }
+size_t Print::print(const Printable& printable) { return printable.printTo(*this); }
+
+size_t Print::println() { return write("\r\n"); }
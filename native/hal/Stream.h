@@ -0,0 +1,33 @@
+/**
+ * Stream.h - Native (Linux) HAL shim
+ *
+ * Arduino Stream base class for the host build.
+ */
+
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() const { return _timeout; }
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length && available() > 0) {
+            buffer[count++] = (uint8_t)read();
+        }
+        return count;
+    }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+#endif // Stream_h
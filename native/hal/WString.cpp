@@ -0,0 +1,178 @@
+/**
+ * WString.cpp - Native (Linux) HAL shim
+ *
+ * Arduino String implementation for the host build.
+ */
+
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+namespace {
+
+std::string formatInteger(unsigned long long value, bool negative, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char digits[66];
+    int pos = sizeof(digits) - 1;
+    digits[pos] = '\0';
+    do {
+        unsigned digit = value % base;
+        digits[--pos] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value > 0);
+    if (negative) digits[--pos] = '-';
+    return std::string(&digits[pos]);
+}
+
+std::string formatSigned(long long value, unsigned char base) {
+    if (base == 10 && value < 0) {
+        return formatInteger(0ULL - (unsigned long long)value, true, base);
+    }
+    return formatInteger((unsigned long long)value, false, base);
+}
+
+} // namespace
+
+String::String(const char* cstr) : _buffer(cstr ? cstr : "") {}
+String::String(char c) : _buffer(1, c) {}
+String::String(unsigned char value, unsigned char base) : _buffer(formatInteger(value, false, base)) {}
+String::String(int value, unsigned char base) : _buffer(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : _buffer(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base) : _buffer(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : _buffer(formatInteger(value, false, base)) {}
+String::String(long long value, unsigned char base) : _buffer(formatSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : _buffer(formatInteger(value, false, base)) {}
+String::String(float value, unsigned int decimalPlaces) : String((double)value, decimalPlaces) {}
+
+String::String(double value, unsigned int decimalPlaces) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+    _buffer = buf;
+}
+
+String& String::operator=(const char* cstr) {
+    _buffer = cstr ? cstr : "";
+    return *this;
+}
+
+bool String::reserve(unsigned int size) {
+    _buffer.reserve(size);
+    return true;
+}
+
+bool String::concat(const String& str) {
+    _buffer += str._buffer;
+    return true;
+}
+
+bool String::concat(const char* cstr) {
+    if (!cstr) return false;
+    _buffer += cstr;
+    return true;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+    if (!cstr) return false;
+    _buffer.append(cstr, length);
+    return true;
+}
+
+bool String::concat(char c) {
+    _buffer += c;
+    return true;
+}
+
+String operator+(const String& lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, char rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    return _buffer.length() == s._buffer.length() &&
+           strcasecmp(_buffer.c_str(), s._buffer.c_str()) == 0;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return _buffer.compare(0, prefix._buffer.length(), prefix._buffer) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix._buffer.length() > _buffer.length()) return false;
+    return _buffer.compare(_buffer.length() - suffix._buffer.length(),
+                           suffix._buffer.length(), suffix._buffer) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+    return index < _buffer.length() ? _buffer[index] : '\0';
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+    size_t pos = _buffer.find(ch, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    size_t pos = _buffer.find(str._buffer, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, _buffer.length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        unsigned int temp = endIndex;
+        endIndex = beginIndex;
+        beginIndex = temp;
+    }
+    if (beginIndex >= _buffer.length()) return String();
+    if (endIndex > _buffer.length()) endIndex = _buffer.length();
+    return String(_buffer.substr(beginIndex, endIndex - beginIndex).c_str());
+}
+
+void String::toUpperCase() {
+    for (char& c : _buffer) c = toupper((unsigned char)c);
+}
+
+void String::toLowerCase() {
+    for (char& c : _buffer) c = tolower((unsigned char)c);
+}
+
+void String::trim() {
+    size_t begin = 0;
+    while (begin < _buffer.length() && isspace((unsigned char)_buffer[begin])) begin++;
+    size_t end = _buffer.length();
+    while (end > begin && isspace((unsigned char)_buffer[end - 1])) end--;
+    _buffer = _buffer.substr(begin, end - begin);
+}
+
+long String::toInt() const {
+    return atol(_buffer.c_str());
+}
+
+float String::toFloat() const {
+    return (float)atof(_buffer.c_str());
+}
@@ -0,0 +1,83 @@
+/**
+ * WString.h - Native (Linux) HAL shim
+ *
+ * Arduino String implemented on top of std::string. Like the ESP32 core it
+ * allocates on the heap for anything beyond the small-string buffer, so
+ * String-heavy code paths show comparable allocation behaviour on the host.
+ */
+
+#ifndef WString_h
+#define WString_h
+
+#include <stddef.h>
+#include <string>
+
+class String {
+public:
+    String(const char* cstr = "");
+    String(const String& other) = default;
+    String(String&& other) = default;
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+
+    String& operator=(const String& rhs) = default;
+    String& operator=(String&& rhs) = default;
+    String& operator=(const char* cstr);
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return _buffer.length(); }
+    bool isEmpty() const { return _buffer.empty(); }
+    const char* c_str() const { return _buffer.c_str(); }
+
+    bool concat(const String& str);
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(char c);
+
+    String& operator+=(const String& rhs) { concat(rhs); return *this; }
+    String& operator+=(const char* cstr) { concat(cstr); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+
+    friend String operator+(const String& lhs, const String& rhs);
+    friend String operator+(const String& lhs, const char* rhs);
+    friend String operator+(const char* lhs, const String& rhs);
+    friend String operator+(const String& lhs, char rhs);
+
+    int compareTo(const String& s) const { return _buffer.compare(s._buffer); }
+    bool equals(const String& s) const { return _buffer == s._buffer; }
+    bool equals(const char* cstr) const { return _buffer == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& s) const;
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+
+    char charAt(unsigned int index) const;
+    char operator[](unsigned int index) const { return charAt(index); }
+    int indexOf(char ch, unsigned int fromIndex = 0) const;
+    int indexOf(const String& str, unsigned int fromIndex = 0) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void toUpperCase();
+    void toLowerCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+
+private:
+    std::string _buffer;
+};
+
+#endif // WString_h
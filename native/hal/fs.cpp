@@ -0,0 +1,107 @@
+/**
+ * fs.cpp - Native (Linux) HAL shim
+ *
+ * Host-directory backed FS/File and the LittleFS instance.
+ */
+
+#include <errno.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "LittleFS.h"
+#include "native_hal.h"
+
+fs::LittleFSFS LittleFS;
+
+namespace {
+
+std::string filesystemRoot = "littlefs";
+
+std::string hostPath(const char* path) {
+    return filesystemRoot + (path[0] == '/' ? "" : "/") + path;
+}
+
+} // namespace
+
+namespace hal {
+
+void setFilesystemRoot(const char* directory) {
+    filesystemRoot = directory;
+}
+
+} // namespace hal
+
+namespace fs {
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    return _handle ? fwrite(buffer, 1, size, _handle.get()) : 0;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    return _handle ? fread(buffer, 1, size, _handle.get()) : 0;
+}
+
+bool File::seek(uint32_t position, SeekMode mode) {
+    static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return _handle && fseek(_handle.get(), position, whence[mode]) == 0;
+}
+
+size_t File::position() const {
+    return _handle ? (size_t)ftell(_handle.get()) : 0;
+}
+
+size_t File::size() const {
+    struct stat info;
+    if (!_handle || fstat(fileno(_handle.get()), &info) != 0) {
+        return 0;
+    }
+    return (size_t)info.st_size;
+}
+
+void File::flush() {
+    if (_handle) {
+        fflush(_handle.get());
+    }
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    if (!_mounted) {
+        return File();
+    }
+    // Binary modes; "a" is opened "a+" as on LittleFS, where appends can be read back
+    std::string hostMode = std::string(mode[0] == 'a' ? "a+" : mode) + "b";
+    FILE* handle = fopen(hostPath(path).c_str(), hostMode.c_str());
+    return handle ? File(handle) : File();
+}
+
+bool FS::exists(const char* path) {
+    struct stat info;
+    return _mounted && stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return _mounted && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return _mounted && (::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST);
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles,
+                       const char* partitionLabel) {
+    struct stat info;
+    if (stat(filesystemRoot.c_str(), &info) != 0) {
+        if (!formatOnFail || ::mkdir(filesystemRoot.c_str(), 0755) != 0) {
+            return false;
+        }
+    }
+    _mounted = true;
+    return true;
+}
+
+bool LittleFSFS::format() {
+    // Not needed by the firmware; the runner picks a fresh directory instead
+    return false;
+}
+
+} // namespace fs
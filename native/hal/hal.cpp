@@ -0,0 +1,217 @@
+/**
+ * hal.cpp - Native (Linux) HAL shim
+ *
+ * Clock, GPIO and Serial simulation for the host build.
+ */
+
+#include "Arduino.h"
+#include "native_hal.h"
+
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+const Clock::time_point bootTime = Clock::now();
+
+struct PinState {
+    uint8_t mode = INPUT;
+    int level = LOW;
+    unsigned long toggles = 0;
+    void (*isr)(void*) = nullptr;
+    void* isrArg = nullptr;
+    int isrMode = 0;
+};
+
+PinState pins[hal::NUM_PINS];
+
+bool virtualClock = false;
+uint64_t virtualMicros = 0;
+
+bool serialEcho = true;
+unsigned long long serialBytes = 0;
+
+} // namespace
+
+// ============================================================================
+// TIMING
+// ============================================================================
+uint32_t millis() {
+    return (uint32_t)(hal::clockMicros() / 1000);
+}
+
+uint32_t micros() {
+    return (uint32_t)hal::clockMicros();
+}
+
+void delay(uint32_t ms) {
+    if (virtualClock) {
+        virtualMicros += (uint64_t)ms * 1000;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    if (virtualClock) {
+        virtualMicros += us;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+uint32_t EspClass::getCycleCount() {
+    if (virtualClock) {
+        return (uint32_t)(virtualMicros * CPU_FREQ_MHZ);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - bootTime).count();
+    return (uint32_t)((unsigned long long)ns * CPU_FREQ_MHZ / 1000);
+}
+
+namespace hal {
+
+void useVirtualClock(uint64_t startMicros) {
+    virtualClock = true;
+    virtualMicros = startMicros;
+}
+
+void advanceClock(uint64_t micros) {
+    if (virtualClock) {
+        virtualMicros += micros;
+    }
+}
+
+uint64_t clockMicros() {
+    if (virtualClock) {
+        return virtualMicros;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - bootTime).count();
+}
+
+} // namespace hal
+
+// ============================================================================
+// GPIO
+// ============================================================================
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= hal::NUM_PINS) return;
+    pins[pin].mode = mode;
+    if (mode == INPUT_PULLUP) pins[pin].level = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= hal::NUM_PINS) return;
+    int level = val ? HIGH : LOW;
+    if (pins[pin].level != level) pins[pin].toggles++;
+    pins[pin].level = level;
+}
+
+int digitalRead(uint8_t pin) {
+    if (pin >= hal::NUM_PINS) return LOW;
+    return pins[pin].level;
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return 0;
+}
+
+// ============================================================================
+// INTERRUPTS
+// ============================================================================
+static void callPlainHandler(void* handler) {
+    reinterpret_cast<void (*)(void)>(handler)();
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    attachInterruptArg(pin, callPlainHandler, reinterpret_cast<void*>(handler), mode);
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    if (pin >= hal::NUM_PINS) return;
+    pins[pin].isr = handler;
+    pins[pin].isrArg = arg;
+    pins[pin].isrMode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin >= hal::NUM_PINS) return;
+    pins[pin].isr = nullptr;
+    pins[pin].isrArg = nullptr;
+    pins[pin].isrMode = 0;
+}
+
+// ============================================================================
+// MISC
+// ============================================================================
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return rand() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) srand(seed);
+}
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    serialBytes += size;
+    if (serialEcho) fwrite(buffer, 1, size, stdout);
+    return size;
+}
+
+// ============================================================================
+// SIMULATION CONTROLS
+// ============================================================================
+namespace hal {
+
+void setPinLevel(uint8_t pin, int level) {
+    if (pin >= NUM_PINS) return;
+    PinState& state = pins[pin];
+    int newLevel = level ? HIGH : LOW;
+    if (state.level == newLevel) return;
+    state.level = newLevel;
+
+    int edge = newLevel == HIGH ? RISING : FALLING;
+    if (state.isr && (state.isrMode & edge)) {
+        state.isr(state.isrArg);
+    }
+}
+
+int pinLevel(uint8_t pin) {
+    if (pin >= NUM_PINS) return LOW;
+    return pins[pin].level;
+}
+
+unsigned long pinToggleCount(uint8_t pin) {
+    if (pin >= NUM_PINS) return 0;
+    return pins[pin].toggles;
+}
+
+void setSerialEcho(bool enabled) {
+    serialEcho = enabled;
+}
+
+unsigned long long serialBytesWritten() {
+    return serialBytes;
+}
+
+} // namespace hal
@@ -0,0 +1,213 @@
+/**
+ * native_hal.h - Native (Linux) HAL shim simulation controls
+ *
+ * Hooks for the host runner to drive simulated inputs, inspect outputs and
+ * attach fake network peers. Firmware code never includes this header.
+ */
+
+#ifndef native_hal_h
+#define native_hal_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace hal {
+
+// ============================================================================
+// GPIO SIMULATION
+// ============================================================================
+const uint8_t NUM_PINS = 40;
+
+/**
+ * Drive the level seen by digitalRead() on an input pin
+ * Runs an attached interrupt handler if the change matches its mode.
+ */
+void setPinLevel(uint8_t pin, int level);
+
+/**
+ * Current level of a pin (last digitalWrite() or simulated input level)
+ */
+int pinLevel(uint8_t pin);
+
+/**
+ * Number of digitalWrite() calls that changed the level of a pin
+ */
+unsigned long pinToggleCount(uint8_t pin);
+
+// ============================================================================
+// CLOCK
+// ============================================================================
+/**
+ * Switch millis()/micros() to a virtual clock that only moves when advanced
+ * delay() and delayMicroseconds() then advance it instead of sleeping,
+ * which makes runs deterministic and lets traces replay faster than real time.
+ * @param startMicros Initial virtual time (e.g. just before a 32-bit wrap)
+ */
+void useVirtualClock(uint64_t startMicros);
+
+/**
+ * Advance the virtual clock (no-op while on the host clock)
+ */
+void advanceClock(uint64_t micros);
+
+/**
+ * Current time in microseconds without the 32-bit wrap of micros()
+ */
+uint64_t clockMicros();
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+/**
+ * Enable/disable echoing Serial output to stdout (enabled by default)
+ */
+void setSerialEcho(bool enabled);
+
+/**
+ * Total bytes written to Serial, echoed or not
+ */
+unsigned long long serialBytesWritten();
+
+// ============================================================================
+// FILESYSTEM
+// ============================================================================
+/**
+ * Host directory backing LittleFS (default "littlefs" in the working
+ * directory); created by LittleFS.begin(true) if missing
+ */
+void setFilesystemRoot(const char* directory);
+
+// ============================================================================
+// NETWORK SIMULATION
+// ============================================================================
+/**
+ * Remote end of a simulated NetworkClient connection
+ */
+class NetworkPeer {
+public:
+    virtual ~NetworkPeer() {}
+
+    /**
+     * Accept or refuse a new connection
+     */
+    virtual bool accept(const char* host, uint16_t port) { return true; }
+
+    /**
+     * Consume bytes written by the client and append any response bytes
+     */
+    virtual void receive(const uint8_t* data, size_t length, std::vector<uint8_t>& reply) = 0;
+
+    /**
+     * Append bytes the peer sends on its own initiative
+     */
+    virtual void pump(std::vector<uint8_t>& reply) {}
+
+    /**
+     * Connection was closed by the client
+     */
+    virtual void close() {}
+
+    /**
+     * Bytes the peer takes from the next write (a full TCP send buffer
+     * returns 0; the client then writes less than asked)
+     */
+    virtual size_t writable() { return SIZE_MAX; }
+
+    /**
+     * false once the peer has closed its end
+     */
+    virtual bool open() { return true; }
+};
+
+/**
+ * In-process MQTT 3.1.1 broker that acknowledges CONNECT, SUBSCRIBE,
+ * PINGREQ and QoS 1 PUBLISH packets and counts published messages.
+ * Retained messages are kept per topic (what a new subscriber would get),
+ * and the client's Last Will is published when its connection drops
+ * without a DISCONNECT.
+ */
+class MqttLoopbackBroker : public NetworkPeer {
+public:
+    bool accept(const char* host, uint16_t port) override;
+    void receive(const uint8_t* data, size_t length, std::vector<uint8_t>& reply) override;
+    void close() override;
+
+    /**
+     * Queue a PUBLISH towards the client (e.g. a command)
+     */
+    void inject(const char* topic, const char* payload);
+
+    void pump(std::vector<uint8_t>& reply) override;
+    bool open() override { return _online; }
+
+    /**
+     * Drop the connection and refuse new ones while offline (an unreachable broker)
+     */
+    void setOnline(bool online);
+
+    /**
+     * Drop every <every>th PUBACK (0 = none) to exercise retransmission
+     */
+    void setPubackLoss(unsigned long every) { _pubackLoss = every; }
+
+    unsigned long connects() const { return _connects; }
+    unsigned long writes() const { return _writes; }
+    unsigned long duplicates() const { return _duplicates; }
+    unsigned long pubacksLost() const { return _pubacksLost; }
+    unsigned long publishes() const { return _publishes; }
+    unsigned long long publishedBytes() const { return _publishedBytes; }
+    const std::vector<uint8_t>& lastPayload() const { return _lastPayload; }
+    unsigned long willsPublished() const { return _willsPublished; }
+
+    /**
+     * Retained message of a topic ("" if none)
+     */
+    std::string retained(const std::string& topic) const;
+    size_t retainedTopics() const { return _retained.size(); }
+
+private:
+    void _handlePacket(const uint8_t* packet, size_t length, size_t headerLength,
+                       std::vector<uint8_t>& reply);
+    void _connectionLost();
+
+    std::vector<uint8_t> _pending;   // Partial packet bytes from the client
+    std::vector<uint8_t> _outbound;  // Injected packets not yet delivered
+    std::vector<uint8_t> _lastPayload;
+    bool _online = true;
+    unsigned long _pubackLoss = 0;
+    unsigned long _pubacks = 0;
+    unsigned long _connects = 0;
+    unsigned long _writes = 0;          // Client writes received
+    unsigned long _duplicates = 0;      // PUBLISH packets with DUP set
+    unsigned long _pubacksLost = 0;
+    unsigned long _publishes = 0;
+    unsigned long long _publishedBytes = 0;
+
+    // Last Will of the current session
+    bool _session = false;
+    bool _willSet = false;
+    bool _willRetain = false;
+    std::string _willTopic;
+    std::string _willMessage;
+    unsigned long _willsPublished = 0;
+    std::map<std::string, std::string> _retained;
+};
+
+/**
+ * Peer used by NetworkClient instances that were not given one explicitly
+ */
+void setDefaultPeer(NetworkPeer* peer);
+NetworkPeer* defaultPeer();
+
+/**
+ * Queue an incoming connection for the NetworkServer listening on a port
+ * The server's accept() returns a NetworkClient talking to this peer.
+ */
+void connectToServer(uint16_t port, NetworkPeer* peer);
+
+} // namespace hal
+
+#endif // native_hal_h
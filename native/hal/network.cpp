@@ -0,0 +1,326 @@
+/**
+ * network.cpp - Native (Linux) HAL shim
+ *
+ * Simulated NetworkClient and the in-process MQTT loopback broker.
+ */
+
+#include "Network.h"
+
+namespace {
+
+hal::NetworkPeer* defaultNetworkPeer = nullptr;
+
+// Connections queued by hal::connectToServer(), oldest first
+std::deque<std::pair<uint16_t, hal::NetworkPeer*>> pendingConnections;
+
+// MQTT control packet types (upper nibble of the fixed header)
+const uint8_t MQTT_CONNECT = 0x10;
+const uint8_t MQTT_CONNACK = 0x20;
+const uint8_t MQTT_PUBLISH = 0x30;
+const uint8_t MQTT_PUBACK = 0x40;
+const uint8_t MQTT_SUBSCRIBE = 0x80;
+const uint8_t MQTT_SUBACK = 0x90;
+const uint8_t MQTT_PINGREQ = 0xC0;
+const uint8_t MQTT_PINGRESP = 0xD0;
+const uint8_t MQTT_DISCONNECT = 0xE0;
+
+// CONNECT flags
+const uint8_t CONNECT_WILL = 0x04;
+const uint8_t CONNECT_WILL_RETAIN = 0x20;
+
+// Length-prefixed string at data[offset]; advances offset, false if truncated
+bool readString(const uint8_t* data, size_t length, size_t& offset, std::string& out) {
+    if (offset + 2 > length) return false;
+    size_t size = (data[offset] << 8) | data[offset + 1];
+    if (offset + 2 + size > length) return false;
+    out.assign((const char*)data + offset + 2, size);
+    offset += 2 + size;
+    return true;
+}
+
+void appendRemainingLength(std::vector<uint8_t>& out, size_t length) {
+    do {
+        uint8_t digit = length % 128;
+        length /= 128;
+        if (length > 0) digit |= 0x80;
+        out.push_back(digit);
+    } while (length > 0);
+}
+
+} // namespace
+
+// ============================================================================
+// NETWORK CLIENT
+// ============================================================================
+int NetworkClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port);
+}
+
+int NetworkClient::connect(const char* host, uint16_t port) {
+    hal::NetworkPeer* remote = peer();
+    if (!remote || !remote->accept(host, port)) {
+        _connected = false;
+        return 0;
+    }
+    _rx.clear();
+    _connected = true;
+    return 1;
+}
+
+size_t NetworkClient::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t NetworkClient::write(const uint8_t* buffer, size_t size) {
+    if (!_connected) return 0;
+    size_t window = peer()->writable();
+    if (size > window) size = window;
+    if (size == 0) return 0;
+    _reply.clear();
+    peer()->receive(buffer, size, _reply);
+    _rx.insert(_rx.end(), _reply.begin(), _reply.end());
+    return size;
+}
+
+int NetworkClient::available() {
+    if (!_connected) return 0;
+    _deliver();
+    return _rx.size();
+}
+
+int NetworkClient::read() {
+    if (_rx.empty()) return -1;
+    uint8_t c = _rx.front();
+    _rx.pop_front();
+    return c;
+}
+
+int NetworkClient::read(uint8_t* buffer, size_t size) {
+    size_t count = 0;
+    while (count < size && !_rx.empty()) {
+        buffer[count++] = _rx.front();
+        _rx.pop_front();
+    }
+    return count;
+}
+
+int NetworkClient::peek() {
+    return _rx.empty() ? -1 : _rx.front();
+}
+
+void NetworkClient::stop() {
+    if (_connected && peer()) peer()->close();
+    _connected = false;
+    _rx.clear();
+}
+
+void NetworkClient::_deliver() {
+    _reply.clear();
+    peer()->pump(_reply);
+    _rx.insert(_rx.end(), _reply.begin(), _reply.end());
+}
+
+// ============================================================================
+// NETWORK SERVER
+// ============================================================================
+bool NetworkServer::hasClient() {
+    if (!_listening) return false;
+    for (const auto& pending : pendingConnections) {
+        if (pending.first == _port) return true;
+    }
+    return false;
+}
+
+NetworkClient NetworkServer::accept() {
+    NetworkClient client;
+    if (!_listening) return client;
+    for (auto it = pendingConnections.begin(); it != pendingConnections.end(); ++it) {
+        if (it->first == _port) {
+            client._peer = it->second;
+            client._connected = true;
+            pendingConnections.erase(it);
+            break;
+        }
+    }
+    return client;
+}
+
+// ============================================================================
+// MQTT LOOPBACK BROKER
+// ============================================================================
+namespace hal {
+
+void setDefaultPeer(NetworkPeer* peer) {
+    defaultNetworkPeer = peer;
+}
+
+NetworkPeer* defaultPeer() {
+    return defaultNetworkPeer;
+}
+
+void connectToServer(uint16_t port, NetworkPeer* peer) {
+    pendingConnections.push_back(std::make_pair(port, peer));
+}
+
+bool MqttLoopbackBroker::accept(const char* host, uint16_t port) {
+    _connectionLost();
+    _pending.clear();
+    return _online;
+}
+
+void MqttLoopbackBroker::close() {
+    _connectionLost();
+    _pending.clear();
+}
+
+void MqttLoopbackBroker::setOnline(bool online) {
+    if (!online) {
+        _connectionLost();
+    }
+    _online = online;
+}
+
+std::string MqttLoopbackBroker::retained(const std::string& topic) const {
+    auto it = _retained.find(topic);
+    return it == _retained.end() ? std::string() : it->second;
+}
+
+void MqttLoopbackBroker::_connectionLost() {
+    // No DISCONNECT was received: the session ends with its Last Will
+    if (_session && _willSet) {
+        _willsPublished++;
+        if (_willRetain) {
+            _retained[_willTopic] = _willMessage;
+        }
+    }
+    _session = false;
+    _willSet = false;
+}
+
+void MqttLoopbackBroker::receive(const uint8_t* data, size_t length, std::vector<uint8_t>& reply) {
+    _writes++;
+    _pending.insert(_pending.end(), data, data + length);
+
+    // Handle every complete packet; keep a partial one for the next write
+    size_t offset = 0;
+    while (_pending.size() - offset >= 2) {
+        size_t remaining = 0;
+        size_t multiplier = 1;
+        size_t pos = offset + 1;
+        bool complete = false;
+        while (pos < _pending.size() && pos - offset <= 4) {
+            uint8_t digit = _pending[pos++];
+            remaining += (digit & 0x7F) * multiplier;
+            multiplier *= 128;
+            if (!(digit & 0x80)) {
+                complete = true;
+                break;
+            }
+        }
+        if (!complete || _pending.size() - pos < remaining) break;
+
+        _handlePacket(&_pending[offset], pos - offset + remaining, pos - offset, reply);
+        offset = pos + remaining;
+    }
+    _pending.erase(_pending.begin(), _pending.begin() + offset);
+}
+
+void MqttLoopbackBroker::inject(const char* topic, const char* payload) {
+    size_t topicLength = strlen(topic);
+    size_t payloadLength = strlen(payload);
+
+    _outbound.push_back(MQTT_PUBLISH);
+    appendRemainingLength(_outbound, 2 + topicLength + payloadLength);
+    _outbound.push_back(topicLength >> 8);
+    _outbound.push_back(topicLength & 0xFF);
+    _outbound.insert(_outbound.end(), topic, topic + topicLength);
+    _outbound.insert(_outbound.end(), payload, payload + payloadLength);
+}
+
+void MqttLoopbackBroker::pump(std::vector<uint8_t>& reply) {
+    reply.insert(reply.end(), _outbound.begin(), _outbound.end());
+    _outbound.clear();
+}
+
+void MqttLoopbackBroker::_handlePacket(const uint8_t* packet, size_t length, size_t headerLength,
+                                       std::vector<uint8_t>& reply) {
+    uint8_t type = packet[0] & 0xF0;
+    const uint8_t* body = packet + headerLength;
+    size_t bodyLength = length - headerLength;
+
+    switch (type) {
+        case MQTT_CONNECT: {
+            _connects++;
+            _session = true;
+            _willSet = false;
+            // Variable header: protocol name, level, flags, keep alive;
+            // payload: client id, then will topic and message if flagged
+            size_t offset = 0;
+            std::string protocol, clientId;
+            if (readString(body, bodyLength, offset, protocol) && offset + 4 <= bodyLength) {
+                uint8_t flags = body[offset + 1];
+                offset += 4;
+                if (readString(body, bodyLength, offset, clientId) && (flags & CONNECT_WILL)) {
+                    _willSet = readString(body, bodyLength, offset, _willTopic) &&
+                               readString(body, bodyLength, offset, _willMessage);
+                    _willRetain = flags & CONNECT_WILL_RETAIN;
+                }
+            }
+            const uint8_t connack[] = {MQTT_CONNACK, 0x02, 0x00, 0x00};
+            reply.insert(reply.end(), connack, connack + sizeof(connack));
+            break;
+        }
+        case MQTT_PUBLISH: {
+            if (bodyLength < 2) break;
+            size_t topicLength = (body[0] << 8) | body[1];
+            size_t payloadOffset = 2 + topicLength;
+            uint8_t qos = (packet[0] >> 1) & 0x03;
+            if (packet[0] & 0x08) {
+                _duplicates++;
+            }
+            if (qos > 0) {
+                if (_pubackLoss && ++_pubacks % _pubackLoss == 0) {
+                    _pubacksLost++;
+                } else if (bodyLength >= payloadOffset + 2) {
+                    const uint8_t puback[] = {MQTT_PUBACK, 0x02, body[payloadOffset], body[payloadOffset + 1]};
+                    reply.insert(reply.end(), puback, puback + sizeof(puback));
+                }
+                payloadOffset += 2;
+            }
+            if (payloadOffset > bodyLength) break;
+            _publishes++;
+            _publishedBytes += length;
+            _lastPayload.assign(body + payloadOffset, body + bodyLength);
+            if (packet[0] & 0x01) {
+                // An empty retained message clears the topic
+                std::string topic((const char*)body + 2, topicLength);
+                if (payloadOffset == bodyLength) {
+                    _retained.erase(topic);
+                } else {
+                    _retained[topic].assign((const char*)body + payloadOffset, bodyLength - payloadOffset);
+                }
+            }
+            break;
+        }
+        case MQTT_SUBSCRIBE: {
+            if (bodyLength < 2) break;
+            const uint8_t suback[] = {MQTT_SUBACK, 0x03, body[0], body[1], 0x00};
+            reply.insert(reply.end(), suback, suback + sizeof(suback));
+            break;
+        }
+        case MQTT_PINGREQ: {
+            const uint8_t pingresp[] = {MQTT_PINGRESP, 0x00};
+            reply.insert(reply.end(), pingresp, pingresp + sizeof(pingresp));
+            break;
+        }
+        case MQTT_DISCONNECT:
+            // Clean disconnect: the will is discarded
+            _session = false;
+            _willSet = false;
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace hal
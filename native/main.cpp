@@ -0,0 +1,456 @@
+/**
+ * main.cpp - Native host runner
+ *
+ * Runs the unmodified ControlTask, Gate, LEDManager and MQTTManager classes
+ * as a Linux process on top of the HAL shim in native/hal, drives them with
+ * simulated MQTT commands and bouncing sensor edges, and reports loop
+ * latency, per-side loop period histograms, throughput and sensor detection
+ * latency. The control and network sides alternate in one thread; their
+ * only coupling is the ControlTask command and state queues, as on the
+ * ESP32.
+ *
+ * By default both sides are tickless like the firmware tasks: each runs only
+ * when its next deadline expires or it is woken (sensor edge, command, state
+ * change), and the process sleeps in between.
+ *
+ * --broker-outage takes the loopback broker offline for the given time,
+ * starting a third into the run; --puback-loss drops every n-th PUBACK.
+ * Both exercise the status outbox (queueing, retransmission, delivery
+ * latency). --loop-delay switches back to
+ * running both sides every iteration at a fixed cadence for comparison.
+ *
+ * Usage:
+ *   pio run -e native
+ *   .pio/build/native/program [--duration <ms>] [--loop-delay <ms>] [--network-poll <ms>]
+ *                             [--command-interval <ms>] [--sensor-interval <ms>]
+ *                             [--status-format json|cbor] [--journal <dir>]
+ *                             [--broker-outage <ms>] [--puback-loss <n>]
+ *                             [--verbose] [--metrics]
+ *   .pio/build/native/program <benchmark> [--iterations <n>]
+ *
+ * Benchmarks:
+ *   bench-status   Status JSON serializer vs. String concatenation, JSON vs. CBOR
+ *   bench-command  In-place command parser vs. String copy and compare
+ *   bench-gates    Gate update cost for 1-3 gates, one pass vs. one controller per gate
+ *   bench-inputs   Bit-parallel input scanner vs. one debounce filter per pin
+ *   bench-log      Asynchronous logger vs. Serial.print for a state change burst
+ *   bench-climate  DHT22 frame decoder checks (known frames) and decode time
+ *
+ * HTTP load test (simulated clients, see bench_http.cpp):
+ *   .pio/build/native/program bench-http [--clients <n>] [--stalled <n>] [--duration <ms>] [--close]
+ *
+ * Trace replay (virtual clock, see replay.cpp):
+ *   .pio/build/native/program replay [--trace <file> | --synthetic <days>] [--timeline]
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "Arduino.h"
+#include "Network.h"
+#include "native_hal.h"
+#include "benchutil.h"
+
+#include "controltask.h"
+#include "gate.h"
+#include "journal.h"
+#include <LittleFS.h>
+#include "ledmanager.h"
+#include "logger.h"
+#include "loophistogram.h"
+#include "metrics.h"
+#include "mqttmanager.h"
+#include "scheduler.h"
+#include "statusdecoder.h"
+
+// ============================================================================
+// RUNNER CONFIGURATION
+// ============================================================================
+struct RunnerOptions {
+    unsigned long durationMs = 2000;         // Wall-clock run time
+    unsigned long loopDelayMs = 0;           // Fixed-cadence polling period (0 = tickless)
+    unsigned long networkPollMs = 10;        // Network socket poll cap (NETWORK_TASK_MAX_WAIT_MS)
+    unsigned long commandIntervalMs = 1000;  // Interval between injected commands
+    unsigned long sensorIntervalMs = 700;    // Interval between sensor flips
+    StatusFormat statusFormat = STATUS_FORMAT_JSON;  // MQTT status payload encoding
+    const char* journalDir = nullptr;        // LittleFS root for the journal (off if unset)
+    unsigned long brokerOutageMs = 0;        // Broker offline this long, from a third into the run
+    unsigned long pubackLoss = 0;            // Drop every n-th PUBACK (0 = none)
+    bool verbose = false;                    // Echo firmware Serial output
+    bool metrics = false;                    // Print /metrics output at the end
+};
+
+const char* STATUS_TOPIC = "gateguardian/status";
+const char* COMMAND_TOPIC = "gateguardian/command";
+const char* AVAILABILITY_TOPIC = "gateguardian/availability";
+
+static bool parseOptions(int argc, char** argv, RunnerOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        String arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (arg == "--duration" && hasValue) {
+            options.durationMs = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--loop-delay" && hasValue) {
+            options.loopDelayMs = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--network-poll" && hasValue) {
+            options.networkPollMs = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--command-interval" && hasValue) {
+            options.commandIntervalMs = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--sensor-interval" && hasValue) {
+            options.sensorIntervalMs = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--status-format" && hasValue) {
+            String format(argv[++i]);
+            if (format == "json") {
+                options.statusFormat = STATUS_FORMAT_JSON;
+            } else if (format == "cbor") {
+                options.statusFormat = STATUS_FORMAT_CBOR;
+            } else {
+                fprintf(stderr, "Unknown status format: %s\n", format.c_str());
+                return false;
+            }
+        } else if (arg == "--journal" && hasValue) {
+            options.journalDir = argv[++i];
+        } else if (arg == "--broker-outage" && hasValue) {
+            options.brokerOutageMs = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--puback-loss" && hasValue) {
+            options.pubackLoss = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else if (arg == "--metrics") {
+            options.metrics = true;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Contact bounce applied after each simulated sensor flip (offsets in us)
+const unsigned long SENSOR_BOUNCE_US[] = {150, 400, 900, 1600};
+
+static void flipSensor(int level) {
+    hal::setPinLevel(BoardPolicy::PIN_POSITION_SENSOR, level);
+    for (size_t i = 0; i < sizeof(SENSOR_BOUNCE_US) / sizeof(SENSOR_BOUNCE_US[0]); i++) {
+        unsigned long gap = SENSOR_BOUNCE_US[i] - (i ? SENSOR_BOUNCE_US[i - 1] : 0);
+        delayMicroseconds(gap);
+        hal::setPinLevel(BoardPolicy::PIN_POSITION_SENSOR, (i % 2 == 0) ? !level : level);
+    }
+}
+
+static void writeChunk(const char* data, size_t length, void* context) {
+    fwrite(data, 1, length, stdout);
+}
+
+// Control task state listener: the network side runs on its next pass
+static void wakeNetworkSide(void* context) {
+    *static_cast<bool*>(context) = true;
+}
+
+// Remaining time until an interval expires (0 if already due)
+static unsigned long remainingMs(unsigned long since, unsigned long interval) {
+    unsigned long elapsed = millis() - since;
+    return elapsed >= interval ? 0 : interval - elapsed;
+}
+
+static unsigned long percentile(const std::vector<unsigned long>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    size_t index = (size_t)(fraction * (sorted.size() - 1));
+    return sorted[index];
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "bench-status") == 0) {
+        return runStatusBenchmark(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "bench-command") == 0) {
+        return runCommandBenchmark(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "bench-gates") == 0) {
+        return runGateBenchmark(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "bench-inputs") == 0) {
+        return runInputBenchmark(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "bench-log") == 0) {
+        return runLogBenchmark(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "bench-climate") == 0) {
+        return runClimateBenchmark(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "bench-http") == 0) {
+        return runHttpLoadTest(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "replay") == 0) {
+        return runReplay(argc - 1, argv + 1);
+    }
+
+    RunnerOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    hal::setSerialEcho(options.verbose);
+    logger.addSink(Logger::serialSink, nullptr);
+
+    // Managers live for the whole process, as in the sketch (MQTTManager's
+    // destructor deletes the client it was given, so never destroy it here)
+    static hal::MqttLoopbackBroker broker;
+    static NetworkClient networkClient(&broker);
+    broker.setPubackLoss(options.pubackLoss);
+
+    pinMode(BoardPolicy::PIN_LED_RED, OUTPUT);
+    pinMode(BoardPolicy::PIN_LED_GREEN, OUTPUT);
+    bench::releaseFusionInputs<BoardPolicy>();
+
+    static Scheduler controlScheduler;
+    Gate* gate = new Gate(controlScheduler);
+    gate->initialize();
+
+    LEDManager* ledManager = new LEDManager(controlScheduler, BoardPolicy::PIN_LED_RED,
+                                            BoardPolicy::PIN_LED_GREEN);
+    ledManager->initialize();
+
+    ControlTask* controlTask = new ControlTask(&controlScheduler, gate, ledManager);
+    controlTask->begin();
+    bool networkWake = false;
+    controlTask->setStateListener(wakeNetworkSide, &networkWake);
+    LoopHistogram networkLoopHistogram;
+
+    static Metrics metrics;
+    metrics.begin();
+    controlTask->setMetrics(&metrics);
+    metrics.addLoopHistogram("control", &controlTask->getLoopHistogram());
+    metrics.addLoopHistogram("network", &networkLoopHistogram);
+
+    MQTTManager* mqttManager = new MQTTManager("loopback", 1883, "native_gate",
+                                               STATUS_TOPIC, COMMAND_TOPIC);
+    mqttManager->initialize(&networkClient);
+    mqttManager->setControlTask(controlTask);
+    mqttManager->setStatusFormat(options.statusFormat);
+    mqttManager->setAvailability(AVAILABILITY_TOPIC, "online", "offline", true);
+
+    // Journal persists in the given directory across runs, like flash across boots
+    static Journal journal(LittleFS, "/journal");
+    uint32_t journalStart = 0;
+    if (options.journalDir) {
+        hal::setFilesystemRoot(options.journalDir);
+        if (!LittleFS.begin(true) || !journal.begin()) {
+            fprintf(stderr, "Journal directory %s is not usable\n", options.journalDir);
+            return 1;
+        }
+        journalStart = journal.lastSequence() - 1;  // Include this run's boot marker
+    }
+    mqttManager->update();
+    mqttManager->connect();
+
+    std::vector<unsigned long> loopTimes;
+    loopTimes.reserve(1 << 20);
+    std::vector<unsigned long> detectionTimes;
+
+    int sensorLevel = hal::pinLevel(BoardPolicy::PIN_POSITION_SENSOR);
+    unsigned long sensorEdgeUs = 0;
+    bool sensorEdgePending = false;
+
+    const char* commands[] = {"OPEN", "CLOSE", "STOP", "TOGGLE"};
+    size_t nextCommand = 0;
+    unsigned long commandsInjected = 0;
+
+    unsigned long runStart = millis();
+    unsigned long lastCommand = runStart;
+    unsigned long lastSensorFlip = runStart;
+
+    // Tickless bookkeeping: when each side last ran and how long it may sleep
+    bool tickless = options.loopDelayMs == 0;
+    unsigned long controlRunMs = runStart, controlWaitMs = 0;
+    unsigned long networkRunMs = runStart, networkWaitMs = 0;
+    unsigned long controlWakeups = 0, networkWakeups = 0;
+    unsigned long long busyUs = 0;
+    unsigned long outageStart = options.durationMs / 3;
+
+    while (millis() - runStart < options.durationMs) {
+        if (options.brokerOutageMs > 0) {
+            unsigned long runTime = millis() - runStart;
+            broker.setOnline(runTime < outageStart || runTime - outageStart >= options.brokerOutageMs);
+        }
+
+        if (options.commandIntervalMs > 0 && millis() - lastCommand >= options.commandIntervalMs) {
+            lastCommand = millis();
+            broker.inject(COMMAND_TOPIC, commands[nextCommand]);
+            nextCommand = (nextCommand + 1) % (sizeof(commands) / sizeof(commands[0]));
+            commandsInjected++;
+        }
+
+        if (options.sensorIntervalMs > 0 && !sensorEdgePending &&
+            millis() - lastSensorFlip >= options.sensorIntervalMs) {
+            lastSensorFlip = millis();
+            sensorLevel = !sensorLevel;
+            sensorEdgeUs = micros();
+            sensorEdgePending = true;
+            flipSensor(sensorLevel);
+        }
+
+        unsigned long loopStart = micros();
+        bool ran = false;
+
+        // Control side: one ControlTask iteration when due or woken
+        if (!tickless || controlTask->wakePending() || remainingMs(controlRunMs, controlWaitMs) == 0) {
+            controlRunMs = millis();
+            controlWaitMs = controlTask->runOnce();
+            controlWakeups++;
+            ran = true;
+        }
+
+        // Network side: same order of work as networkLoop() in the sketch
+        if (!tickless || networkWake || remainingMs(networkRunMs, networkWaitMs) == 0) {
+            networkWake = false;
+            networkLoopHistogram.tick();
+            GateSnapshot snapshot;
+            while (controlTask->pollState(snapshot)) {
+                mqttManager->updateGateState(snapshot);
+            }
+            GateTransition transition;
+            while (controlTask->pollTransition(transition)) {
+                journal.append(transition);
+            }
+            {
+                CycleTimer timer(metrics.subsystem(SUBSYSTEM_MQTT));
+                mqttManager->setClient(&networkClient);
+                mqttManager->update();
+            }
+            networkRunMs = millis();
+            networkWaitMs = std::min<unsigned long>(options.networkPollMs,
+                                                    mqttManager->msUntilNextPublish());
+            networkWakeups++;
+            ran = true;
+        }
+
+        if (ran) {
+            unsigned long loopTime = micros() - loopStart;
+            loopTimes.push_back(loopTime);
+            busyUs += loopTime;
+        }
+
+        // Log task: formats and writes outside the measured loop, as on the ESP32
+        logger.drain();
+
+        if (sensorEdgePending && gate->getSensorState(0) == (bool)sensorLevel) {
+            detectionTimes.push_back(micros() - sensorEdgeUs);
+            sensorEdgePending = false;
+        }
+
+        if (!tickless) {
+            delay(options.loopDelayMs);
+            continue;
+        }
+
+        // Sleep until the earliest deadline or the next injected event
+        unsigned long sleepMs = std::min(remainingMs(controlRunMs, controlWaitMs),
+                                         remainingMs(networkRunMs, networkWaitMs));
+        if (options.commandIntervalMs > 0) {
+            sleepMs = std::min(sleepMs, remainingMs(lastCommand, options.commandIntervalMs));
+        }
+        if (options.sensorIntervalMs > 0 && !sensorEdgePending) {
+            sleepMs = std::min(sleepMs, remainingMs(lastSensorFlip, options.sensorIntervalMs));
+        }
+        sleepMs = std::min(sleepMs, remainingMs(runStart, options.durationMs));
+        if (sleepMs > 0 && !controlTask->wakePending() && !networkWake) {
+            delay(sleepMs);
+        }
+    }
+    unsigned long elapsedMs = millis() - runStart;
+    logger.drain();
+
+    std::sort(loopTimes.begin(), loopTimes.end());
+    std::sort(detectionTimes.begin(), detectionTimes.end());
+    unsigned long long total = 0;
+    for (unsigned long t : loopTimes) total += t;
+
+    printf("\n=== Native run summary ===\n");
+    printf("Duration:            %lu ms\n", elapsedMs);
+    printf("Mode:                %s\n", tickless ? "tickless" : "fixed cadence");
+    printf("Loop iterations:     %zu (%.0f/s)\n", loopTimes.size(),
+           elapsedMs ? loopTimes.size() * 1000.0 / elapsedMs : 0.0);
+    printf("Wake-ups:            control %lu (%.0f/s)  network %lu (%.0f/s)\n",
+           controlWakeups, elapsedMs ? controlWakeups * 1000.0 / elapsedMs : 0.0,
+           networkWakeups, elapsedMs ? networkWakeups * 1000.0 / elapsedMs : 0.0);
+    printf("Busy:                %.3f%%\n", elapsedMs ? busyUs / (elapsedMs * 10.0) : 0.0);
+    printf("Loop latency (us):   min %lu  avg %.2f  p50 %lu  p99 %lu  max %lu\n",
+           loopTimes.empty() ? 0 : loopTimes.front(),
+           loopTimes.empty() ? 0.0 : (double)total / loopTimes.size(),
+           percentile(loopTimes, 0.50), percentile(loopTimes, 0.99),
+           loopTimes.empty() ? 0 : loopTimes.back());
+    printf("Control period (us): p50 <%u  p99 <%u  max %u\n",
+           controlTask->getLoopHistogram().percentile(0.50f),
+           controlTask->getLoopHistogram().percentile(0.99f),
+           controlTask->getLoopHistogram().maxPeriod());
+    printf("Network period (us): p50 <%u  p99 <%u  max %u\n",
+           networkLoopHistogram.percentile(0.50f), networkLoopHistogram.percentile(0.99f),
+           networkLoopHistogram.maxPeriod());
+    printf("Sensor detection (us): %zu edges  p50 %lu  max %lu\n", detectionTimes.size(),
+           percentile(detectionTimes, 0.50),
+           detectionTimes.empty() ? 0 : detectionTimes.back());
+    printf("Commands injected:   %lu (%u dropped)\n", commandsInjected,
+           controlTask->droppedCommands());
+    printf("MQTT connects:       %lu\n", broker.connects());
+    printf("MQTT publishes:      %lu (%llu bytes, %s, %lu duplicates)\n", broker.publishes(),
+           broker.publishedBytes(), statusFormatName(options.statusFormat), broker.duplicates());
+    OutboxStats outbox = mqttManager->outboxStats();
+    printf("Status delivery:     %lu queued, %lu delivered, %lu pending, %lu retransmits "
+           "(%lu PUBACKs lost)\n",
+           (unsigned long)outbox.queued, (unsigned long)outbox.delivered,
+           (unsigned long)outbox.pending, (unsigned long)outbox.retransmits, broker.pubacksLost());
+    printf("Status loss:         %lu dropped (queue full), %lu expired (no PUBACK)\n",
+           (unsigned long)outbox.dropped, (unsigned long)outbox.expired);
+    printf("Status latency (ms): last %lu  mean %lu  max %lu\n",
+           (unsigned long)outbox.lastLatencyMs, (unsigned long)outbox.meanLatencyMs,
+           (unsigned long)outbox.maxLatencyMs);
+    printf("Status writes:       %lu packets in %lu writes (%lu client writes in total)\n",
+           (unsigned long)outbox.packets, (unsigned long)outbox.writes, broker.writes());
+    // What a subscriber connecting now would get without waiting
+    unsigned retainedGates = 0;
+    for (uint8_t i = 0; i < Gate::GATE_COUNT; i++) {
+        std::string topic = STATUS_TOPIC;
+        if (Gate::GATE_COUNT > 1) topic += "/" + std::to_string(i);
+        retainedGates += !broker.retained(topic).empty();
+    }
+    std::string availability = broker.retained(AVAILABILITY_TOPIC);
+    printf("Retained:            status of %u/%u gates, availability %s (%lu wills published)\n",
+           retainedGates, (unsigned)Gate::GATE_COUNT,
+           availability.empty() ? "none" : availability.c_str(), broker.willsPublished());
+    const std::vector<uint8_t>& payload = broker.lastPayload();
+    if (options.statusFormat == STATUS_FORMAT_CBOR && !payload.empty()) {
+        GateStatus last;
+        char deviceId[32];
+        if (decodeStatusCbor(payload.data(), payload.size(), last, deviceId, sizeof(deviceId))) {
+            printf("Last status (CBOR):  %zu bytes, %s %s sensor %d uptime %us\n", payload.size(),
+                   last.deviceId, gateStateName(last.state), last.sensorRaw, last.uptime);
+        } else {
+            printf("Last status (CBOR):  %zu bytes, decode FAILED\n", payload.size());
+        }
+    }
+    printf("Relay pulses:        open %lu  close %lu  stop %lu\n",
+           hal::pinToggleCount(BoardPolicy::PIN_RELAY_OPEN) / 2,
+           hal::pinToggleCount(BoardPolicy::PIN_RELAY_CLOSE) / 2,
+           hal::pinToggleCount(BoardPolicy::PIN_RELAY_STOP) / 2);
+    printf("LED toggles:         red %lu  green %lu\n",
+           hal::pinToggleCount(BoardPolicy::PIN_LED_RED), hal::pinToggleCount(BoardPolicy::PIN_LED_GREEN));
+    printf("Final gate state:    %s\n", gate->getStateString(0).c_str());
+    printf("Serial output:       %llu bytes (%u log records dropped)\n", hal::serialBytesWritten(),
+           logger.dropped());
+
+    if (options.journalDir) {
+        printf("\n=== /journal?since=%u ===\n", journalStart);
+        uint32_t last = journal.streamCsv(journalStart, writeChunk, nullptr);
+        printf("Journal: last sequence %u, %u failed writes, %u transitions dropped\n", last,
+               journal.failedWrites(), controlTask->droppedTransitions());
+    }
+
+    if (options.metrics) {
+        printf("\n=== /metrics ===\n");
+        metrics.writePrometheus(writeChunk, nullptr);
+    }
+    return 0;
+}
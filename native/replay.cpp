@@ -0,0 +1,584 @@
+/**
+ * replay.cpp - Deterministic trace replay of the gate state machine
+ *
+ * Feeds a recorded (or synthetic) trace of sensor edges and commands
+ * through the unmodified ControlTask, Gate, LEDManager and Scheduler on the
+ * HAL's virtual clock and GPIO. Time jumps straight from one deadline or
+ * trace event to the next instead of sleeping, so months of operation
+ * replay in seconds, with millis()/micros() wrapping as on the ESP32.
+ *
+ * Trace format, one event per line ('#' starts a comment):
+ *   <time_ms> sensor <0|1>           position sensor level (1 = closed)
+ *   <time_ms> lights <0|1>           warning light (1 = on)
+ *   <time_ms> lock <0|1>             gate lock (1 = engaged)
+ *   <time_ms> command <keyword>      open, close, stop or toggle (as over MQTT)
+ *   <time_ms> settled <open|closed>  the gate came to rest there (ground
+ *                                    truth for detection latency, not an input)
+ * Times are milliseconds from the start of the trace (fractions allowed)
+ * and must not decrease.
+ *
+ * The trace is replayed twice: with the warning light and lock inputs
+ * (sensor fusion) and with the position sensor alone, as on a gate without
+ * those wires. The report compares how long each took to report the
+ * settled states, and how often it reported OPEN while the gate was
+ * still moving; the replay fails if either run did so even once.
+ *
+ * Usage: .pio/build/native/program replay [--trace <file> | --synthetic <days>]
+ *                                         [--seed <n>] [--write-trace <file>]
+ *                                         [--start-ms <ms>] [--timeline]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include "Arduino.h"
+#include "native_hal.h"
+#include "benchutil.h"
+
+#include "commandparser.h"
+#include "controltask.h"
+#include "gate.h"
+#include "ledmanager.h"
+#include "scheduler.h"
+
+namespace {
+
+// ============================================================================
+// TRACE
+// ============================================================================
+enum TraceKind : uint8_t {
+    TRACE_SENSOR,
+    TRACE_LIGHTS,
+    TRACE_LOCK,
+    TRACE_COMMAND,
+    TRACE_SETTLED
+};
+
+const char* const TRACE_KIND_NAMES[] = {"sensor", "lights", "lock", "command", "settled"};
+
+struct TraceEvent {
+    uint64_t timeUs;        // Offset from the start of the trace
+    TraceKind kind;
+    bool level;             // Sensor (1 = closed), lights (1 = on), lock (1 = engaged)
+    GateCommand command;    // Command events
+    GateState settled;      // Settled events: GATE_OPEN or GATE_CLOSED
+};
+
+struct ReplayOptions {
+    const char* tracePath = nullptr;
+    const char* writePath = nullptr;
+    unsigned long syntheticDays = 90;
+    unsigned long seed = 1;
+    uint64_t startMs = 0;
+    bool timeline = false;
+};
+
+bool loadTrace(const char* path, std::vector<TraceEvent>& events) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Cannot open trace %s\n", path);
+        return false;
+    }
+
+    char line[128];
+    unsigned long lineNumber = 0;
+    uint64_t lastUs = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        double timeMs;
+        char kind[16], argument[16];
+        int fields = sscanf(line, "%lf %15s %15s", &timeMs, kind, argument);
+        if (fields <= 0) {
+            continue;  // Blank or comment-only line
+        }
+
+        TraceEvent event = {(uint64_t)(timeMs * 1000.0 + 0.5), TRACE_SENSOR, false, GATE_COMMAND_STOP, GATE_UNKNOWN};
+        bool binary = fields == 3 && (strcmp(argument, "0") == 0 || strcmp(argument, "1") == 0);
+        if (fields != 3 || timeMs < 0 || event.timeUs < lastUs) {
+            ok = false;
+        } else if (strcmp(kind, "command") == 0) {
+            event.kind = TRACE_COMMAND;
+            ok = parseGateCommand(argument, strlen(argument), event.command);
+        } else if (strcmp(kind, "settled") == 0) {
+            event.kind = TRACE_SETTLED;
+            event.settled = strcmp(argument, "open") == 0 ? GATE_OPEN
+                          : strcmp(argument, "closed") == 0 ? GATE_CLOSED : GATE_UNKNOWN;
+            ok = event.settled != GATE_UNKNOWN;
+        } else if (binary && strcmp(kind, "sensor") == 0) {
+            event.level = argument[0] == '1';
+        } else if (binary && strcmp(kind, "lights") == 0) {
+            event.kind = TRACE_LIGHTS;
+            event.level = argument[0] == '1';
+        } else if (binary && strcmp(kind, "lock") == 0) {
+            event.kind = TRACE_LOCK;
+            event.level = argument[0] == '1';
+        } else {
+            ok = false;
+        }
+
+        if (ok) {
+            events.push_back(event);
+            lastUs = event.timeUs;
+        } else {
+            fprintf(stderr, "%s:%lu: invalid trace event\n", path, lineNumber);
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+bool writeTrace(const char* path, const std::vector<TraceEvent>& events) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Cannot write trace %s\n", path);
+        return false;
+    }
+    fprintf(file, "# time_ms event argument\n");
+    for (const TraceEvent& event : events) {
+        fprintf(file, "%llu.%03u %s ", (unsigned long long)(event.timeUs / 1000), (unsigned)(event.timeUs % 1000),
+                TRACE_KIND_NAMES[event.kind]);
+        if (event.kind == TRACE_COMMAND) {
+            fprintf(file, "%s\n", COMMAND_KEYWORDS[event.command].text);
+        } else if (event.kind == TRACE_SETTLED) {
+            fprintf(file, "%s\n", event.settled == GATE_OPEN ? "open" : "closed");
+        } else {
+            fprintf(file, "%d\n", event.level ? 1 : 0);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+// Deterministic xorshift generator; traces depend only on the seed
+class TraceRandom {
+public:
+    explicit TraceRandom(uint64_t seed) : _state(seed * 2654435761ULL + 1) {}
+
+    uint64_t next() {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return _state;
+    }
+
+    // Uniform in [low, high]
+    uint64_t between(uint64_t low, uint64_t high) {
+        return low + next() % (high - low + 1);
+    }
+
+private:
+    uint64_t _state;
+};
+
+const uint64_t MS = 1000;
+const uint64_t SECOND = 1000 * MS;
+const uint64_t DAY = 86400 * SECOND;
+
+void addSensorEdge(std::vector<TraceEvent>& events, uint64_t timeUs, bool level) {
+    // Contact bounce: the reed switch chatters for ~1.5 ms before settling
+    static const uint64_t BOUNCE_US[] = {0, 300, 700, 1100, 1500};
+    for (size_t i = 0; i < sizeof(BOUNCE_US) / sizeof(BOUNCE_US[0]); i++) {
+        TraceEvent event = {timeUs + BOUNCE_US[i], TRACE_SENSOR, (i % 2 == 0) ? level : !level,
+                            GATE_COMMAND_STOP, GATE_UNKNOWN};
+        events.push_back(event);
+    }
+}
+
+void addEvent(std::vector<TraceEvent>& events, uint64_t timeUs, TraceKind kind, bool level) {
+    TraceEvent event = {timeUs, kind, level, GATE_COMMAND_STOP, GATE_UNKNOWN};
+    events.push_back(event);
+}
+
+void addCommand(std::vector<TraceEvent>& events, uint64_t timeUs, GateCommand command) {
+    TraceEvent event = {timeUs, TRACE_COMMAND, false, command, GATE_UNKNOWN};
+    events.push_back(event);
+}
+
+void addSettled(std::vector<TraceEvent>& events, uint64_t timeUs, GateState state) {
+    TraceEvent event = {timeUs, TRACE_SETTLED, false, GATE_COMMAND_STOP, state};
+    events.push_back(event);
+}
+
+// Warning light blinking at 1 Hz while the motor runs, dark at the end
+void addMotion(std::vector<TraceEvent>& events, uint64_t startUs, uint64_t endUs) {
+    const uint64_t HALF_PERIOD_US = 500 * MS;
+    bool on = true;
+    for (uint64_t time = startUs; time < endUs; time += HALF_PERIOD_US, on = !on) {
+        addEvent(events, time, TRACE_LIGHTS, on);
+    }
+    addEvent(events, endUs, TRACE_LIGHTS, false);
+}
+
+/**
+ * Synthetic operation: a few open/close cycles a day with real travel times
+ * spread around the 20 s default travel time, and occasional obstructions
+ * where the gate reverses before reaching the closed position. The warning
+ * light blinks while the motor runs; the lock releases before an open and
+ * engages after a close.
+ */
+void generateTrace(unsigned long days, unsigned long seed, std::vector<TraceEvent>& events) {
+    TraceRandom random(seed);
+    addSensorEdge(events, 0, true);
+    addEvent(events, 0, TRACE_LOCK, true);
+
+    for (unsigned long day = 0; day < days; day++) {
+        uint64_t time = day * DAY + random.between(6 * 3600, 8 * 3600) * SECOND;
+        unsigned cycles = random.between(3, 8);
+        for (unsigned c = 0; c < cycles && time < (day + 1) * DAY - 3600 * SECOND; c++) {
+            addCommand(events, time, GATE_COMMAND_OPEN);
+            addEvent(events, time + 200 * MS, TRACE_LOCK, false);
+            uint64_t openTravel = random.between(16000, 24000) * MS;
+            addMotion(events, time + 300 * MS, time + openTravel);
+            addSensorEdge(events, time + random.between(600, 2000) * MS, false);
+            addSettled(events, time + openTravel, GATE_OPEN);
+
+            time += openTravel + random.between(30, 1200) * SECOND;
+            addCommand(events, time, GATE_COMMAND_CLOSE);
+
+            if (random.between(0, 99) < 4) {
+                // Obstruction: reverses back open; closed again a few minutes later
+                uint64_t reversal = random.between(3000, 12000) * MS;
+                addMotion(events, time + 300 * MS, time + reversal);
+                addSettled(events, time + reversal, GATE_OPEN);
+                time += random.between(120, 600) * SECOND;
+                addCommand(events, time, GATE_COMMAND_CLOSE);
+            }
+            uint64_t travel = random.between(16000, 24000) * MS;
+            addMotion(events, time + 300 * MS, time + travel);
+            addSensorEdge(events, time + travel, true);
+            addSettled(events, time + travel, GATE_CLOSED);
+            addEvent(events, time + travel + 500 * MS, TRACE_LOCK, true);
+
+            time += travel + random.between(600, 7200) * SECOND;
+        }
+    }
+
+    // Light, sensor and lock events of one move interleave
+    std::stable_sort(events.begin(), events.end(),
+                     [](const TraceEvent& a, const TraceEvent& b) { return a.timeUs < b.timeUs; });
+}
+
+// ============================================================================
+// REPLAY
+// ============================================================================
+bool parseReplayOptions(int argc, char** argv, ReplayOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--trace") == 0 && hasValue) {
+            options.tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--synthetic") == 0 && hasValue) {
+            options.syntheticDays = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--write-trace") == 0 && hasValue) {
+            options.writePath = argv[++i];
+        } else if (strcmp(argv[i], "--start-ms") == 0 && hasValue) {
+            options.startMs = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--timeline") == 0) {
+            options.timeline = true;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+void printTime(uint64_t us) {
+    uint64_t ms = us / MS;
+    printf("%3llu+%02llu:%02llu:%02llu.%03llu", (unsigned long long)(ms / 86400000),
+           (unsigned long long)(ms / 3600000 % 24), (unsigned long long)(ms / 60000 % 60),
+           (unsigned long long)(ms / 1000 % 60), (unsigned long long)(ms % 1000));
+}
+
+// Reporting of the settled states in the trace, per target state
+struct DetectionStats {
+    unsigned long detected = 0;     // Reported at or after the gate settled
+    unsigned long early = 0;        // Reported while the gate was still moving
+    unsigned long missed = 0;       // Not reported before the next settled marker
+    uint64_t totalUs = 0;
+    uint64_t maxUs = 0;
+};
+
+struct ReplayResult {
+    std::map<std::pair<int, int>, unsigned long> transitionCounts;
+    unsigned long transitions = 0, snapshots = 0, iterations = 0;
+    unsigned long sensorEvents = 0, fusionEvents = 0, commandEvents = 0;
+    unsigned long closingTimeouts = 0, lateCloses = 0;
+    unsigned droppedTransitions = 0;
+    TravelEstimate travel;
+    unsigned long travelTimeoutMs = 0;
+    GateState finalState = GATE_UNKNOWN;
+    uint64_t simulatedUs = 0;
+    double wallSeconds = 0;
+    DetectionStats detection[2];    // [0] open, [1] closed
+};
+
+inline uint8_t fusionPinLevel(bool active) {
+    return active ? BoardPolicy::FUSION_INPUT_ACTIVE_LEVEL : !BoardPolicy::FUSION_INPUT_ACTIVE_LEVEL;
+}
+
+/**
+ * Replay the trace once on fresh controller objects
+ * @param fusion Drive the warning light and lock inputs; otherwise they
+ *               stay inactive, as on a gate with only the position sensor
+ */
+void replayTrace(const std::vector<TraceEvent>& events, const ReplayOptions& options, bool fusion,
+                 ReplayResult& result) {
+    const uint8_t lightsPin = BoardPolicy::GATE_MOTION_INPUT[0];
+    const uint8_t lockPin = BoardPolicy::GATE_LOCK_INPUT[0];
+
+    hal::useVirtualClock(options.startMs * MS);
+    const uint64_t startUs = hal::clockMicros();
+
+    // Initial input levels from the trace, as if the gate was found that way at boot
+    bool initialLevel = true;
+    for (const TraceEvent& event : events) {
+        if (event.kind == TRACE_SENSOR) {
+            initialLevel = event.level;
+            break;
+        }
+    }
+    hal::setPinLevel(BoardPolicy::PIN_POSITION_SENSOR, initialLevel);
+    bench::releaseFusionInputs<BoardPolicy>();
+    for (size_t i = 0; fusion && i < events.size() && events[i].timeUs == 0; i++) {
+        if (events[i].kind == TRACE_LIGHTS && lightsPin != NO_PIN) {
+            hal::setPinLevel(lightsPin, fusionPinLevel(events[i].level));
+        } else if (events[i].kind == TRACE_LOCK && lockPin != NO_PIN) {
+            hal::setPinLevel(lockPin, fusionPinLevel(events[i].level));
+        }
+    }
+    pinMode(BoardPolicy::PIN_LED_RED, OUTPUT);
+    pinMode(BoardPolicy::PIN_LED_GREEN, OUTPUT);
+
+    Scheduler scheduler;
+    Gate gate(scheduler);
+    gate.initialize();
+    LEDManager ledManager(scheduler, BoardPolicy::PIN_LED_RED, BoardPolicy::PIN_LED_GREEN);
+    ledManager.initialize();
+    ControlTask controlTask(&scheduler, &gate, &ledManager);
+    controlTask.begin();
+
+    bool closingTimedOut = false;
+    uint64_t closingTimeoutUs = 0;
+
+    // Detection latency: a settled marker stays pending until the gate
+    // reports that state
+    GateState reportedState = gate.getState(0);
+    uint64_t reportedSinceUs = startUs;
+    bool pending[2] = {false, false};
+    uint64_t settledUs[2] = {0, 0};
+
+    uint64_t controlDueUs = startUs;
+    auto runControl = [&]() {
+        // A zero wait means "run again now"; allow a few, then let time move
+        uint32_t waitMs = 0;
+        for (int zero = 0; zero < 4 && waitMs == 0; zero++) {
+            waitMs = controlTask.runOnce();
+            result.iterations++;
+        }
+        uint64_t now = hal::clockMicros();
+        controlDueUs = waitMs == SCHEDULE_IDLE ? UINT64_MAX : now + (uint64_t)(waitMs ? waitMs : 1) * MS;
+
+        // Stand in for the network task so the state queue never backs up
+        GateSnapshot snapshot;
+        while (controlTask.pollState(snapshot)) {
+            result.snapshots++;
+        }
+
+        GateTransition transition;
+        while (controlTask.pollTransition(transition)) {
+            result.transitions++;
+            result.transitionCounts[std::make_pair((int)transition.from, (int)transition.to)]++;
+            reportedState = transition.to;
+            reportedSinceUs = now;
+
+            int target = transition.to == GATE_OPEN ? 0 : transition.to == GATE_CLOSED ? 1 : -1;
+            if (target >= 0 && pending[target]) {
+                DetectionStats& stats = result.detection[target];
+                uint64_t latency = now - settledUs[target];
+                stats.detected++;
+                stats.totalUs += latency;
+                if (latency > stats.maxUs) stats.maxUs = latency;
+                pending[target] = false;
+            }
+
+            // Timeout heuristic check: CLOSING timed out to OPEN, then the sensor
+            // reported closed anyway without a new command
+            if (transition.from == GATE_CLOSING && transition.to == GATE_OPEN &&
+                transition.source == COMMAND_SOURCE_GATE) {
+                result.closingTimeouts++;
+                closingTimedOut = true;
+                closingTimeoutUs = now;
+            } else if (closingTimedOut && transition.to == GATE_CLOSED &&
+                       transition.source == COMMAND_SOURCE_GATE && now - closingTimeoutUs < 30 * SECOND) {
+                result.lateCloses++;
+                closingTimedOut = false;
+            } else if (transition.source != COMMAND_SOURCE_GATE) {
+                closingTimedOut = false;
+            }
+
+            if (options.timeline) {
+                printTime(now - startUs);
+                printf("  %-7s -> %-7s (%s)\n", gateStateName(transition.from),
+                       gateStateName(transition.to), commandSourceName(transition.source));
+            }
+        }
+    };
+
+    auto advanceTo = [&](uint64_t targetUs) {
+        while (controlDueUs <= targetUs) {
+            uint64_t now = hal::clockMicros();
+            if (controlDueUs > now) {
+                hal::advanceClock(controlDueUs - now);
+            }
+            runControl();
+        }
+        uint64_t now = hal::clockMicros();
+        if (targetUs > now) {
+            hal::advanceClock(targetUs - now);
+        }
+    };
+
+    auto wallStart = std::chrono::steady_clock::now();
+    runControl();
+    for (const TraceEvent& event : events) {
+        advanceTo(startUs + event.timeUs);
+        switch (event.kind) {
+            case TRACE_COMMAND:
+                result.commandEvents++;
+                controlTask.postCommand(event.command, COMMAND_SOURCE_MQTT, 0);
+                break;
+            case TRACE_SENSOR:
+                result.sensorEvents++;
+                hal::setPinLevel(BoardPolicy::PIN_POSITION_SENSOR, event.level);
+                break;
+            case TRACE_LIGHTS:
+            case TRACE_LOCK: {
+                uint8_t pin = event.kind == TRACE_LIGHTS ? lightsPin : lockPin;
+                if (fusion && pin != NO_PIN) {
+                    result.fusionEvents++;
+                    hal::setPinLevel(pin, fusionPinLevel(event.level));
+                }
+                break;
+            }
+            case TRACE_SETTLED: {
+                int target = event.settled == GATE_OPEN ? 0 : 1;
+                DetectionStats& stats = result.detection[target];
+                if (pending[target]) {
+                    stats.missed++;
+                }
+                pending[1 - target] = false;
+                uint64_t now = hal::clockMicros();
+                if (reportedState == event.settled && reportedSinceUs < now) {
+                    stats.early++;
+                    pending[target] = false;
+                } else {
+                    pending[target] = true;
+                    settledUs[target] = now;
+                }
+                break;
+            }
+        }
+        // Woken by the command or an input interrupt
+        if (controlTask.wakePending()) {
+            runControl();
+        }
+    }
+    // Let the last movement time out
+    advanceTo(hal::clockMicros() + (uint64_t)TravelEstimator::MAX_SAMPLE_MS * MS);
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    result.simulatedUs = hal::clockMicros() - startUs;
+    result.droppedTransitions = controlTask.droppedTransitions();
+    result.travel = gate.travelEstimator(0).estimate();
+    result.travelTimeoutMs = gate.travelEstimator(0).timeoutMs();
+    result.finalState = gate.getState(0);
+}
+
+void printDetection(const char* label, const DetectionStats& stats) {
+    printf("  %-14s %8lu %10.0f %10.0f %7lu %7lu\n", label, stats.detected,
+           stats.detected ? stats.totalUs / (double)stats.detected / MS : 0.0, stats.maxUs / (double)MS,
+           stats.early, stats.missed);
+}
+
+} // namespace
+
+int runReplay(int argc, char** argv) {
+    ReplayOptions options;
+    if (!parseReplayOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    std::vector<TraceEvent> events;
+    if (options.tracePath) {
+        if (!loadTrace(options.tracePath, events)) {
+            return 1;
+        }
+    } else {
+        generateTrace(options.syntheticDays, options.seed, events);
+    }
+    if (options.writePath && !writeTrace(options.writePath, events)) {
+        return 1;
+    }
+
+    hal::setSerialEcho(false);
+
+    ReplayResult result;
+    replayTrace(events, options, true, result);
+
+    // Same trace again as a gate wired with the position sensor only
+    ReplayOptions sensorOnlyOptions = options;
+    sensorOnlyOptions.timeline = false;
+    ReplayResult sensorOnly;
+    replayTrace(events, sensorOnlyOptions, false, sensorOnly);
+
+    unsigned long totalEvents = result.sensorEvents + result.fusionEvents + result.commandEvents;
+    printf("\n=== Trace replay ===\n");
+    printf("Trace:               %s\n", options.tracePath ? options.tracePath : "synthetic");
+    printf("Trace events:        %lu (sensor %lu, lights/lock %lu, command %lu)\n", totalEvents,
+           result.sensorEvents, result.fusionEvents, result.commandEvents);
+    printf("Simulated time:      ");
+    printTime(result.simulatedUs);
+    printf(" (millis() wrapped %llu times)\n",
+           (unsigned long long)((options.startMs + result.simulatedUs / MS) >> 32));
+    printf("Transitions:         %lu (%u dropped)\n", result.transitions, result.droppedTransitions);
+    for (const auto& entry : result.transitionCounts) {
+        printf("  %-7s -> %-7s  %lu\n", gateStateName((GateState)entry.first.first),
+               gateStateName((GateState)entry.first.second), entry.second);
+    }
+    printf("Closing timeouts:    %lu (%lu closed by sensor within 30 s after)\n", result.closingTimeouts,
+           result.lateCloses);
+    printf("Learned travel time: %u ms +/- %u ms (%u samples, timeout %lu ms)\n", result.travel.meanMs,
+           result.travel.deviationMs, result.travel.samples, result.travelTimeoutMs);
+    printf("Final gate state:    %s\n", gateStateName(result.finalState));
+    printf("Control iterations:  %lu (%lu state snapshots)\n", result.iterations, result.snapshots);
+    printf("Wall time:           %.3f s\n", result.wallSeconds);
+    printf("Throughput:          %.0f events/s, %.0fx real time\n",
+           result.wallSeconds > 0 ? totalEvents / result.wallSeconds : 0.0,
+           result.wallSeconds > 0 ? result.simulatedUs / 1e6 / result.wallSeconds : 0.0);
+
+    printf("\n=== Detection latency (time from settling to the reported state) ===\n");
+    printf("  %-14s %8s %10s %10s %7s %7s\n", "", "detected", "mean ms", "max ms", "early", "missed");
+    printDetection("OPEN fusion", result.detection[0]);
+    printDetection("OPEN sensor", sensorOnly.detection[0]);
+    printDetection("CLOSED fusion", result.detection[1]);
+    printDetection("CLOSED sensor", sensorOnly.detection[1]);
+    printf("Sensor only:         %lu transitions, %lu closing timeouts\n", sensorOnly.transitions,
+           sensorOnly.closingTimeouts);
+
+    // OPEN has no end-position signal: reporting it late costs latency,
+    // reporting it while the leaf still moves is wrong
+    if (result.detection[0].early || sensorOnly.detection[0].early) {
+        fprintf(stderr, "OPEN reported before the gate settled (fusion %lu, sensor only %lu)\n",
+                result.detection[0].early, sensorOnly.detection[0].early);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * statusdecoder.cpp - Host-side decoder for the CBOR status payload
+ *
+ * Minimal CBOR reader covering the definite-length items the firmware
+ * emits (integers, text, simple values, maps and arrays for skipping).
+ */
+
+#include "statusdecoder.h"
+
+namespace {
+
+class CborReader {
+public:
+    CborReader(const uint8_t* data, size_t length)
+        : _data(data), _length(length), _position(0), _error(false) {}
+
+    bool ok() const { return !_error; }
+    bool atEnd() const { return _position >= _length; }
+
+    // Read an item head; simple values (false/true/null) report major 7
+    bool head(uint8_t& major, uint64_t& value) {
+        if (atEnd()) return fail();
+        uint8_t initial = _data[_position++];
+        major = initial >> 5;
+        uint8_t info = initial & 0x1F;
+        if (info < 24) {
+            value = info;
+            return true;
+        }
+        if (info > 27) return fail();  // Indefinite lengths are never emitted
+        size_t bytes = (size_t)1 << (info - 24);
+        if (_length - _position < bytes) return fail();
+        value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value = (value << 8) | _data[_position++];
+        }
+        return true;
+    }
+
+    bool text(uint64_t length, char* buffer, size_t size) {
+        if (_length - _position < length || length >= size) return fail();
+        memcpy(buffer, _data + _position, (size_t)length);
+        buffer[length] = '\0';
+        _position += (size_t)length;
+        return true;
+    }
+
+    // Skip the rest of an item whose head was already read
+    bool skip(uint8_t major, uint64_t value, int depth = 0) {
+        if (depth > 8) return fail();
+        switch (major) {
+            case 0: case 1: case 7:
+                return true;
+            case 2: case 3:
+                if (_length - _position < value) return fail();
+                _position += (size_t)value;
+                return true;
+            case 4: case 5: {
+                uint64_t items = major == 5 ? value * 2 : value;
+                for (uint64_t i = 0; i < items; i++) {
+                    uint8_t itemMajor;
+                    uint64_t itemValue;
+                    if (!head(itemMajor, itemValue) || !skip(itemMajor, itemValue, depth + 1)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case 6: {
+                uint8_t itemMajor;
+                uint64_t itemValue;
+                return head(itemMajor, itemValue) && skip(itemMajor, itemValue, depth + 1);
+            }
+            default:
+                return fail();
+        }
+    }
+
+private:
+    bool fail() {
+        _error = true;
+        return false;
+    }
+
+    const uint8_t* _data;
+    size_t _length;
+    size_t _position;
+    bool _error;
+};
+
+// Simple value arguments (major type 7)
+const uint64_t SIMPLE_FALSE = 20;
+const uint64_t SIMPLE_TRUE = 21;
+const uint64_t SIMPLE_NULL = 22;
+
+} // namespace
+
+bool decodeStatusCbor(const uint8_t* data, size_t length, GateStatus& status,
+                      char* deviceId, size_t deviceIdSize) {
+    CborReader cbor(data, length);
+    memset(&status, 0, sizeof(status));
+    if (deviceIdSize == 0) return false;
+    deviceId[0] = '\0';
+    status.deviceId = deviceId;
+
+    uint8_t major;
+    uint64_t entries;
+    if (!cbor.head(major, entries) || major != 5) return false;
+
+    bool versionSeen = false;
+    bool temperatureValid = false;
+    bool humidityValid = false;
+    for (uint64_t i = 0; i < entries; i++) {
+        uint64_t key, value;
+        if (!cbor.head(major, key) || major != 0) return false;
+        if (!cbor.head(major, value)) return false;
+
+        bool isUnsigned = major == 0;
+        bool isBool = major == 7 && (value == SIMPLE_FALSE || value == SIMPLE_TRUE);
+        bool isNull = major == 7 && value == SIMPLE_NULL;
+
+        switch (key) {
+            case STATUS_KEY_VERSION:
+                if (!isUnsigned || value != STATUS_CBOR_VERSION) return false;
+                versionSeen = true;
+                break;
+            case STATUS_KEY_DEVICE_ID:
+                if (major != 3 || !cbor.text(value, deviceId, deviceIdSize)) return false;
+                break;
+            case STATUS_KEY_TIMESTAMP:
+                if (!isUnsigned) return false;
+                status.timestamp = (uint32_t)value;
+                break;
+            case STATUS_KEY_STATE:
+                if (!isUnsigned || value >= GATE_STATE_COUNT) return false;
+                status.state = (GateState)value;
+                break;
+            case STATUS_KEY_SENSOR_RAW:
+                if (!isBool) return false;
+                status.sensorRaw = value == SIMPLE_TRUE;
+                break;
+            case STATUS_KEY_INPUTS:
+                if (!isUnsigned) return false;
+                status.gateLights = value & STATUS_INPUT_GATE_LIGHTS;
+                status.gateLock = value & STATUS_INPUT_GATE_LOCK;
+                status.externalRelay = value & STATUS_INPUT_EXTERNAL_RELAY;
+                status.photoEye = value & STATUS_INPUT_PHOTO_EYE;
+                break;
+            case STATUS_KEY_TEMPERATURE:
+                if (isNull) break;
+                if (major > 1) return false;
+                status.temperature = (major == 0 ? (float)value : -1.0f - (float)value) / 100.0f;
+                temperatureValid = true;
+                break;
+            case STATUS_KEY_HUMIDITY:
+                if (isNull) break;
+                if (!isUnsigned) return false;
+                status.humidity = value / 10.0f;
+                humidityValid = true;
+                break;
+            case STATUS_KEY_UPTIME:
+                if (!isUnsigned) return false;
+                status.uptime = (uint32_t)value;
+                break;
+            case STATUS_KEY_PASSES:
+                if (!isUnsigned) return false;
+                status.passes = (uint32_t)value;
+                break;
+            case STATUS_KEY_LAST_PASS_MS:
+                if (!isUnsigned) return false;
+                status.lastPassMs = (uint32_t)value;
+                break;
+            default:
+                if (!cbor.skip(major, value)) return false;
+                break;
+        }
+    }
+
+    status.climateValid = temperatureValid && humidityValid;
+    return versionSeen && cbor.ok() && cbor.atEnd();
+}
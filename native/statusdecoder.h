@@ -0,0 +1,27 @@
+/**
+ * statusdecoder.h - Host-side decoder for the CBOR status payload
+ *
+ * Reference decoder for the version 1 layout documented in
+ * statusserializer.h, used by the native runner and benchmark to check the
+ * firmware encoder and as a template for dashboard-side consumers. Unknown
+ * keys are skipped so newer firmware stays readable.
+ */
+
+#ifndef statusdecoder_h
+#define statusdecoder_h
+
+#include "statusserializer.h"
+
+/**
+ * Decode a CBOR status document
+ * @param data Encoded document
+ * @param length Document length in bytes
+ * @param status Receives the decoded fields; deviceId points into deviceId buffer
+ * @param deviceId Buffer for the NUL-terminated device ID
+ * @param deviceIdSize Size of the device ID buffer
+ * @return false if the document is malformed, truncated or of another version
+ */
+bool decodeStatusCbor(const uint8_t* data, size_t length, GateStatus& status,
+                      char* deviceId, size_t deviceIdSize);
+
+#endif // statusdecoder_h
@@ -0,0 +1,355 @@
+/**
+ * BoardPolicy.h - ESP32 Swing Gate Controller board pin and timing policy
+ *
+ * Compile-time description of the GateGuardian v1.1 board: every GPIO
+ * assignment and the gate timing in one place. Gate is specialized on this
+ * policy, so pins and timings are immediate constants in the hot path, and
+ * pin conflicts are rejected by static_assert instead of showing up as a
+ * misbehaving input on the bench.
+ *
+ * A board may drive several gates: each gate is one column of the GATE_*
+ * pin tables, and the firmware keeps one state machine per column.
+ */
+
+#ifndef BoardPolicy_h
+#define BoardPolicy_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Entry of a per-gate pin table for a function the gate does not have
+constexpr uint8_t NO_PIN = 0xFF;
+
+// ============================================================================
+// ESP32 PIN CONSTRAINTS
+// ============================================================================
+namespace pincheck {
+
+// GPIO 34-39 have no output driver and no internal pull-up/down
+constexpr bool isInputOnly(uint8_t pin) {
+    return pin >= 34 && pin <= 39;
+}
+
+// GPIO 6-11 are wired to the SPI flash
+constexpr bool isFlashPin(uint8_t pin) {
+    return pin >= 6 && pin <= 11;
+}
+
+// LAN8720 RMII/MDIO/power pins used by the EMAC driver
+constexpr bool isEthernetPin(uint8_t pin) {
+    return pin == 0 || pin == 16 || pin == 18 || pin == 19 || pin == 21 ||
+           pin == 22 || pin == 23 || pin == 25 || pin == 26 || pin == 27;
+}
+
+// GPIO 0, 2, 5, 12 and 15 are sampled at reset (boot mode, flash voltage,
+// boot log); a load on them can keep the board from booting or flashing
+constexpr bool isStrappingPin(uint8_t pin) {
+    return pin == 0 || pin == 2 || pin == 5 || pin == 12 || pin == 15;
+}
+
+// GPIO 1 and 3 are the UART0 console (flashing and Serial)
+constexpr bool isUartPin(uint8_t pin) {
+    return pin == 1 || pin == 3;
+}
+
+constexpr bool isValidGpio(uint8_t pin) {
+    return pin <= 39 && pin != 20 && pin != 24 && (pin < 28 || pin > 31);
+}
+
+template <size_t N>
+constexpr bool allDistinct(const uint8_t (&pins)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = i + 1; j < N; j++) {
+            if (pins[i] == pins[j]) return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr bool noneInputOnly(const uint8_t (&pins)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (isInputOnly(pins[i])) return false;
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr bool allUsable(const uint8_t (&pins)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (!isValidGpio(pins[i]) || isFlashPin(pins[i]) || isEthernetPin(pins[i])) return false;
+    }
+    return true;
+}
+
+template <size_t N, size_t M>
+constexpr bool allListed(const uint8_t (&pins)[N], const uint8_t (&list)[M]) {
+    for (size_t i = 0; i < N; i++) {
+        bool found = false;
+        for (size_t j = 0; j < M; j++) {
+            if (pins[i] == list[j]) found = true;
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+// Pins free of boot side effects (not strapping, not the console UART)
+template <size_t N>
+constexpr bool noneStrapping(const uint8_t (&pins)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (pins[i] != NO_PIN && (isStrappingPin(pins[i]) || isUartPin(pins[i]))) return false;
+    }
+    return true;
+}
+
+// Like allListed, skipping NO_PIN entries
+template <size_t N, size_t M>
+constexpr bool allListedOrNone(const uint8_t (&pins)[N], const uint8_t (&list)[M]) {
+    for (size_t i = 0; i < N; i++) {
+        bool found = pins[i] == NO_PIN;
+        for (size_t j = 0; j < M; j++) {
+            if (pins[i] == list[j]) found = true;
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+// Every pin (NO_PIN skipped) is in one of two lists
+template <size_t N, size_t M, size_t K>
+constexpr bool allListedInEither(const uint8_t (&pins)[N], const uint8_t (&first)[M],
+                                 const uint8_t (&second)[K]) {
+    for (size_t i = 0; i < N; i++) {
+        bool found = pins[i] == NO_PIN;
+        for (size_t j = 0; j < M; j++) {
+            if (pins[i] == first[j]) found = true;
+        }
+        for (size_t j = 0; j < K; j++) {
+            if (pins[i] == second[j]) found = true;
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+} // namespace pincheck
+
+// ============================================================================
+// GATEGUARDIAN V1.1 BOARD
+// ============================================================================
+struct GateGuardianBoard {
+    // Relay outputs (pulsed to operate the Sommer controller)
+    static constexpr uint8_t PIN_RELAY_OPEN = 15;
+    static constexpr uint8_t PIN_RELAY_CLOSE = 12;
+    static constexpr uint8_t PIN_RELAY_STOP = 14;
+
+    // LED outputs
+    static constexpr uint8_t PIN_LED_RED = 17;      // Closed (blink = closing)
+    static constexpr uint8_t PIN_LED_GREEN = 5;     // Open (blink = opening)
+
+    // Inputs from the gate controller
+    static constexpr uint8_t PIN_GATE_LIGHTS = 33;  // Warning light, active while moving
+    static constexpr uint8_t PIN_GATE_LOCK = 32;    // Enabled when gate is closed
+    static constexpr uint8_t PIN_EXTERNAL_RELAY = 35; // Triggered when gate is closed
+    static constexpr uint8_t PIN_PHOTO_EYE = 36;    // Beam interrupted
+
+    // Position sensor: the external relay contact is the closed-position
+    // signal (HIGH when closed), so it is the same pin by definition
+    static constexpr uint8_t PIN_POSITION_SENSOR = PIN_EXTERNAL_RELAY;
+
+    // Optional sensors
+    static constexpr uint8_t PIN_SENSOR_1 = 4;      // DHT22 climate sensor
+    static constexpr uint8_t PIN_SENSOR_2 = 2;      // Not used
+
+    // Gates driven by this board, one column per gate
+    static constexpr uint8_t GATE_COUNT = 1;
+    static constexpr uint8_t GATE_RELAY_OPEN[GATE_COUNT] = {PIN_RELAY_OPEN};
+    static constexpr uint8_t GATE_RELAY_CLOSE[GATE_COUNT] = {PIN_RELAY_CLOSE};
+    static constexpr uint8_t GATE_RELAY_STOP[GATE_COUNT] = {PIN_RELAY_STOP};
+    static constexpr uint8_t GATE_POSITION_SENSOR[GATE_COUNT] = {PIN_POSITION_SENSOR};
+
+    // Sensor fusion inputs of each gate (NO_PIN where not wired): the
+    // warning light is on or blinking while the gate moves, the lock is
+    // engaged at the closed position. Both are contacts to ground against
+    // the input pull-up, so active is LOW.
+    static constexpr uint8_t GATE_MOTION_INPUT[GATE_COUNT] = {PIN_GATE_LIGHTS};
+    static constexpr uint8_t GATE_LOCK_INPUT[GATE_COUNT] = {PIN_GATE_LOCK};
+    static constexpr uint8_t FUSION_INPUT_ACTIVE_LEVEL = 0;
+
+    // Photo eye level while the beam is interrupted (one pass per interruption)
+    static constexpr uint8_t PHOTO_EYE_ACTIVE_LEVEL = 1;
+
+    // Gate timing
+    static constexpr uint32_t RELAY_PULSE_MS = 500;         // Relay activation pulse
+    static constexpr uint32_t OPERATION_TIME_MS = 20000;    // Travel time until one is learned
+    static constexpr uint32_t SENSOR_DEBOUNCE_US = 10000;   // Quiet time before accepting a level
+    static constexpr uint32_t MOTION_HOLD_MS = 1500;        // Warning light dark this long: gate stopped
+
+    // Position sensor re-sampling when no edge woke the control task
+    // (catches a missed interrupt): fast while moving, slow while idle
+    static constexpr uint32_t MOVING_POLL_MS = 50;
+    static constexpr uint32_t IDLE_POLL_MS = 1000;
+
+    // Every assigned function, one entry each (checked for conflicts)
+    static constexpr uint8_t OUTPUT_PINS[] = {
+        PIN_RELAY_OPEN, PIN_RELAY_CLOSE, PIN_RELAY_STOP, PIN_LED_RED, PIN_LED_GREEN
+    };
+    static constexpr uint8_t INPUT_PINS[] = {
+        PIN_GATE_LIGHTS, PIN_GATE_LOCK, PIN_EXTERNAL_RELAY, PIN_PHOTO_EYE,
+        PIN_SENSOR_1, PIN_SENSOR_2
+    };
+    static constexpr uint8_t ALL_PINS[] = {
+        PIN_RELAY_OPEN, PIN_RELAY_CLOSE, PIN_RELAY_STOP, PIN_LED_RED, PIN_LED_GREEN,
+        PIN_GATE_LIGHTS, PIN_GATE_LOCK, PIN_EXTERNAL_RELAY, PIN_PHOTO_EYE,
+        PIN_SENSOR_1, PIN_SENSOR_2
+    };
+    // Inputs configured with INPUT_PULLUP
+    static constexpr uint8_t PULLUP_PINS[] = {
+        PIN_GATE_LIGHTS, PIN_GATE_LOCK
+    };
+    // Inputs pulled up by a resistor on the board (NO_PIN: none)
+    static constexpr uint8_t EXTERNAL_PULLUP_PINS[] = {NO_PIN};
+};
+
+// ============================================================================
+// GATEGUARDIAN V1.1 WITH PEDESTRIAN GATE
+// ============================================================================
+/**
+ * Driveway gate on the main connector plus a pedestrian gate on the
+ * expansion header. NOT a drop-in v1.1 build: a v1.1 board has no free
+ * GPIO for the pedestrian relays that can drive an output and is neither
+ * a strapping nor a console pin. The pedestrian expansion rework moves
+ * the gate lock contact from GPIO 32 to GPIO 34 and fits a 10 kΩ pull-up
+ * for it (GPIO 34 has none), which frees GPIO 32 for the close relay.
+ * The pedestrian gate has no stop relay; STOP is ignored for it.
+ * Selected with -DBOARD_DUAL_GATE -DBOARD_HW_REV_PEDESTRIAN_EXPANSION.
+ */
+struct GateGuardianDualBoard : GateGuardianBoard {
+    static constexpr uint8_t PIN_PEDESTRIAN_RELAY_OPEN = 13;
+    static constexpr uint8_t PIN_PEDESTRIAN_RELAY_CLOSE = 32;
+    static constexpr uint8_t PIN_PEDESTRIAN_RELAY_STOP = NO_PIN;
+    static constexpr uint8_t PIN_PEDESTRIAN_SENSOR = 39;    // HIGH when closed
+
+    static constexpr uint8_t PIN_GATE_LOCK = 34;            // External pull-up on the rework
+
+    static constexpr uint8_t GATE_COUNT = 2;
+    static constexpr uint8_t GATE_RELAY_OPEN[GATE_COUNT] = {PIN_RELAY_OPEN, PIN_PEDESTRIAN_RELAY_OPEN};
+    static constexpr uint8_t GATE_RELAY_CLOSE[GATE_COUNT] = {PIN_RELAY_CLOSE, PIN_PEDESTRIAN_RELAY_CLOSE};
+    static constexpr uint8_t GATE_RELAY_STOP[GATE_COUNT] = {PIN_RELAY_STOP, PIN_PEDESTRIAN_RELAY_STOP};
+    static constexpr uint8_t GATE_POSITION_SENSOR[GATE_COUNT] = {PIN_POSITION_SENSOR, PIN_PEDESTRIAN_SENSOR};
+    static constexpr uint8_t GATE_MOTION_INPUT[GATE_COUNT] = {PIN_GATE_LIGHTS, NO_PIN};
+    static constexpr uint8_t GATE_LOCK_INPUT[GATE_COUNT] = {PIN_GATE_LOCK, NO_PIN};
+
+    static constexpr uint8_t OUTPUT_PINS[] = {
+        PIN_RELAY_OPEN, PIN_RELAY_CLOSE, PIN_RELAY_STOP, PIN_LED_RED, PIN_LED_GREEN,
+        PIN_PEDESTRIAN_RELAY_OPEN, PIN_PEDESTRIAN_RELAY_CLOSE
+    };
+    static constexpr uint8_t INPUT_PINS[] = {
+        PIN_GATE_LIGHTS, PIN_GATE_LOCK, PIN_EXTERNAL_RELAY, PIN_PHOTO_EYE,
+        PIN_SENSOR_1, PIN_PEDESTRIAN_SENSOR
+    };
+    static constexpr uint8_t ALL_PINS[] = {
+        PIN_RELAY_OPEN, PIN_RELAY_CLOSE, PIN_RELAY_STOP, PIN_LED_RED, PIN_LED_GREEN,
+        PIN_PEDESTRIAN_RELAY_OPEN, PIN_PEDESTRIAN_RELAY_CLOSE,
+        PIN_GATE_LIGHTS, PIN_GATE_LOCK, PIN_EXTERNAL_RELAY, PIN_PHOTO_EYE,
+        PIN_SENSOR_1, PIN_PEDESTRIAN_SENSOR
+    };
+    static constexpr uint8_t PULLUP_PINS[] = {
+        PIN_GATE_LIGHTS
+    };
+    static constexpr uint8_t EXTERNAL_PULLUP_PINS[] = {
+        PIN_GATE_LOCK
+    };
+
+    // Relays added by the expansion; checked below (the v1.1 relays on the
+    // GPIO 12 and 15 strapping pins are part of the existing hardware)
+    static constexpr uint8_t EXPANSION_OUTPUT_PINS[] = {
+        PIN_PEDESTRIAN_RELAY_OPEN, PIN_PEDESTRIAN_RELAY_CLOSE
+    };
+};
+
+static_assert(pincheck::noneStrapping(GateGuardianDualBoard::EXPANSION_OUTPUT_PINS),
+              "Pedestrian relays must not use strapping or console GPIOs");
+
+#if !defined(ARDUINO_ARCH_ESP32)
+// ============================================================================
+// HOST BENCHMARK BOARD
+// ============================================================================
+/**
+ * Synthetic three-gate layout for measuring how the gate update scales
+ * with the gate count. Not wireable: no ESP32 board has nine relay GPIOs
+ * clear of the strapping and console pins (only 4, 13, 14, 17, 32 and 33
+ * are), so the relays here take GPIO 1, 2, 3, 12 and 15 as well. It skips
+ * the strapping and console checks the real boards assert and exists in
+ * the host build only.
+ */
+struct HostSyntheticTripleGateBoard : GateGuardianDualBoard {
+    static constexpr uint8_t GATE_COUNT = 3;
+    static constexpr uint8_t GATE_RELAY_OPEN[GATE_COUNT] = {15, 13, 4};
+    static constexpr uint8_t GATE_RELAY_CLOSE[GATE_COUNT] = {12, 2, 1};
+    static constexpr uint8_t GATE_RELAY_STOP[GATE_COUNT] = {14, 32, 3};
+    static constexpr uint8_t GATE_POSITION_SENSOR[GATE_COUNT] = {35, 39, 37};
+    static constexpr uint8_t GATE_MOTION_INPUT[GATE_COUNT] = {33, NO_PIN, NO_PIN};
+    static constexpr uint8_t GATE_LOCK_INPUT[GATE_COUNT] = {NO_PIN, NO_PIN, NO_PIN};
+
+    static constexpr uint8_t OUTPUT_PINS[] = {17, 5, 15, 13, 4, 12, 2, 1, 14, 32, 3};
+    static constexpr uint8_t INPUT_PINS[] = {33, 35, 39, 37};
+    static constexpr uint8_t ALL_PINS[] = {17, 5, 15, 13, 4, 12, 2, 1, 14, 32, 3, 33, 35, 39, 37};
+    static constexpr uint8_t PULLUP_PINS[] = {33};
+};
+#endif
+
+/**
+ * Compile-time checks every board policy must pass
+ * Instantiated by the Gate template for the policy it is built with.
+ */
+template <typename Policy>
+struct BoardPolicyCheck {
+    static_assert(pincheck::allDistinct(Policy::ALL_PINS),
+                  "Board policy assigns the same GPIO to two functions");
+    static_assert(sizeof(Policy::ALL_PINS) == sizeof(Policy::OUTPUT_PINS) + sizeof(Policy::INPUT_PINS),
+                  "Board policy ALL_PINS must list every output and input pin");
+    static_assert(pincheck::allUsable(Policy::ALL_PINS),
+                  "Board policy uses a flash, Ethernet or nonexistent GPIO");
+    static_assert(pincheck::noneInputOnly(Policy::OUTPUT_PINS),
+                  "Board policy drives an input-only GPIO (34-39)");
+    static_assert(pincheck::noneInputOnly(Policy::PULLUP_PINS),
+                  "Board policy enables a pull-up on an input-only GPIO (34-39)");
+    static_assert(pincheck::allListedInEither(Policy::GATE_MOTION_INPUT, Policy::PULLUP_PINS,
+                                              Policy::EXTERNAL_PULLUP_PINS) &&
+                  pincheck::allListedInEither(Policy::GATE_LOCK_INPUT, Policy::PULLUP_PINS,
+                                              Policy::EXTERNAL_PULLUP_PINS),
+                  "Board policy active-LOW motion and lock inputs need an internal or external pull-up");
+    static_assert(Policy::RELAY_PULSE_MS > 0 && Policy::RELAY_PULSE_MS < Policy::OPERATION_TIME_MS,
+                  "Relay pulse must be shorter than the gate operation time");
+    static_assert(Policy::MOVING_POLL_MS > 0 && Policy::MOVING_POLL_MS <= Policy::IDLE_POLL_MS,
+                  "Moving poll period must be positive and no slower than idle");
+    static_assert(Policy::GATE_COUNT >= 1 && Policy::GATE_COUNT <= 32,
+                  "Board policy must drive 1 to 32 gates (per-gate flags are 32-bit masks)");
+    static_assert(pincheck::allListed(Policy::GATE_RELAY_OPEN, Policy::OUTPUT_PINS) &&
+                  pincheck::allListed(Policy::GATE_RELAY_CLOSE, Policy::OUTPUT_PINS) &&
+                  pincheck::allListedOrNone(Policy::GATE_RELAY_STOP, Policy::OUTPUT_PINS),
+                  "Board policy gate relays must be listed in OUTPUT_PINS (stop may be NO_PIN)");
+    static_assert(pincheck::allListed(Policy::GATE_POSITION_SENSOR, Policy::INPUT_PINS),
+                  "Board policy gate position sensors must be listed in INPUT_PINS");
+    static_assert(pincheck::allListedOrNone(Policy::GATE_MOTION_INPUT, Policy::INPUT_PINS) &&
+                  pincheck::allListedOrNone(Policy::GATE_LOCK_INPUT, Policy::INPUT_PINS),
+                  "Board policy gate motion and lock inputs must be listed in INPUT_PINS or be NO_PIN");
+    static_assert(Policy::MOTION_HOLD_MS > Policy::SENSOR_DEBOUNCE_US / 1000,
+                  "Motion hold must outlast the sensor debounce so a close ends on the sensor");
+    static constexpr bool ok = true;
+};
+
+// Board the firmware is built for (-DBOARD_DUAL_GATE for the pedestrian gate,
+// which also needs the hardware revision flag)
+#if defined(BOARD_DUAL_GATE)
+#if !defined(BOARD_HW_REV_PEDESTRIAN_EXPANSION)
+#error "BOARD_DUAL_GATE needs the pedestrian expansion rework (gate lock moved to GPIO 34 with a pull-up); define BOARD_HW_REV_PEDESTRIAN_EXPANSION for that board"
+#endif
+typedef GateGuardianDualBoard BoardPolicy;
+#else
+typedef GateGuardianBoard BoardPolicy;
+#endif
+
+#endif // BoardPolicy_h
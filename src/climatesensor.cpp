@@ -0,0 +1,264 @@
+/**
+ * ClimateSensor.cpp - ESP32 Swing Gate Controller DHT22 climate sensor
+ *
+ * Implementation of the RMT capture, the reading steps and the frame decoder.
+ */
+
+#include "climatesensor.h"
+#include "logger.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <driver/gpio.h>
+#endif
+
+namespace {
+
+// Data bit high time: 26-28 us for a 0, 70 us for a 1
+const uint16_t BIT_ONE_MIN_US = 48;
+// Longer highs are not part of a frame (idle line before the start signal)
+const uint16_t FRAME_PULSE_MAX_US = 100;
+
+} // namespace
+
+const char* climateStatusName(ClimateStatus status) {
+    switch (status) {
+        case CLIMATE_PENDING:     return "PENDING";
+        case CLIMATE_OK:          return "OK";
+        case CLIMATE_TIMEOUT:     return "TIMEOUT";
+        case CLIMATE_CHECKSUM:    return "CHECKSUM";
+        case CLIMATE_UNAVAILABLE: return "UNAVAILABLE";
+        default:                  return "INVALID";
+    }
+}
+
+// ============================================================================
+// CLIMATE SENSOR CLASS IMPLEMENTATION
+// ============================================================================
+
+ClimateSensor::ClimateSensor(Scheduler& scheduler, uint8_t pin)
+    : _scheduler(scheduler),
+      _pin(pin),
+      _intervalMs(MIN_INTERVAL_MS),
+      _stepId(NO_SCHEDULE),
+      _periodicId(NO_SCHEDULE),
+      _temperature(0),
+      _humidity(0),
+      _readAtMs(0),
+      _hasReading(false),
+      _status(CLIMATE_PENDING),
+      _callback(nullptr),
+      _callbackContext(nullptr)
+#if defined(ARDUINO_ARCH_ESP32)
+      , _channel(nullptr),
+      _received(0)
+#endif
+{
+}
+
+ClimateSensor::~ClimateSensor() {
+    _scheduler.cancel(_stepId);
+    _scheduler.cancel(_periodicId);
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_channel) {
+        rmt_disable(_channel);
+        rmt_del_channel(_channel);
+    }
+#endif
+}
+
+bool ClimateSensor::begin(uint32_t intervalMs) {
+    _intervalMs = intervalMs < MIN_INTERVAL_MS ? MIN_INTERVAL_MS : intervalMs;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // 1 us ticks: the frame's pulses are 26-80 us
+    rmt_rx_channel_config_t channelConfig = {};
+    channelConfig.gpio_num = (gpio_num_t)_pin;
+    channelConfig.clk_src = RMT_CLK_SRC_DEFAULT;
+    channelConfig.resolution_hz = 1000000;
+    channelConfig.mem_block_symbols = SYMBOL_COUNT;
+
+    rmt_rx_event_callbacks_t callbacks = {};
+    callbacks.on_recv_done = _onReceiveDone;
+
+    if (rmt_new_rx_channel(&channelConfig, &_channel) != ESP_OK) {
+        _channel = nullptr;
+    } else if (rmt_rx_register_event_callbacks(_channel, &callbacks, this) != ESP_OK ||
+               rmt_enable(_channel) != ESP_OK) {
+        rmt_del_channel(_channel);
+        _channel = nullptr;
+    }
+    if (!_channel) {
+        _status = CLIMATE_UNAVAILABLE;
+        Serial.println("[ERROR] No RMT channel for the DHT22 - climate readings disabled");
+        return false;
+    }
+
+    // The RMT keeps the pin's input; the start signal drives it open drain
+    gpio_set_direction((gpio_num_t)_pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_pullup_en((gpio_num_t)_pin);
+    gpio_set_level((gpio_num_t)_pin, 1);
+
+    _scheduler.in(WARMUP_MS, _startHandler, this);
+    _periodicId = _scheduler.every(_intervalMs, _startHandler, this);
+
+    Serial.print("[CLIMATE] DHT22 on pin ");
+    Serial.print(_pin);
+    Serial.print(" read every ");
+    Serial.print(_intervalMs);
+    Serial.println(" ms");
+    return true;
+#else
+    // Host: no RMT peripheral to capture the reply with
+    _status = CLIMATE_UNAVAILABLE;
+    Serial.println("[ERROR] No RMT channel for the DHT22 - climate readings disabled");
+    return false;
+#endif
+}
+
+void ClimateSensor::setCallback(ClimateCallback callback, void* context) {
+    _callback = callback;
+    _callbackContext = context;
+}
+
+ClimateReading ClimateSensor::reading() const {
+    ClimateReading reading;
+    reading.valid = _hasReading && millis() - _readAtMs < _intervalMs * STALE_INTERVALS;
+    reading.temperature = _temperature;
+    reading.humidity = _humidity;
+    reading.readAtMs = _readAtMs;
+    reading.status = _status;
+    return reading;
+}
+
+ClimateStatus ClimateSensor::decodeFrame(const uint16_t* highUs, size_t count,
+                                         float& temperature, float& humidity) {
+    // Walk back from the end collecting the last FRAME_BITS frame pulses
+    uint8_t bytes[FRAME_BITS / 8] = {};
+    size_t bits = 0;
+    for (size_t i = count; i > 0 && bits < FRAME_BITS; i--) {
+        uint16_t high = highUs[i - 1];
+        if (high == 0 || high > FRAME_PULSE_MAX_US) {
+            continue;
+        }
+        size_t bit = FRAME_BITS - 1 - bits;
+        if (high >= BIT_ONE_MIN_US) {
+            bytes[bit / 8] |= 0x80 >> (bit % 8);
+        }
+        bits++;
+    }
+    if (bits < FRAME_BITS) {
+        return CLIMATE_TIMEOUT;
+    }
+    if ((uint8_t)(bytes[0] + bytes[1] + bytes[2] + bytes[3]) != bytes[4]) {
+        return CLIMATE_CHECKSUM;
+    }
+
+    // Tenths of a percent and tenths of a degree, sign in the top bit
+    humidity = ((bytes[0] << 8) | bytes[1]) * 0.1f;
+    temperature = (((bytes[2] & 0x7F) << 8) | bytes[3]) * 0.1f;
+    if (bytes[2] & 0x80) {
+        temperature = -temperature;
+    }
+    return CLIMATE_OK;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+void ClimateSensor::_start() {
+    if (_scheduler.isScheduled(_stepId)) {
+        return; // Previous reading still in progress
+    }
+#if defined(ARDUINO_ARCH_ESP32)
+    gpio_set_level((gpio_num_t)_pin, 0);
+    _stepId = _scheduler.in(START_LOW_MS, _releaseHandler, this);
+#endif
+}
+
+void ClimateSensor::_release() {
+#if defined(ARDUINO_ARCH_ESP32)
+    // Arm the receiver before releasing the line: the reply starts 20-40 us
+    // after the release. Reception ends once the line is idle longer than
+    // any pulse of the frame.
+    rmt_receive_config_t receiveConfig = {};
+    receiveConfig.signal_range_min_ns = 1000;
+    receiveConfig.signal_range_max_ns = 200000;
+    _received.store(0, std::memory_order_relaxed);
+    esp_err_t result = rmt_receive(_channel, _symbols, sizeof(_symbols), &receiveConfig);
+    gpio_set_level((gpio_num_t)_pin, 1);
+    if (result != ESP_OK) {
+        _complete(CLIMATE_TIMEOUT, 0, 0);
+        return;
+    }
+    _stepId = _scheduler.in(FRAME_MS, _finishHandler, this);
+#endif
+}
+
+void ClimateSensor::_finish() {
+#if defined(ARDUINO_ARCH_ESP32)
+    size_t received = _received.load(std::memory_order_acquire);
+    if (received == 0) {
+        // Still waiting for an edge: restart the channel so the next
+        // reading does not find a receive in progress
+        rmt_disable(_channel);
+        rmt_enable(_channel);
+        _complete(CLIMATE_TIMEOUT, 0, 0);
+        return;
+    }
+
+    uint16_t highs[SYMBOL_COUNT * 2];
+    size_t count = 0;
+    for (size_t i = 0; i < received && i < SYMBOL_COUNT; i++) {
+        if (_symbols[i].level0) highs[count++] = _symbols[i].duration0;
+        if (_symbols[i].level1) highs[count++] = _symbols[i].duration1;
+    }
+    float temperature = 0, humidity = 0;
+    ClimateStatus status = decodeFrame(highs, count, temperature, humidity);
+    _complete(status, temperature, humidity);
+#endif
+}
+
+void ClimateSensor::_complete(ClimateStatus status, float temperature, float humidity) {
+    if (status == CLIMATE_OK) {
+        _temperature = temperature;
+        _humidity = humidity;
+        _readAtMs = millis();
+        _hasReading = true;
+    } else if (status != _status) {
+        LOG_WARN("[CLIMATE] DHT22 reading failed: %s", climateStatusName(status));
+    }
+    _status = status;
+
+    if (_callback) {
+        _callback(reading(), _callbackContext);
+    }
+}
+
+bool ClimateSensor::_startHandler(void* sensor) {
+    static_cast<ClimateSensor*>(sensor)->_start();
+    return true; // Periodic; the one-shot warm-up reading ignores this
+}
+
+bool ClimateSensor::_releaseHandler(void* sensor) {
+    ClimateSensor* self = static_cast<ClimateSensor*>(sensor);
+    self->_stepId = NO_SCHEDULE;
+    self->_release();
+    return false;
+}
+
+bool ClimateSensor::_finishHandler(void* sensor) {
+    ClimateSensor* self = static_cast<ClimateSensor*>(sensor);
+    self->_stepId = NO_SCHEDULE;
+    self->_finish();
+    return false;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool IRAM_ATTR ClimateSensor::_onReceiveDone(rmt_channel_handle_t channel,
+                                             const rmt_rx_done_event_data_t* event, void* context) {
+    ClimateSensor* self = static_cast<ClimateSensor*>(context);
+    self->_received.store(event->num_symbols ? event->num_symbols : 1, std::memory_order_release);
+    return false;   // No task woken; the finish step polls
+}
+#endif
@@ -0,0 +1,145 @@
+/**
+ * ClimateSensor.h - ESP32 Swing Gate Controller DHT22 climate sensor
+ *
+ * Reads the DHT22 without blocking any task. A reading is a short state
+ * machine on the owning task's scheduler: the data line is pulled low for
+ * START_LOW_MS, then released while the RMT peripheral records the
+ * sensor's reply in hardware, and the frame is decoded FRAME_MS later.
+ * No interrupt is disabled and nothing waits on the sensor, unlike the
+ * bit-banged DHT libraries that mask interrupts for the ~5 ms transfer.
+ *
+ * Readings are cached: callers take the latest one with reading(), or get
+ * it pushed through the completion callback. A reading is reported stale
+ * (invalid) once STALE_INTERVALS read intervals pass without a good frame.
+ */
+
+#ifndef ClimateSensor_h
+#define ClimateSensor_h
+
+#include "Arduino.h"
+#include "scheduler.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <atomic>
+#include <driver/rmt_rx.h>
+#endif
+
+// Outcome of the latest acquisition
+enum ClimateStatus : uint8_t {
+    CLIMATE_PENDING,        // No acquisition finished yet
+    CLIMATE_OK,
+    CLIMATE_TIMEOUT,        // No complete frame (sensor missing or not answering)
+    CLIMATE_CHECKSUM,       // Frame received but corrupted
+    CLIMATE_UNAVAILABLE     // The RMT channel could not be set up
+};
+
+/**
+ * Get status name for logging without allocating
+ */
+const char* climateStatusName(ClimateStatus status);
+
+// ============================================================================
+// CLIMATE READING
+// ============================================================================
+struct ClimateReading {
+    bool valid;             // A good reading younger than the stale limit
+    float temperature;      // Degrees Celsius
+    float humidity;         // Relative humidity in percent
+    uint32_t readAtMs;      // millis() of the reading
+    ClimateStatus status;   // Outcome of the latest acquisition
+};
+
+/**
+ * Called on the owning task after every acquisition, good or not
+ * @param reading Cached reading (status tells whether this one succeeded)
+ * @param context Opaque pointer given at registration
+ */
+typedef void (*ClimateCallback)(const ClimateReading& reading, void* context);
+
+// ============================================================================
+// CLIMATE SENSOR CLASS DECLARATION
+// ============================================================================
+class ClimateSensor {
+public:
+    static const uint32_t WARMUP_MS = 2000;         // First reading after power-up
+    static const uint32_t MIN_INTERVAL_MS = 2000;   // DHT22 sampling limit
+    static const uint32_t START_LOW_MS = 2;         // Start signal (datasheet: at least 1 ms)
+    static const uint32_t FRAME_MS = 10;            // Reply takes about 5 ms
+    static const uint8_t STALE_INTERVALS = 3;
+    static const size_t FRAME_BITS = 40;
+
+    /**
+     * Constructor
+     * @param scheduler Scheduler of the task that owns the sensor
+     * @param pin DHT22 data pin (open drain, pulled up)
+     */
+    ClimateSensor(Scheduler& scheduler, uint8_t pin);
+
+    ~ClimateSensor();
+
+    /**
+     * Set up the RMT receiver and start periodic readings
+     * @param intervalMs Time between readings (at least MIN_INTERVAL_MS)
+     * @return false if the RMT channel could not be set up
+     */
+    bool begin(uint32_t intervalMs);
+
+    /**
+     * Register the completion callback
+     * @param callback Callback, or nullptr to remove
+     * @param context Passed to the callback
+     */
+    void setCallback(ClimateCallback callback, void* context);
+
+    /**
+     * Latest cached reading; never touches the sensor
+     */
+    ClimateReading reading() const;
+
+    /**
+     * Decode the 40-bit DHT22 frame from the durations of the line's high
+     * pulses (microseconds, in order); only the last FRAME_BITS count, so
+     * the sensor's response pulse ahead of the data may be included
+     * @return CLIMATE_OK, CLIMATE_TIMEOUT if too few bits, or CLIMATE_CHECKSUM
+     */
+    static ClimateStatus decodeFrame(const uint16_t* highUs, size_t count,
+                                     float& temperature, float& humidity);
+
+private:
+    Scheduler& _scheduler;
+    uint8_t _pin;
+    uint32_t _intervalMs;
+    ScheduleId _stepId;             // Pending release/finish step of a reading
+    ScheduleId _periodicId;         // Periodic start of a reading
+
+    float _temperature;
+    float _humidity;
+    uint32_t _readAtMs;
+    bool _hasReading;
+    ClimateStatus _status;
+
+    ClimateCallback _callback;
+    void* _callbackContext;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    static const size_t SYMBOL_COUNT = 64;  // One RMT memory block
+
+    rmt_channel_handle_t _channel;
+    rmt_symbol_word_t _symbols[SYMBOL_COUNT];
+    std::atomic<size_t> _received;          // Symbols of the finished frame (ISR -> task)
+
+    static bool IRAM_ATTR _onReceiveDone(rmt_channel_handle_t channel,
+                                         const rmt_rx_done_event_data_t* event, void* context);
+#endif
+
+    void _start();
+    void _release();
+    void _finish();
+    void _complete(ClimateStatus status, float temperature, float humidity);
+
+    static bool _startHandler(void* sensor);
+    static bool _releaseHandler(void* sensor);
+    static bool _finishHandler(void* sensor);
+};
+
+#endif // ClimateSensor_h
@@ -0,0 +1,93 @@
+/**
+ * CommandParser.cpp - ESP32 Swing Gate Controller command parser
+ *
+ * Implementation of the in-place keyword match and the shared dispatcher.
+ */
+
+#include "commandparser.h"
+
+namespace {
+
+// Hash slot -> keyword index + 1 (0 = empty), built once from the keyword table
+struct CommandHashTable {
+    uint8_t slots[COMMAND_HASH_SIZE];
+
+    constexpr CommandHashTable() : slots() {
+        for (size_t i = 0; i < COMMAND_KEYWORD_COUNT; i++) {
+            slots[commandHash(COMMAND_KEYWORDS[i].text[0], COMMAND_KEYWORDS[i].length)] = i + 1;
+        }
+    }
+};
+
+constexpr CommandHashTable COMMAND_HASH_TABLE;
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+} // namespace
+
+bool parseGateCommand(const char* text, size_t length, GateCommand& command) {
+    // Trim by moving the bounds, not the data
+    while (length > 0 && isSpace(*text)) {
+        text++;
+        length--;
+    }
+    while (length > 0 && isSpace(text[length - 1])) {
+        length--;
+    }
+    if (length == 0) {
+        return false;
+    }
+
+    uint8_t slot = COMMAND_HASH_TABLE.slots[commandHash(text[0], length)];
+    if (slot == 0) {
+        return false;
+    }
+
+    const CommandKeyword& keyword = COMMAND_KEYWORDS[slot - 1];
+    if (keyword.length != length) {
+        return false;
+    }
+    // Keywords are lower-case letters: OR-ing 0x20 folds ASCII case
+    for (size_t i = 0; i < length; i++) {
+        if ((char)(text[i] | 0x20) != keyword.text[i]) {
+            return false;
+        }
+    }
+
+    command = keyword.command;
+    return true;
+}
+
+bool parseGateIndex(const char* text, size_t length, uint8_t& gate) {
+    if (length == 0 || length > 2) {
+        return false;
+    }
+    unsigned value = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    if (value >= Gate::GATE_COUNT) {
+        return false;
+    }
+    gate = (uint8_t)value;
+    return true;
+}
+
+CommandResult dispatchGateCommand(ControlTask* controlTask, const char* text, size_t length,
+                                  CommandSource source, uint8_t gate, GateCommand& command) {
+    if (!parseGateCommand(text, length, command)) {
+        return COMMAND_UNKNOWN;
+    }
+    if (gate >= Gate::GATE_COUNT) {
+        return COMMAND_UNKNOWN_GATE;
+    }
+    if (!controlTask || !controlTask->postCommand(command, source, gate)) {
+        return COMMAND_QUEUE_FULL;
+    }
+    return COMMAND_QUEUED;
+}
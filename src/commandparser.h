@@ -0,0 +1,98 @@
+/**
+ * CommandParser.h - ESP32 Swing Gate Controller command parser
+ *
+ * Parses gate commands in place (MQTT payload bytes or an HTTP path
+ * segment) without copying, upper-casing or allocating. Keywords are found
+ * with a perfect hash over (first letter, length) that is checked at
+ * compile time, then confirmed with one case-insensitive compare.
+ *
+ * dispatchGateCommand() is the single entry point used by both the MQTT
+ * command topic(s) and the HTTP /gate/[<index>/]<command> routes.
+ */
+
+#ifndef CommandParser_h
+#define CommandParser_h
+
+#include "Arduino.h"
+#include "controltask.h"
+
+// ============================================================================
+// KEYWORD TABLE
+// ============================================================================
+struct CommandKeyword {
+    const char* text;       // Lower-case keyword (also the HTTP route name)
+    uint8_t length;
+    GateCommand command;
+};
+
+constexpr CommandKeyword COMMAND_KEYWORDS[] = {
+    {"open",   4, GATE_COMMAND_OPEN},
+    {"close",  5, GATE_COMMAND_CLOSE},
+    {"stop",   4, GATE_COMMAND_STOP},
+    {"toggle", 6, GATE_COMMAND_TOGGLE},
+};
+constexpr size_t COMMAND_KEYWORD_COUNT = sizeof(COMMAND_KEYWORDS) / sizeof(COMMAND_KEYWORDS[0]);
+
+// Slots in the hash table (power of two)
+constexpr uint8_t COMMAND_HASH_SIZE = 8;
+
+/**
+ * Perfect hash of a keyword candidate
+ * @param first First character, either case
+ * @param length Candidate length
+ */
+constexpr uint8_t commandHash(char first, size_t length) {
+    return ((uint8_t)(first | 0x20) ^ (uint8_t)length) & (COMMAND_HASH_SIZE - 1);
+}
+
+constexpr bool commandHashIsPerfect(size_t i = 0, size_t j = 1) {
+    return i + 1 >= COMMAND_KEYWORD_COUNT ? true
+         : j >= COMMAND_KEYWORD_COUNT ? commandHashIsPerfect(i + 1, i + 2)
+         : commandHash(COMMAND_KEYWORDS[i].text[0], COMMAND_KEYWORDS[i].length) !=
+               commandHash(COMMAND_KEYWORDS[j].text[0], COMMAND_KEYWORDS[j].length) &&
+           commandHashIsPerfect(i, j + 1);
+}
+
+static_assert(commandHashIsPerfect(), "Command keywords collide in the hash; change commandHash()");
+
+// ============================================================================
+// PARSER AND DISPATCHER
+// ============================================================================
+enum CommandResult : uint8_t {
+    COMMAND_QUEUED,         // Posted to the control task
+    COMMAND_UNKNOWN,        // Not a gate command
+    COMMAND_QUEUE_FULL,     // Valid, but the command queue was full
+    COMMAND_UNKNOWN_GATE    // Gate index out of range
+};
+
+/**
+ * Parse a command keyword, ignoring case and surrounding whitespace
+ * @param text Command bytes (need not be NUL-terminated)
+ * @param length Number of bytes
+ * @param command Receives the command
+ * @return false if the text is not a command
+ */
+bool parseGateCommand(const char* text, size_t length, GateCommand& command);
+
+/**
+ * Parse a gate index (decimal digits, e.g. a topic or path segment)
+ * @param text Index bytes (need not be NUL-terminated)
+ * @param length Number of bytes
+ * @param gate Receives the index
+ * @return false if the text is not a number below Gate::GATE_COUNT
+ */
+bool parseGateIndex(const char* text, size_t length, uint8_t& gate);
+
+/**
+ * Parse a command and post it to the control task
+ * @param controlTask Command queue owner
+ * @param text Command bytes (need not be NUL-terminated)
+ * @param length Number of bytes
+ * @param source Origin of the command
+ * @param gate Gate the command is for
+ * @param command Receives the parsed command (valid unless COMMAND_UNKNOWN)
+ */
+CommandResult dispatchGateCommand(ControlTask* controlTask, const char* text, size_t length,
+                                  CommandSource source, uint8_t gate, GateCommand& command);
+
+#endif // CommandParser_h
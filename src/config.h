@@ -8,6 +8,12 @@
 #error Need to define OTA_PASSWORD
 #endif
 
+// Port of the ElegantOTA update page (/update); the status and command
+// routes are served on port 80
+#ifndef OTA_HTTP_PORT
+#define OTA_HTTP_PORT 8080
+#endif
+
 // MQTT broker
 #ifndef MQTT_BROKER
 #define MQTT_BROKER "broker.hivemq.com"
@@ -23,3 +29,104 @@
 #ifndef MQTT_TOPIC_COMMAND
 #define MQTT_TOPIC_COMMAND "gateguardian/command3"
 #endif
+
+// MQTT status publishing
+// Status is published on every gate state change; the heartbeat republishes
+// it when nothing changed for this many milliseconds
+#ifndef MQTT_HEARTBEAT_INTERVAL
+#define MQTT_HEARTBEAT_INTERVAL 60000
+#endif
+// Changes within this many milliseconds of the last publish are coalesced
+#ifndef MQTT_PUBLISH_HOLDOFF
+#define MQTT_PUBLISH_HOLDOFF 250
+#endif
+// Status payload encoding: STATUS_FORMAT_JSON or STATUS_FORMAT_CBOR (compact
+// binary map, layout in statusserializer.h)
+#ifndef MQTT_STATUS_FORMAT
+#define MQTT_STATUS_FORMAT STATUS_FORMAT_JSON
+#endif
+// Status message QoS: 1 retries each message until the broker acknowledges
+// it (MqttOutbox::MAX_ATTEMPTS sends at most), 0 sends it once
+#ifndef MQTT_STATUS_QOS
+#define MQTT_STATUS_QOS 1
+#endif
+// Status is retained by the broker, so a new subscriber gets the current
+// state of every gate right away (0 disables)
+#ifndef MQTT_STATUS_RETAIN
+#define MQTT_STATUS_RETAIN 1
+#endif
+
+// MQTT availability
+// MQTT_PAYLOAD_ONLINE is published on every connect (birth message); the
+// broker publishes MQTT_PAYLOAD_OFFLINE, registered as the Last Will, when
+// the device drops off without disconnecting. An empty topic disables both
+#ifndef MQTT_TOPIC_AVAILABILITY
+#define MQTT_TOPIC_AVAILABILITY "gateguardian/availability3"
+#endif
+#ifndef MQTT_PAYLOAD_ONLINE
+#define MQTT_PAYLOAD_ONLINE "online"
+#endif
+#ifndef MQTT_PAYLOAD_OFFLINE
+#define MQTT_PAYLOAD_OFFLINE "offline"
+#endif
+// Availability messages are retained, so a new subscriber learns liveness
+// without waiting for a change (0 disables)
+#ifndef MQTT_AVAILABILITY_RETAIN
+#define MQTT_AVAILABILITY_RETAIN 1
+#endif
+
+// Task layout
+// Gate and LEDs run in a high-priority task pinned to the application core;
+// web server, OTA and MQTT run in a separate task on the protocol core next
+// to the Ethernet/WiFi driver tasks
+#ifndef CONTROL_TASK_CORE
+#define CONTROL_TASK_CORE 1
+#endif
+#ifndef CONTROL_TASK_PRIORITY
+#define CONTROL_TASK_PRIORITY 10
+#endif
+#ifndef NETWORK_TASK_CORE
+#define NETWORK_TASK_CORE 0
+#endif
+#ifndef NETWORK_TASK_PRIORITY
+#define NETWORK_TASK_PRIORITY 1
+#endif
+// Both tasks sleep until their next deadline or a wake-up notification.
+// The network task additionally wakes at least this often to poll sockets
+// (the HTTP server, OTA server and PubSubClient have no readiness notification)
+#ifndef NETWORK_TASK_MAX_WAIT_MS
+#define NETWORK_TASK_MAX_WAIT_MS 10
+#endif
+#ifndef NETWORK_TASK_STACK_SIZE
+#define NETWORK_TASK_STACK_SIZE 8192
+#endif
+
+// Log records are formatted and written by a low-priority task; the gate
+// and network tasks only queue them (levels are filtered with LOG_LEVEL)
+#ifndef LOG_TASK_CORE
+#define LOG_TASK_CORE 1
+#endif
+#ifndef LOG_TASK_PRIORITY
+#define LOG_TASK_PRIORITY 1
+#endif
+// Log lines are also sent to one TCP client on this port (0 = Serial only)
+#ifndef LOG_TCP_PORT
+#define LOG_TCP_PORT 2323
+#endif
+
+// Discrete input sampling period; an input level is accepted after four
+// consecutive equal samples (InputScanner::SAMPLES_TO_ACCEPT)
+#ifndef INPUT_SCAN_INTERVAL_MS
+#define INPUT_SCAN_INTERVAL_MS 2
+#endif
+
+// Photo-eye pass durations are drained from the edge capture this often;
+// the pass count itself is kept by the pulse counter in between
+#ifndef PASS_COUNTER_INTERVAL_MS
+#define PASS_COUNTER_INTERVAL_MS 250
+#endif
+
+// DHT22 reading period (the sensor allows one reading every 2 s)
+#ifndef CLIMATE_READ_INTERVAL_MS
+#define CLIMATE_READ_INTERVAL_MS 10000
+#endif
@@ -0,0 +1,278 @@
+/**
+ * ControlTask.cpp - ESP32 Swing Gate Controller real-time control task
+ *
+ * Implementation of the control loop and its queue hand-off. The state
+ * queue only ever needs the latest snapshot to be delivered: when it is
+ * full, the snapshot is kept and retried on the next iteration instead of
+ * being lost.
+ */
+
+#include "controltask.h"
+#include "logger.h"
+
+const char* gateCommandName(GateCommand command) {
+    switch (command) {
+        case GATE_COMMAND_OPEN:   return "OPEN";
+        case GATE_COMMAND_CLOSE:  return "CLOSE";
+        case GATE_COMMAND_STOP:   return "STOP";
+        case GATE_COMMAND_TOGGLE: return "TOGGLE";
+        default:                  return "INVALID";
+    }
+}
+
+const char* commandSourceName(CommandSource source) {
+    switch (source) {
+        case COMMAND_SOURCE_GATE: return "gate";
+        case COMMAND_SOURCE_MQTT: return "mqtt";
+        case COMMAND_SOURCE_HTTP: return "http";
+        default:                  return "invalid";
+    }
+}
+
+// ============================================================================
+// CONTROL TASK CLASS IMPLEMENTATION
+// ============================================================================
+
+ControlTask::ControlTask(Scheduler* scheduler, Gate* gate, LEDManager* ledManager)
+    : _scheduler(scheduler), _gate(gate), _ledManager(ledManager), _droppedCommands(0),
+      _droppedTransitions(0), _wakePending(false), _activeSource(COMMAND_SOURCE_GATE),
+      _snapshotPending(0), _gateMetrics(nullptr),
+      _timerMetrics(nullptr), _stateListener(nullptr), _stateListenerContext(nullptr) {
+    for (uint8_t gate = 0; gate < Gate::GATE_COUNT; gate++) {
+        _latest[gate].gate = gate;
+        _latest[gate].state = GATE_UNKNOWN;
+        _latest[gate].sensorState = false;
+        _latest[gate].timestamp = 0;
+    }
+#if defined(ARDUINO_ARCH_ESP32)
+    _taskHandle = nullptr;
+#endif
+}
+
+void ControlTask::begin() {
+    if (_gate) {
+        _gate->onStateChange(_onStateChange, this);
+        _gate->onSensorEdge(wakeFromIsr, this);
+    }
+    for (uint8_t gate = 0; gate < Gate::GATE_COUNT; gate++) {
+        _captureSnapshot(gate);
+    }
+    if (_ledManager) {
+        _ledManager->setStatus(_latest[0].state);
+    }
+    Serial.println("[CONTROL] Control loop ready");
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool ControlTask::start(uint8_t core, uint8_t priority) {
+    BaseType_t result = xTaskCreatePinnedToCore(_taskEntry, "gate-control", STACK_SIZE,
+                                                this, priority, &_taskHandle, core);
+    if (result != pdPASS) {
+        Serial.println("[ERROR] Failed to create gate control task");
+        return false;
+    }
+
+    Serial.print("[CONTROL] Control task started on core ");
+    Serial.print(core);
+    Serial.print(", priority ");
+    Serial.println(priority);
+    return true;
+}
+
+void ControlTask::_taskEntry(void* argument) {
+    ControlTask* self = static_cast<ControlTask*>(argument);
+
+    for (;;) {
+        uint32_t waitMs = self->runOnce();
+
+        // Sleep until the next deadline; a notification cuts it short.
+        // Waking a tick early is harmless: runOnce() just returns the rest.
+        TickType_t waitTicks = waitMs == SCHEDULE_IDLE ? portMAX_DELAY : pdMS_TO_TICKS(waitMs);
+        ulTaskNotifyTake(pdTRUE, waitTicks);
+    }
+}
+#endif
+
+void ControlTask::wake() {
+    _wakePending.store(true, std::memory_order_release);
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_taskHandle) {
+        xTaskNotifyGive(_taskHandle);
+    }
+#endif
+}
+
+void IRAM_ATTR ControlTask::wakeFromIsr(void* controlTask) {
+    ControlTask* self = static_cast<ControlTask*>(controlTask);
+    self->_wakePending.store(true, std::memory_order_release);
+#if defined(ARDUINO_ARCH_ESP32)
+    if (self->_taskHandle) {
+        BaseType_t higherPriorityWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(self->_taskHandle, &higherPriorityWoken);
+        portYIELD_FROM_ISR(higherPriorityWoken);
+    }
+#endif
+}
+
+bool ControlTask::wakePending() const {
+    return _wakePending.load(std::memory_order_acquire);
+}
+
+void ControlTask::setStateListener(StateListener listener, void* context) {
+    _stateListenerContext = context;
+    _stateListener = listener;
+}
+
+void ControlTask::setMetrics(Metrics* metrics) {
+    _gateMetrics = metrics ? metrics->subsystem(SUBSYSTEM_GATE) : nullptr;
+    _timerMetrics = metrics ? metrics->subsystem(SUBSYSTEM_CONTROL_TIMERS) : nullptr;
+}
+
+uint32_t ControlTask::runOnce() {
+    _loopHistogram.tick();
+    _wakePending.store(false, std::memory_order_relaxed);
+
+    GateRequest request;
+    while (_commands.pop(request)) {
+        _executeCommand(request);
+    }
+
+    uint32_t waitMs = SCHEDULE_IDLE;
+    if (_scheduler) {
+        CycleTimer timer(_timerMetrics);
+        waitMs = _scheduler->tick();
+    }
+
+    if (_gate) {
+        {
+            CycleTimer timer(_gateMetrics);
+            _gate->update();
+        }
+
+        // Sensor level changes without a state transition are reported too
+        for (uint8_t gate = 0; gate < Gate::GATE_COUNT; gate++) {
+            if (_gate->getSensorState(gate) != _latest[gate].sensorState) {
+                _captureSnapshot(gate);
+            }
+        }
+
+        uint32_t gateWaitMs = _gate->msUntilNextEvent();
+        if (gateWaitMs < waitMs) {
+            waitMs = gateWaitMs;
+        }
+    }
+
+    // A snapshot stuck behind a full queue is retried soon, not at the next deadline
+    _flushSnapshots();
+    if (_snapshotPending && waitMs > 1) {
+        waitMs = 1;
+    }
+
+    // Handlers may have added deadlines earlier than the one tick() returned
+    if (_scheduler) {
+        uint32_t schedulerWaitMs = _scheduler->msUntilNext();
+        if (schedulerWaitMs < waitMs) {
+            waitMs = schedulerWaitMs;
+        }
+    }
+    return waitMs;
+}
+
+bool ControlTask::postCommand(GateCommand command, CommandSource source, uint8_t gate) {
+    if (gate >= Gate::GATE_COUNT) {
+        return false;
+    }
+
+    GateRequest request;
+    request.command = command;
+    request.source = source;
+    request.gate = gate;
+    if (_commands.push(request)) {
+        wake();
+        return true;
+    }
+    _droppedCommands.store(_droppedCommands.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    return false;
+}
+
+bool ControlTask::pollState(GateSnapshot& snapshot) {
+    return _states.pop(snapshot);
+}
+
+bool ControlTask::pollTransition(GateTransition& transition) {
+    return _transitions.pop(transition);
+}
+
+uint32_t ControlTask::droppedCommands() const {
+    return _droppedCommands.load(std::memory_order_relaxed);
+}
+
+uint32_t ControlTask::droppedTransitions() const {
+    return _droppedTransitions.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+void ControlTask::_executeCommand(const GateRequest& request) {
+    if (!_gate) {
+        return;
+    }
+
+    LOG_INFO("[CONTROL] Executing %s command for gate %u from %s",
+             gateCommandName(request.command), request.gate, commandSourceName(request.source));
+
+    // Transitions raised while executing are attributed to this source
+    _activeSource = request.source;
+    switch (request.command) {
+        case GATE_COMMAND_OPEN:   _gate->openGate(request.gate);  break;
+        case GATE_COMMAND_CLOSE:  _gate->closeGate(request.gate); break;
+        case GATE_COMMAND_STOP:   _gate->stopGate(request.gate);  break;
+        case GATE_COMMAND_TOGGLE: _gate->toggle(request.gate);    break;
+    }
+    _activeSource = COMMAND_SOURCE_GATE;
+}
+
+void ControlTask::_captureSnapshot(uint8_t gate) {
+    _latest[gate].state = _gate ? _gate->getState(gate) : GATE_UNKNOWN;
+    _latest[gate].sensorState = _gate ? _gate->getSensorState(gate) : false;
+    _latest[gate].timestamp = millis();
+    _snapshotPending |= (GateMask)1 << gate;
+    _flushSnapshots();
+}
+
+void ControlTask::_flushSnapshots() {
+    bool queued = false;
+    for (uint8_t gate = 0; gate < Gate::GATE_COUNT && _snapshotPending; gate++) {
+        GateMask bit = (GateMask)1 << gate;
+        if ((_snapshotPending & bit) && _states.push(_latest[gate])) {
+            _snapshotPending &= ~bit;
+            queued = true;
+        }
+    }
+    if (queued && _stateListener) {
+        _stateListener(_stateListenerContext);
+    }
+}
+
+void ControlTask::_onStateChange(uint8_t gate, GateState oldState, GateState newState, void* context) {
+    ControlTask* self = static_cast<ControlTask*>(context);
+    if (self->_ledManager && gate == 0) {
+        self->_ledManager->setStatus(newState);
+    }
+
+    GateTransition transition;
+    transition.timestamp = millis();
+    transition.gate = gate;
+    transition.from = oldState;
+    transition.to = newState;
+    transition.source = self->_activeSource;
+    if (!self->_transitions.push(transition)) {
+        self->_droppedTransitions.store(self->_droppedTransitions.load(std::memory_order_relaxed) + 1,
+                                        std::memory_order_relaxed);
+    }
+
+    self->_captureSnapshot(gate);
+}
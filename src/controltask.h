@@ -0,0 +1,226 @@
+/**
+ * ControlTask.h - ESP32 Swing Gate Controller real-time control task
+ *
+ * Runs the Gate state machine and LED manager in a high-priority FreeRTOS
+ * task pinned to its own core. The network side never touches Gate
+ * directly: it posts commands into a lock-free command queue and receives
+ * state snapshots from a lock-free state queue, so a stalled socket or HTTP
+ * request cannot delay relay release or sensor handling. Every record
+ * carries the index of the gate it belongs to; the LEDs follow gate 0.
+ *
+ * The task is tickless: it sleeps until the earliest scheduler or gate
+ * deadline, or until a sensor edge or command notifies it.
+ */
+
+#ifndef ControlTask_h
+#define ControlTask_h
+
+#include "Arduino.h"
+#include "gate.h"
+#include "ledmanager.h"
+#include "loophistogram.h"
+#include "metrics.h"
+#include "scheduler.h"
+#include "spscqueue.h"
+
+// ============================================================================
+// QUEUE RECORDS
+// ============================================================================
+enum GateCommand : uint8_t {
+    GATE_COMMAND_OPEN,
+    GATE_COMMAND_CLOSE,
+    GATE_COMMAND_STOP,
+    GATE_COMMAND_TOGGLE
+};
+
+/**
+ * Get command name for logging without allocating
+ * @param command Gate command
+ * @return Static string representation of the command
+ */
+const char* gateCommandName(GateCommand command);
+
+// Origin of a command, recorded with the transitions it causes
+enum CommandSource : uint8_t {
+    COMMAND_SOURCE_GATE,    // No command: sensor or travel timeout
+    COMMAND_SOURCE_MQTT,
+    COMMAND_SOURCE_HTTP
+};
+
+/**
+ * Get command source name for logging without allocating
+ */
+const char* commandSourceName(CommandSource source);
+
+struct GateRequest {
+    GateCommand command;
+    CommandSource source;
+    uint8_t gate;           // Gate index
+};
+
+struct GateSnapshot {
+    uint8_t gate;           // Gate index
+    GateState state;        // Gate state after the change
+    bool sensorState;       // Debounced position sensor level
+    uint32_t timestamp;     // millis() when the change was observed
+};
+
+/**
+ * Called on the control task after a snapshot was queued, e.g. to wake
+ * the consumer. Must not block.
+ */
+typedef void (*StateListener)(void* context);
+
+struct GateTransition {
+    uint32_t timestamp;     // millis() of the transition
+    uint8_t gate;           // Gate index
+    GateState from;
+    GateState to;
+    CommandSource source;   // Command being executed, or COMMAND_SOURCE_GATE
+};
+
+// ============================================================================
+// CONTROL TASK CLASS DECLARATION
+// ============================================================================
+class ControlTask {
+public:
+    static const size_t COMMAND_QUEUE_SIZE = 8;     // Network -> control
+    static const size_t STATE_QUEUE_SIZE = 16;      // Control -> network
+    static const size_t TRANSITION_QUEUE_SIZE = 16; // Control -> network (journal)
+    static const uint32_t STACK_SIZE = 4096;        // Task stack in bytes
+
+    /**
+     * Constructor
+     * @param scheduler Scheduler the gate and LED manager were created with
+     * @param gate Initialized gate controller (owned by the control task from now on)
+     * @param ledManager Initialized LED manager
+     */
+    ControlTask(Scheduler* scheduler, Gate* gate, LEDManager* ledManager);
+
+    /**
+     * Hook into gate state changes and sensor edges, queue the initial snapshot
+     * Must be called before start() or the first runOnce()
+     */
+    void begin();
+
+#if defined(ARDUINO_ARCH_ESP32)
+    /**
+     * Create the FreeRTOS task running runOnce() whenever a deadline
+     * expires or a wake-up is notified
+     * @param core CPU core to pin the task to
+     * @param priority FreeRTOS task priority
+     * @return true if the task was created
+     */
+    bool start(uint8_t core, uint8_t priority);
+#endif
+
+    /**
+     * Wake the control task early (any task)
+     */
+    void wake();
+
+    /**
+     * Wake the control task from an interrupt (EdgeWakeHandler)
+     * @param controlTask ControlTask to wake
+     */
+    static void wakeFromIsr(void* controlTask);
+
+    /**
+     * Whether a wake-up arrived since the last runOnce()
+     */
+    bool wakePending() const;
+
+    /**
+     * Register the consumer notified after each queued state snapshot
+     * @param listener Listener, or nullptr to remove
+     * @param context Passed to the listener
+     */
+    void setStateListener(StateListener listener, void* context);
+
+    /**
+     * Record Gate::update and scheduler (relay/LED deadline) execution times
+     * @param metrics Metrics registry, or nullptr to stop recording
+     */
+    void setMetrics(Metrics* metrics);
+
+    /**
+     * One control iteration: apply queued commands, run due deadlines and
+     * update the gate state machine. Called by the task, or directly on
+     * the host build.
+     * @return Milliseconds the task may sleep before the next iteration
+     */
+    uint32_t runOnce();
+
+    /**
+     * Queue a command for a gate and wake the control task (network side only)
+     * @param command Command to execute on the next control iteration
+     * @param source Origin of the command, recorded with resulting transitions
+     * @param gate Gate index (0 to Gate::GATE_COUNT - 1)
+     * @return false if the queue is full and the command was dropped, or
+     *         the gate index is out of range
+     */
+    bool postCommand(GateCommand command, CommandSource source, uint8_t gate);
+
+    /**
+     * Take the oldest state snapshot (network side only)
+     * @param snapshot Receives the snapshot
+     * @return false if no snapshot is pending
+     */
+    bool pollState(GateSnapshot& snapshot);
+
+    /**
+     * Take the oldest gate transition (network side only)
+     * Unlike snapshots, every transition is delivered until the queue overflows.
+     * @param transition Receives the transition
+     * @return false if no transition is pending
+     */
+    bool pollTransition(GateTransition& transition);
+
+    /**
+     * Period histogram of the control loop
+     */
+    const LoopHistogram& getLoopHistogram() const { return _loopHistogram; }
+
+    /**
+     * Commands dropped because the command queue was full
+     */
+    uint32_t droppedCommands() const;
+
+    /**
+     * Transitions dropped because the transition queue was full
+     */
+    uint32_t droppedTransitions() const;
+
+private:
+    Scheduler* _scheduler;          // Relay and LED deadlines (control task only)
+    Gate* _gate;                    // Gate state machine (control task only)
+    LEDManager* _ledManager;        // LED indicators (control task only)
+
+    SpscQueue<GateRequest, COMMAND_QUEUE_SIZE> _commands;   // Network -> control
+    SpscQueue<GateSnapshot, STATE_QUEUE_SIZE> _states;      // Control -> network
+    SpscQueue<GateTransition, TRANSITION_QUEUE_SIZE> _transitions; // Control -> network
+    std::atomic<uint32_t> _droppedCommands;                 // Full command queue
+    std::atomic<uint32_t> _droppedTransitions;              // Full transition queue
+    std::atomic<bool> _wakePending;                         // Wake-up since last runOnce
+
+    GateSnapshot _latest[Gate::GATE_COUNT]; // Most recent snapshot per gate
+    CommandSource _activeSource;    // Source of the command being executed
+    GateMask _snapshotPending;      // _latest[i] not yet queued (state queue was full)
+    LoopHistogram _loopHistogram;   // Control loop period
+    CycleHistogram* _gateMetrics;   // Gate::update execution time
+    CycleHistogram* _timerMetrics;  // Scheduler::tick execution time
+    StateListener _stateListener;   // Snapshot consumer wake-up
+    void* _stateListenerContext;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    TaskHandle_t _taskHandle;       // FreeRTOS task handle
+    static void _taskEntry(void* argument);
+#endif
+
+    void _executeCommand(const GateRequest& request);
+    void _captureSnapshot(uint8_t gate);
+    void _flushSnapshots();
+    static void _onStateChange(uint8_t gate, GateState oldState, GateState newState, void* context);
+};
+
+#endif // ControlTask_h
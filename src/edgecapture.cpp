@@ -0,0 +1,70 @@
+/**
+ * EdgeCapture.cpp - ESP32 Swing Gate Controller input edge capture
+ *
+ * Implementation of the interrupt handler and ring buffer drain.
+ */
+
+#include "edgecapture.h"
+
+// ============================================================================
+// EDGE CAPTURE CLASS IMPLEMENTATION
+// ============================================================================
+
+EdgeCapture::EdgeCapture(int pin)
+    : _pin(pin), _attached(false), _dropped(0), _wakeHandler(nullptr), _wakeArg(nullptr) {
+}
+
+EdgeCapture::EdgeCapture() : EdgeCapture(-1) {
+}
+
+void EdgeCapture::setPin(int pin) {
+    if (!_attached) {
+        _pin = pin;
+    }
+}
+
+void EdgeCapture::begin() {
+    if (_attached) return;
+
+    attachInterruptArg(digitalPinToInterrupt(_pin), _isr, this, CHANGE);
+    _attached = true;
+
+    Serial.print("[EDGE] Edge capture attached to pin ");
+    Serial.println(_pin);
+}
+
+void EdgeCapture::end() {
+    if (!_attached) return;
+
+    detachInterrupt(digitalPinToInterrupt(_pin));
+    _attached = false;
+}
+
+void EdgeCapture::setWakeHandler(EdgeWakeHandler handler, void* arg) {
+    _wakeArg = arg;
+    _wakeHandler = handler;
+}
+
+bool EdgeCapture::pop(InputEdge& edge) {
+    return _edges.pop(edge);
+}
+
+uint32_t EdgeCapture::droppedEdges() const {
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+void IRAM_ATTR EdgeCapture::_isr(void* arg) {
+    EdgeCapture* capture = static_cast<EdgeCapture*>(arg);
+
+    InputEdge edge;
+    edge.timestampUs = micros();
+    edge.level = digitalRead(capture->_pin);
+
+    if (!capture->_edges.push(edge)) {
+        capture->_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (capture->_wakeHandler) {
+        capture->_wakeHandler(capture->_wakeArg);
+    }
+}
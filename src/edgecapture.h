@@ -0,0 +1,97 @@
+/**
+ * EdgeCapture.h - ESP32 Swing Gate Controller input edge capture
+ *
+ * Interrupt-driven capture of level changes on a digital input. Every edge
+ * is stamped with micros() inside the ISR and pushed into a lock-free ring
+ * buffer that the main loop drains, so edges are neither missed nor delayed
+ * by the loop cadence.
+ */
+
+#ifndef EdgeCapture_h
+#define EdgeCapture_h
+
+#include "Arduino.h"
+#include "spscqueue.h"
+
+// ============================================================================
+// EDGE RECORD
+// ============================================================================
+struct InputEdge {
+    uint32_t timestampUs;   // micros() at the time of the interrupt
+    uint8_t level;          // Pin level read in the ISR (HIGH/LOW)
+};
+
+/**
+ * Called from the interrupt after an edge was queued (e.g. to wake the
+ * consuming task). Runs in ISR context: must be short and IRAM-safe.
+ */
+typedef void (*EdgeWakeHandler)(void* arg);
+
+// ============================================================================
+// EDGE CAPTURE CLASS DECLARATION
+// ============================================================================
+class EdgeCapture {
+public:
+    static const size_t QUEUE_SIZE = 32;    // Edges buffered between drains
+
+    /**
+     * Constructor
+     * @param pin GPIO input pin to capture
+     */
+    explicit EdgeCapture(int pin);
+
+    /**
+     * Constructor for arrays of captures; set the pin before begin()
+     */
+    EdgeCapture();
+
+    /**
+     * Set the GPIO input pin to capture (before begin())
+     */
+    void setPin(int pin);
+
+    /**
+     * Attach the CHANGE interrupt
+     * Must be called after the GPIO pin is configured
+     */
+    void begin();
+
+    /**
+     * Detach the interrupt
+     */
+    void end();
+
+    /**
+     * Set the handler called from the ISR after each captured edge
+     * Set before begin(); nullptr disables it.
+     */
+    void setWakeHandler(EdgeWakeHandler handler, void* arg);
+
+    /**
+     * Take the oldest captured edge (main loop only)
+     * @param edge Receives the edge
+     * @return false if no edge is pending
+     */
+    bool pop(InputEdge& edge);
+
+    /**
+     * Number of edges lost because the buffer was full
+     * Non-zero means the drained sequence is incomplete and the pin level
+     * should be re-read directly.
+     */
+    uint32_t droppedEdges() const;
+
+    int pin() const { return _pin; }
+
+private:
+    int _pin;                                   // Captured GPIO pin
+    bool _attached;                             // Interrupt attached flag
+    SpscQueue<InputEdge, QUEUE_SIZE> _edges;    // ISR -> loop edge buffer
+    std::atomic<uint32_t> _dropped;             // Edges lost to overflow
+    EdgeWakeHandler _wakeHandler;               // Consumer wake-up (ISR context)
+    void* _wakeArg;                             // Wake handler argument
+
+    static void IRAM_ATTR _isr(void* arg);
+};
+
+#endif // EdgeCapture_h
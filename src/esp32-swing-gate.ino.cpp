@@ -12,12 +12,10 @@
 
 #include "Arduino.h"
 #include <PubSubClient.h>
-#include <arduino-timer.h>
 #include <EthernetESP32.h>
 // #include <WiFi.h>
 #include <WebServer.h>
 #include <ElegantOTA.h>
-#include "DHTesp.h"
 
 // #include <PubSubClient.h>
 
@@ -27,9 +25,22 @@
 #include "gate.h"
 #include "ledmanager.h"
 #include "mqttmanager.h"
+#include "linkmanager.h"
+#include "scheduler.h"
+#include "controltask.h"
+#include "loophistogram.h"
+#include "metrics.h"
+#include "journal.h"
+#include "commandparser.h"
+#include "httpserver.h"
+#include "eventstream.h"
+#include "inputscanner.h"
+#include "passcounter.h"
+#include "climatesensor.h"
+#include "logger.h"
+#include <LittleFS.h>
 #include <SPI.h>
 #include <Network.h>
-// #include <Debounce16.h>
 
 EMACDriver driver(ETH_PHY_LAN8720, 23, 18, 16);   // note powerPin = 16 required
 // EMACDriver driver(ETH_PHY_LAN8720, ETH_PHY_MDC, ETH_PHY_MDIO, ETH_PHY_POWER);
@@ -38,82 +49,87 @@ EMACDriver driver(ETH_PHY_LAN8720, 23, 18, 16);   // note powerPin = 16 required
 EthernetClient ethClient;
 WiFiClient wifiClient;
 
-// Pointer to the active client (Ethernet or WiFi)
-NetworkClient* activeClient = nullptr;
+// Selects the active client (Ethernet or WiFi) from network events
+LinkManager linkManager(&ethClient, &wifiClient);
 
-// MQTT client - will be configured with activeClient dynamically
+// MQTT client - will be configured with the active client dynamically
 // PubSubClient mqttClient;
 
-WebServer server(80);
+// Status and command routes; never blocks the network task
+HttpServer server(80);
 
-// Connection check result (used by network event handler)
-int connectionStatus = 0;
+// ElegantOTA needs the synchronous WebServer; it only serves /update
+WebServer otaServer(OTA_HTTP_PORT);
+
+// Journal records per /journal body piece (about 2 KB of CSV)
+const uint16_t JOURNAL_HTTP_BATCH = 48;
+
+// Comment line sent to /events subscribers when nothing else happens
+const uint32_t EVENT_HEARTBEAT_MS = 15000;
 
-DHTesp dhtSensor;
 
 // ============================================================================
 // NETWORK EVENT HANDLER
 // ============================================================================
 // WARNING: This function is called from a separate FreeRTOS task (thread)!
+// It only logs and posts link events into the link manager's lock-free queue;
+// the network task applies them in linkManager.update().
+
+// IPv4 address as esp_netif holds it (network byte order) in one log record
+void logAddress(const char *format, uint32_t addr) {
+  LOG_INFO(format, addr & 0xFF, (addr >> 8) & 0xFF, (addr >> 16) & 0xFF, addr >> 24);
+}
+
 void onNetworkEvent(arduino_event_id_t event, arduino_event_info_t info) {
-  Serial.printf("[Network-event] event: %d\n", event);
+  LOG_INFO("[Network-event] event: %d", (int)event);
 
   switch (event) {
     case ARDUINO_EVENT_ETH_START:
-      Serial.println("[ETH] Ethernet started");
+      LOG_INFO("[ETH] Ethernet started");
       break;
     case ARDUINO_EVENT_ETH_STOP:
-      Serial.println("[ETH] Ethernet stopped");
+      LOG_INFO("[ETH] Ethernet stopped");
       break;
     case ARDUINO_EVENT_ETH_CONNECTED:
-      Serial.println("[ETH] Ethernet connected - Link UP");
+      LOG_INFO("[ETH] Ethernet connected - Link UP");
       break;
     case ARDUINO_EVENT_ETH_DISCONNECTED:
-      Serial.println("[ETH] Ethernet disconnected - Link DOWN");
-      connectionStatus = 0;
-      activeClient = nullptr;
+      LOG_INFO("[ETH] Ethernet disconnected - Link DOWN");
+      linkManager.postEvent(LINK_EVENT_ETH_DOWN);
       break;
     case ARDUINO_EVENT_ETH_GOT_IP:
-      Serial.print("[ETH] Obtained IP address: ");
-      Serial.println(IPAddress(info.got_ip.ip_info.ip.addr));
-      Serial.print("[ETH] Gateway: ");
-      Serial.println(IPAddress(info.got_ip.ip_info.gw.addr));
-      Serial.print("[ETH] Netmask: ");
-      Serial.println(IPAddress(info.got_ip.ip_info.netmask.addr));
-      connectionStatus = 1;
-      activeClient = &ethClient;
+      logAddress("[ETH] Obtained IP address: %u.%u.%u.%u", info.got_ip.ip_info.ip.addr);
+      logAddress("[ETH] Gateway: %u.%u.%u.%u", info.got_ip.ip_info.gw.addr);
+      logAddress("[ETH] Netmask: %u.%u.%u.%u", info.got_ip.ip_info.netmask.addr);
+      linkManager.postEvent(LINK_EVENT_ETH_UP);
       break;
     case ARDUINO_EVENT_ETH_GOT_IP6:
-      Serial.println("[ETH] Ethernet IPv6 is preferred");
+      LOG_INFO("[ETH] Ethernet IPv6 is preferred");
+      break;
+    case ARDUINO_EVENT_ETH_LOST_IP:
+      LOG_INFO("[ETH] Lost IP address");
+      linkManager.postEvent(LINK_EVENT_ETH_DOWN);
       break;
     case ARDUINO_EVENT_WIFI_STA_START:
-      Serial.println("[WiFi] WiFi client started");
+      LOG_INFO("[WiFi] WiFi client started");
       break;
     case ARDUINO_EVENT_WIFI_STA_STOP:
-      Serial.println("[WiFi] WiFi client stopped");
+      LOG_INFO("[WiFi] WiFi client stopped");
       break;
     case ARDUINO_EVENT_WIFI_STA_CONNECTED:
-      Serial.println("[WiFi] Connected to access point");
+      LOG_INFO("[WiFi] Connected to access point");
       break;
     case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
-      Serial.println("[WiFi] Disconnected from WiFi access point");
-      if (connectionStatus == 2) {
-        connectionStatus = 0;
-        activeClient = nullptr;
-      }
+      LOG_INFO("[WiFi] Disconnected from WiFi access point");
+      linkManager.postEvent(LINK_EVENT_WIFI_DOWN);
       break;
     case ARDUINO_EVENT_WIFI_STA_GOT_IP:
-      Serial.print("[WiFi] Obtained IP address: ");
-      Serial.println(IPAddress(info.got_ip.ip_info.ip.addr));
-      connectionStatus = 2;
-      activeClient = &wifiClient;
+      logAddress("[WiFi] Obtained IP address: %u.%u.%u.%u", info.got_ip.ip_info.ip.addr);
+      linkManager.postEvent(LINK_EVENT_WIFI_UP);
       break;
     case ARDUINO_EVENT_WIFI_STA_LOST_IP:
-      Serial.println("[WiFi] Lost IP address");
-      if (connectionStatus == 2) {
-        connectionStatus = 0;
-        activeClient = nullptr;
-      }
+      LOG_INFO("[WiFi] Lost IP address");
+      linkManager.postEvent(LINK_EVENT_WIFI_DOWN);
       break;
     default:
       break;
@@ -131,29 +147,15 @@ struct Config {
   // char statusTopic[64] = "gateguardian/status";
   // char commandTopic[64] = "gateguardian/command";
 
-  // Timing Settings
-  unsigned long gateOperationTime = 20000; // 20 seconds (Requirement 2)
-  unsigned long relayPulseTime = 500;      // 500ms (Requirement 1)
-  unsigned long publishInterval = 10000;   // 10 seconds (Requirement 7)
+  // Timing Settings (gate timing and GPIO pins are in BoardPolicy)
+  unsigned long publishInterval = MQTT_HEARTBEAT_INTERVAL; // Heartbeat; changes publish immediately
+  unsigned long publishHoldoff = MQTT_PUBLISH_HOLDOFF;    // Coalescing window for changes
+  StatusFormat statusFormat = MQTT_STATUS_FORMAT;         // Status payload encoding
+  uint8_t statusQos = MQTT_STATUS_QOS;                    // 1: retried until acknowledged
+  bool statusRetain = MQTT_STATUS_RETAIN;                 // Broker keeps the latest status
   unsigned long blinkInterval = 500;       // 500ms (Requirement 3)
   unsigned long debounceTime = 50;         // 50ms button debounce
-
-  // GPIO Pins
-  int redLedPin = 17;
-  int greenLedPin = 5;
-
-  int gateLightsPin = 33;
-  int gateLockPin = 32;
-  int externalRelayPin = 35;  // Input only
-  int photoEyePin = 36;  // Input only
-
-  int sensor1Pin = 4;
-  int sensor2Pin = 2;
-
-  int openRelayPin = 15;
-  int closeRelayPin = 12;
-  int stopRelayPin = 14;
-
+  unsigned long wifiRetryInterval = 10000; // 10 seconds between WiFi attempts
 };
 
 // ============================================================================
@@ -163,12 +165,33 @@ Config config;
 Gate *gate = nullptr;
 LEDManager *ledManager = nullptr;
 MQTTManager *mqttManager = nullptr;
+ControlTask *controlTask = nullptr;
+
+// Deadlines of each task: relay pulse and LED blink run on the control
+// task's scheduler, periodic input checks and reports on the network task's
+Scheduler controlScheduler;
+Scheduler networkScheduler;
+TaskHandle_t networkTaskHandle = nullptr;
 
-// Timer for main loop management
-auto mainTimer = timer_create_default();
+// Network task loop period histogram (control task keeps its own)
+LoopHistogram networkLoopHistogram;
 
-// Previous gate state for change detection
-GateState previousGateState = GATE_UNKNOWN;
+// Per-subsystem execution time histograms, served on /metrics
+Metrics metrics;
+
+// Gate transition history on flash, served on /journal
+Journal journal(LittleFS, "/journal");
+
+// Gate transitions and input changes pushed to /events subscribers; each
+// event is serialized once and sent to every subscriber from the same ring
+EventStream events;
+GateState streamedStates[Gate::GATE_COUNT] = {};   // Latest state per gate, for new subscribers
+uint8_t streamedInputs = 0xFF;                      // STATUS_INPUT_* bits; 0xFF until first read
+
+// Learned gate travel time, saved after each timed close
+// ("/travel.bin" for the first gate, "/travel<i>.bin" for the others)
+bool filesystemMounted = false;
+uint16_t savedTravelSamples[Gate::GATE_COUNT] = {};
 
 // Button handling variables
 bool lastButtonState = LOW; // Button is active LOW with pull-up
@@ -176,10 +199,27 @@ bool currentButtonState = HIGH;
 unsigned long lastButtonChange = 0;
 bool buttonPressed = false; // Flag to track button press events
 
-// Debounce16 gateLightsButton(config.gateLightsPin, LOW);
-// Debounce16 gateLockButton(config.gateLockPin, LOW);
-// Debounce16 externalRelayButton(config.externalRelayPin, LOW);
-// Debounce16 photoEyeButton(config.photoEyePin, LOW);
+// Discrete inputs, sampled together from the GPIO input registers and
+// debounced every INPUT_SCAN_INTERVAL_MS on the network task
+InputScanner inputScanner;
+const uint8_t SCANNED_INPUTS[] = {
+  BoardPolicy::PIN_GATE_LIGHTS, BoardPolicy::PIN_GATE_LOCK,
+  BoardPolicy::PIN_EXTERNAL_RELAY, BoardPolicy::PIN_PHOTO_EYE
+};
+
+// Photo-eye passes, counted by the pulse counter peripheral and timed from
+// captured edges; reported in the MQTT status, on /traffic and /events
+PassCounter passCounter(BoardPolicy::PIN_PHOTO_EYE, BoardPolicy::PHOTO_EYE_ACTIVE_LEVEL);
+
+// DHT22, captured by the RMT peripheral in steps on the network task's
+// scheduler; readings are cached, nothing ever waits on the sensor
+ClimateSensor climateSensor(networkScheduler, BoardPolicy::PIN_SENSOR_1);
+
+// Remote log console: the log task writes every line to the latest client
+#if LOG_TCP_PORT
+NetworkServer logServer(LOG_TCP_PORT);
+NetworkClient logClient;
+#endif
 
 
 // ============================================================================
@@ -188,11 +228,28 @@ bool buttonPressed = false; // Flag to track button press events
 void initializeGPIO();
 // void handleButtonInput();
 void printConfigSummary();
-int checkConnection();
-bool checkConnectionCallback(void *);
+void startWifi();
+void stopWifi();
 bool reportConnectionStatusCallback(void *);
 bool checkInputCallback(void *);
+void networkTask(void *);
+uint32_t networkLoop();
+void wakeNetworkTask(void *);
+void handleGateRoute(HttpRequest &request, void *);
+bool streamMetrics(HttpBody &body, uint32_t &section, uint32_t, void *);
+bool streamJournal(HttpBody &body, uint32_t &since, uint32_t until, void *);
+void handleEventsRoute(HttpRequest &request, void *);
+bool eventHeartbeatCallback(void *);
+bool scanInputsCallback(void *);
+void onInputChange(uint8_t pin, bool level, void *);
+uint8_t readInputs();
+void formatInputsJson(uint8_t inputs, char *json, size_t size);
+bool passCounterCallback(void *);
+void onPass(uint32_t durationMs, void *);
+void onClimateReading(const ClimateReading &reading, void *);
+void travelEstimatePath(uint8_t gateIndex, char *path, size_t size);
 NetworkClient* getActiveClient();
+void tcpLogSink(const char *line, size_t length, void *);
 
 void onButtonPress() {
     Serial.println("!!!!!!! Button pressed!");
@@ -251,11 +308,12 @@ void setup() {
   Serial.print(ESP.getFreeHeap());
   Serial.println(" bytes");
   
-  dhtSensor.setup(config.sensor1Pin, DHTesp::DHT22);
+  // Queued log records go to Serial from the log task started below
+  logger.addSink(Logger::serialSink, nullptr);
 
-  TempAndHumidity  data = dhtSensor.getTempAndHumidity();
-  Serial.println("Temp:     " + String(data.temperature, 2) + "°C");
-  Serial.println("Humidity: " + String(data.humidity, 1) + "%");
+  // First climate reading two seconds after the network task starts
+  climateSensor.setCallback(onClimateReading, nullptr);
+  climateSensor.begin(CLIMATE_READ_INTERVAL_MS);
   
   // Generate random client ID for MQTT
   randomSeed(analogRead(0));
@@ -264,17 +322,13 @@ void setup() {
   Serial.println(config.clientId);
 
 
-  // gateLightsButton.onPress(onButtonPress);
-  // gateLightsButton.onRelease(onButtonRelease);
-
-  // gateLockButton.onPress(onButtonPress);
-  // gateLockButton.onRelease(onButtonRelease);
-
-  // externalRelayButton.onPress(onButtonPress);
-  // externalRelayButton.onRelease(onButtonRelease);
+  // Debounced input scanning; levels found at boot are taken as they are
+  inputScanner.begin(SCANNED_INPUTS, sizeof(SCANNED_INPUTS));
+  inputScanner.setCallback(onInputChange, nullptr);
 
-  // photoEyeButton.onPress(onButtonPress);
-  // photoEyeButton.onRelease(onButtonRelease);
+  // Photo-eye pass counting runs in hardware from here on
+  passCounter.setCallback(onPass, nullptr);
+  passCounter.begin();
 
   
   // Initialize button state after GPIO configuration
@@ -284,7 +338,7 @@ void setup() {
   // Serial.println(lastButtonState ? "HIGH (not pressed)" : "LOW (pressed)");
 
   // Initialize Gate controller
-  gate = new Gate();
+  gate = new Gate(controlScheduler);
   if (gate) {
     gate->initialize();
     Serial.println("[INIT] Gate controller created and initialized");
@@ -293,28 +347,51 @@ void setup() {
   }
 
   // Initialize LED Manager
-  ledManager = new LEDManager(config.redLedPin, config.greenLedPin);
+  ledManager = new LEDManager(controlScheduler, BoardPolicy::PIN_LED_RED, BoardPolicy::PIN_LED_GREEN);
   if (ledManager) {
     ledManager->initialize();
-
-    // Set initial LED state based on gate state
-    if (gate) {
-      GateState initialState = gate->getState();
-      ledManager->setStatus(initialState);
-      previousGateState = initialState;
-    }
-
     Serial.println("[INIT] LED manager initialized");
   } else {
     Serial.println("[ERROR] Failed to initialize LED manager");
   }
 
+  // Gate and LEDs are owned by the control task from here on; the network
+  // side only talks to them through its command and state queues
+  controlTask = new ControlTask(&controlScheduler, gate, ledManager);
+  controlTask->begin();
+  controlTask->setStateListener(wakeNetworkTask, nullptr);
+
+  // Cycle-counter timing of every subsystem update
+  metrics.begin();
+  controlTask->setMetrics(&metrics);
+  metrics.addLoopHistogram("control", &controlTask->getLoopHistogram());
+  metrics.addLoopHistogram("network", &networkLoopHistogram);
+
+  // Transition journal (formats the partition on first boot)
+  // and learned travel time (before the control task starts using it)
+  if (LittleFS.begin(true)) {
+    filesystemMounted = true;
+    journal.begin();
+    for (uint8_t i = 0; gate && i < Gate::GATE_COUNT; i++) {
+      char path[16];
+      travelEstimatePath(i, path, sizeof(path));
+      if (gate->travelEstimator(i).load(LittleFS, path)) {
+        savedTravelSamples[i] = gate->travelEstimator(i).estimate().samples;
+      }
+    }
+  } else {
+    Serial.println("[ERROR] LittleFS mount failed, transition journal and travel learning not persisted");
+  }
+
 
   // mqttClient.setServer(config.mqttBroker, config.mqttPort);
   // mqttClient.setCallback(mqttCallback);
 
 
   // Register network event listener
+  linkManager.setWifiActions(startWifi, stopWifi);
+  linkManager.setWifiRetryInterval(config.wifiRetryInterval);
+  linkManager.begin();
   Network.onEvent(onNetworkEvent);
   Serial.println("[INIT] Network event listener registered");
 
@@ -359,12 +436,17 @@ void setup() {
                                 config.clientId, MQTT_TOPIC_STATUS, 
                                 MQTT_TOPIC_COMMAND);
   if (mqttManager) {
-    mqttManager->initialize(activeClient);
+    mqttManager->initialize(linkManager.getActiveClient());
     
-    // Set gate controller reference for command handling
-    if (gate) {
-      mqttManager->setGateController(gate);
-    }
+    // Queue MQTT commands to the control task
+    mqttManager->setControlTask(controlTask);
+    mqttManager->setHeartbeatInterval(config.publishInterval);
+    mqttManager->setPublishHoldoff(config.publishHoldoff);
+    mqttManager->setStatusFormat(config.statusFormat);
+    mqttManager->setStatusQos(config.statusQos);
+    mqttManager->setStatusRetain(config.statusRetain);
+    mqttManager->setAvailability(MQTT_TOPIC_AVAILABILITY, MQTT_PAYLOAD_ONLINE,
+                                 MQTT_PAYLOAD_OFFLINE, MQTT_AVAILABILITY_RETAIN);
     
     Serial.println("[INIT] MQTT manager initialized");
   } else {
@@ -372,20 +454,70 @@ void setup() {
   }
 
 
-  server.on("/", []() {
-    server.send(200, "text/plain", "Hi! This is GateGuardian");
+  server.on("/", [](HttpRequest &request, void *) {
+    request.send(200, "text/plain", "Hi! This is GateGuardian");
   });
-  server.on("/gate/close", []() {
-    gate->closeGate();
-    server.send(200, "text/plain", "Gate closing...");
+  // /gate/open, /gate/close, /gate/stop, /gate/toggle share the MQTT command dispatcher
+  // (first gate); with several gates /gate/<i>/<command> addresses gate i
+  for (size_t i = 0; i < COMMAND_KEYWORD_COUNT; i++) {
+    char path[24];
+    snprintf(path, sizeof(path), "/gate/%s", COMMAND_KEYWORDS[i].text);
+    server.on(path, handleGateRoute);
+    for (uint8_t g = 0; Gate::GATE_COUNT > 1 && g < Gate::GATE_COUNT; g++) {
+      snprintf(path, sizeof(path), "/gate/%u/%s", g, COMMAND_KEYWORDS[i].text);
+      server.on(path, handleGateRoute);
+    }
+  }
+  server.on("/metrics", HTTP_METHOD_GET, [](HttpRequest &request, void *) {
+    // Chunked response straight from the histograms, one section per piece
+    request.stream(200, "text/plain; version=0.0.4", streamMetrics, nullptr);
   });
-  server.on("/gate/open", []() {
-    gate->openGate();
-    server.send(200, "text/plain", "Gate opening...");
+  server.on("/journal", HTTP_METHOD_GET, [](HttpRequest &request, void *) {
+    // Chunked CSV read from flash a few records at a time; ?since=<sequence>
+    // returns only newer records, X-Journal-Last is the cursor for the next call
+    char value[12];
+    uint32_t since = request.arg("since", value, sizeof(value)) ? strtoul(value, nullptr, 10) : 0;
+    uint32_t last = journal.lastSequence();
+    snprintf(value, sizeof(value), "%lu", (unsigned long)last);
+    request.addHeader("X-Journal-Last", value);
+    request.stream(200, "text/csv", streamJournal, nullptr, since, last);
   });
-  server.on("/gate/stop", []() {
-    gate->stopGate();
-    server.send(200, "text/plain", "Gate stopping...");
+  server.on("/events", HTTP_METHOD_GET, handleEventsRoute);
+  server.on("/traffic", HTTP_METHOD_GET, [](HttpRequest &request, void *) {
+    // Photo-eye pass count and durations as of the last drain
+    PassStats stats = passCounter.stats();
+    char json[224];
+    snprintf(json, sizeof(json),
+             "{\"passes\":%lu,\"timed_passes\":%lu,\"last_pass_ms\":%lu,\"mean_pass_ms\":%lu,"
+             "\"longest_pass_ms\":%lu,\"last_pass_age_s\":%ld,\"blocked\":%s}",
+             (unsigned long)stats.passes, (unsigned long)stats.timedPasses,
+             (unsigned long)stats.lastDurationMs, (unsigned long)stats.meanDurationMs,
+             (unsigned long)stats.longestMs,
+             stats.lastPassMs ? (long)((millis() - stats.lastPassMs) / 1000) : -1L,
+             stats.blocked ? "true" : "false");
+    request.send(200, "application/json", json);
+  });
+  server.on("/mqtt", HTTP_METHOD_GET, [](HttpRequest &request, void *) {
+    // Status outbox delivery counters; latency is queued to PUBACK
+    char json[288];
+    if (!mqttManager) {
+      request.send(503, "text/plain", "MQTT not initialized");
+      return;
+    }
+    OutboxStats stats = mqttManager->outboxStats();
+    snprintf(json, sizeof(json),
+             "{\"connected\":%s,\"queued\":%lu,\"delivered\":%lu,\"pending\":%lu,"
+             "\"retransmits\":%lu,\"dropped\":%lu,\"expired\":%lu,\"writes\":%lu,"
+             "\"packets\":%lu,\"last_latency_ms\":%lu,\"mean_latency_ms\":%lu,"
+             "\"max_latency_ms\":%lu}",
+             mqttManager->isConnected() ? "true" : "false",
+             (unsigned long)stats.queued, (unsigned long)stats.delivered,
+             (unsigned long)stats.pending, (unsigned long)stats.retransmits,
+             (unsigned long)stats.dropped, (unsigned long)stats.expired,
+             (unsigned long)stats.writes, (unsigned long)stats.packets,
+             (unsigned long)stats.lastLatencyMs, (unsigned long)stats.meanLatencyMs,
+             (unsigned long)stats.maxLatencyMs);
+    request.send(200, "application/json", json);
   });
   // server.on("/gate/toggle", []() {
   //   gate->toggle();
@@ -396,25 +528,53 @@ void setup() {
   //   gate->stop();
   //   server.send(200, "text/plain", "Gate stopping...");
   // });
-  ElegantOTA.begin(&server);
   server.begin();
+  ElegantOTA.begin(&otaServer);
+  otaServer.begin();
   Serial.println("HTTP server started");
 
+#if LOG_TCP_PORT
+  logServer.begin();
+  logger.addSink(tcpLogSink, nullptr);
+  Serial.print("[INIT] Log console on TCP port ");
+  Serial.println(LOG_TCP_PORT);
+#endif
+
   // Print configuration summary
   printConfigSummary();
 
-  // Schedule checkConnection to run every 1000ms (1 second)
-  mainTimer.every(5000, checkConnectionCallback);
-  Serial.println("[INIT] Connection check scheduled every 1 second");
+  // Schedule input check every 10 seconds
+  networkScheduler.every(10000, checkInputCallback, nullptr);
+  Serial.println("[INIT] input check scheduled every 10 seconds");
+
+  // Sample and debounce the discrete inputs at a fixed rate
+  networkScheduler.every(INPUT_SCAN_INTERVAL_MS, scanInputsCallback, nullptr);
+  Serial.print("[INIT] Input scan scheduled every ");
+  Serial.print(INPUT_SCAN_INTERVAL_MS);
+  Serial.println(" ms");
+
+  // Time photo-eye passes from the captured edges
+  networkScheduler.every(PASS_COUNTER_INTERVAL_MS, passCounterCallback, nullptr);
 
-  // Schedule input to run every 1000ms
-  mainTimer.every(10000, checkInputCallback);
-  Serial.println("[INIT] input check scheduled every 1 second");
+  // Keep idle /events subscribers alive and detect dead ones
+  networkScheduler.every(EVENT_HEARTBEAT_MS, eventHeartbeatCallback, nullptr);
 
 
-  // Schedule connection status reporting every 2000ms (2 seconds)
-  mainTimer.every(5000, reportConnectionStatusCallback);
-  Serial.println("[INIT] Connection status reporting scheduled every 2 seconds");
+  // Schedule connection status and loop latency reporting every 5 seconds
+  networkScheduler.every(5000, reportConnectionStatusCallback, nullptr);
+  Serial.println("[INIT] Connection status reporting scheduled every 5 seconds");
+
+  // Split real-time control and network I/O across the two cores; log
+  // output is written by a task below both
+  logger.start(LOG_TASK_CORE, LOG_TASK_PRIORITY);
+  controlTask->start(CONTROL_TASK_CORE, CONTROL_TASK_PRIORITY);
+  if (xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK_SIZE, nullptr,
+                              NETWORK_TASK_PRIORITY, &networkTaskHandle, NETWORK_TASK_CORE) == pdPASS) {
+    Serial.print("[INIT] Network task started on core ");
+    Serial.println(NETWORK_TASK_CORE);
+  } else {
+    Serial.println("[ERROR] Failed to create network task");
+  }
 
   Serial.println("[INIT] System initialization complete");
   Serial.println("======================================");
@@ -422,191 +582,360 @@ void setup() {
 
 
 bool checkInputCallback(void *) {
-    Serial.print("Gatelight:     ");
-    Serial.println(digitalRead(config.gateLightsPin));
+    bool gateLights = inputScanner.level(BoardPolicy::PIN_GATE_LIGHTS);
+    bool gateLock = inputScanner.level(BoardPolicy::PIN_GATE_LOCK);
+    bool externalRelay = inputScanner.level(BoardPolicy::PIN_EXTERNAL_RELAY);
+    bool photoEye = inputScanner.level(BoardPolicy::PIN_PHOTO_EYE);
+
+    LOG_INFO("[INPUT] Gate lights %u, gate lock %u, external relay %u, photo eye %u",
+             gateLights, gateLock, externalRelay, photoEye);
+
+    // Cached climate reading; the sensor is read on its own schedule
+    ClimateReading climate = climateSensor.reading();
+    if (!climate.valid) {
+      LOG_WARN("[DHT22] Error status: %s", climateStatusName(climate.status));
+    } else {
+      LOG_INFO("[DHT22] Temperature %.2f C, humidity %.1f %%", climate.temperature, climate.humidity);
+    }
 
-    Serial.print("GateLock:      ");
-    Serial.println(digitalRead(config.gateLockPin));
+    // Report actual input values in the MQTT status message
+    if (mqttManager) {
+      mqttManager->updateInputs(gateLights, gateLock, externalRelay, photoEye);
+    }
 
-    Serial.print("ExternalRelay: ");
-    Serial.println(digitalRead(config.externalRelayPin));
+  return true; // Repeat the timer
+}
 
-    Serial.print("PhotoEye:      ");
-    Serial.println(digitalRead(config.photoEyePin));
 
-    // Serial.print("Gatelight debounce: ");
-    // Serial.println(gateLightsButton.isPressed());
+// Timer callback for reporting connection status and loop latency
+bool reportConnectionStatusCallback(void *) {
+  switch (linkManager.getState()) {
+    case LINK_ETHERNET:
+      LOG_INFO("[LINK] Connected to Ethernet");
+      break;
+    case LINK_WIFI:
+      LOG_INFO("[LINK] Connected to Wi-Fi");
+      break;
+    case LINK_WIFI_CONNECTING:
+      LOG_INFO("[LINK] Connecting to Wi-Fi...");
+      break;
+    default:
+      LOG_WARN("[LINK] Not connected");
+      break;
+  }
 
-    TempAndHumidity  data = dhtSensor.getTempAndHumidity();
+  // Loop period histograms since boot; the control task's max is its jitter bound
+  if (controlTask) {
+    controlTask->getLoopHistogram().print("control", Serial);
+  }
+  networkLoopHistogram.print("network", Serial);
 
-    if (dhtSensor.getStatus() != 0) {
-      Serial.println("DHT22 error status: " + String(dhtSensor.getStatusString()));
-    } else {
-      Serial.println("Temp:          " + String(data.temperature, 2) + "°C");
-      Serial.println("Humidity:      " + String(data.humidity, 1) + "%");
-    }
+  // Status delivery: anything dropped or expired was lost
+  if (mqttManager) {
+    // Log records take four arguments: delivery and loss, then latency
+    OutboxStats stats = mqttManager->outboxStats();
+    LOG_INFO("[MQTT] Outbox: %u delivered, %u pending, %u dropped, %u expired",
+             stats.delivered, stats.pending, stats.dropped, stats.expired);
+    LOG_INFO("[MQTT] Outbox: %u retransmits, latency %u ms last / %u ms mean / %u ms max",
+             stats.retransmits, stats.lastLatencyMs, stats.meanLatencyMs, stats.maxLatencyMs);
+  }
 
   return true; // Repeat the timer
 }
 
+// HTTP gate command: the last path segment is parsed like an MQTT payload
+void handleGateRoute(HttpRequest &request, void *) {
+  // Indexed by GateCommand
+  static const char *const REPLIES[] = {
+    "Gate opening...", "Gate closing...", "Gate stopping...", "Gate toggling..."
+  };
+
+  // /gate/<command> or /gate/<index>/<command>
+  const char *uri = request.path();
+  const char *name = strrchr(uri, '/') + 1;
+  const char *segment = uri + 6;  // After "/gate/"
+  uint8_t gateIndex = 0;
+  if (name > segment && !parseGateIndex(segment, name - 1 - segment, gateIndex)) {
+    request.send(404, "text/plain", "Unknown gate");
+    return;
+  }
+  GateCommand command;
+  switch (dispatchGateCommand(controlTask, name, strlen(name), COMMAND_SOURCE_HTTP, gateIndex, command)) {
+    case COMMAND_QUEUED:
+      request.send(200, "text/plain", REPLIES[command]);
+      break;
+    case COMMAND_UNKNOWN:
+      request.send(404, "text/plain", "Unknown gate command");
+      break;
+    case COMMAND_UNKNOWN_GATE:
+      request.send(404, "text/plain", "Unknown gate");
+      break;
+    case COMMAND_QUEUE_FULL:
+      request.send(503, "text/plain", "Command queue full");
+      break;
+  }
+}
 
-// Timer callback for connection checking
-bool checkConnectionCallback(void *) {
-  connectionStatus = checkConnection();
-  return true; // Repeat the timer
+// /metrics body: one exposition section per piece
+bool streamMetrics(HttpBody &body, uint32_t &section, uint32_t, void *) {
+  return metrics.writePrometheus(section, HttpBody::sink, &body);
 }
 
-// Timer callback for reporting connection status
-bool reportConnectionStatusCallback(void *) {
-  if (connectionStatus == 1) {
-    Serial.println("Connected to Ethernet");
-  }
-  else if (connectionStatus == 2) {
-    Serial.println("Connected to Wi-Fi");
+// /journal body: the CSV header, then batches of records up to the
+// X-Journal-Last cursor taken when the request arrived
+bool streamJournal(HttpBody &body, uint32_t &since, uint32_t until, void *) {
+  if (body.piece() == 0) {
+    body.write(JOURNAL_CSV_HEADER, strlen(JOURNAL_CSV_HEADER));
   }
-  else {
-    Serial.println("Not Connected");
+  uint32_t last = journal.streamCsv(since, until, JOURNAL_HTTP_BATCH, HttpBody::sink, &body);
+  bool more = last != since && last < until;
+  since = last;
+  return more;
+}
+
+// /events: Server-Sent Events stream. A new subscriber first gets the
+// current state of every gate and the inputs, then every transition and
+// input change as it happens
+void handleEventsRoute(HttpRequest &request, void *) {
+  char initial[512];
+  size_t length = 0;
+  char json[96];
+  for (uint8_t i = 0; i < Gate::GATE_COUNT; i++) {
+    snprintf(json, sizeof(json), "{\"gate\":%u,\"state\":\"%s\"}", i, gateStateName(streamedStates[i]));
+    length += EventStream::format(initial + length, sizeof(initial) - length, "state", json, 0);
   }
+  formatInputsJson(streamedInputs, json, sizeof(json));
+  length += EventStream::format(initial + length, sizeof(initial) - length, "inputs", json, 0);
+  request.subscribe(events, initial, length);
+}
+
+bool eventHeartbeatCallback(void *) {
+  events.heartbeat();
   return true; // Repeat the timer
 }
 
-int checkConnection() {
-  // Check if Ethernet is available
-  if(ethClient.connected() && (Ethernet.linkStatus() == LinkON)) {
-    Serial.println("Existing Ethernet connection");
-    activeClient = &ethClient;
-    return 1;
-  }
-  else if (Ethernet.linkStatus() == LinkON) {
-    // Use Ethernet connection
-    Serial.println("Ethernet LINKON");
-    if (!ethClient.connected()) {
-      Serial.println("Connecting via Ethernet...");
-        // beginMicros = micros();
-        WiFi.disconnect();
-        //delay(5000);
-        activeClient = &ethClient;
-        return 1;
+// Input scan timer: debounced changes are pushed to /events subscribers
+// and the MQTT status as soon as they are accepted
+bool scanInputsCallback(void *) {
+  if (inputScanner.sample() || streamedInputs == 0xFF) {
+    uint8_t inputs = readInputs();
+    streamedInputs = inputs;
+    char json[96];
+    formatInputsJson(inputs, json, sizeof(json));
+    events.publish("inputs", json);
+    if (mqttManager) {
+      mqttManager->updateInputs(inputs & STATUS_INPUT_GATE_LIGHTS, inputs & STATUS_INPUT_GATE_LOCK,
+                                inputs & STATUS_INPUT_EXTERNAL_RELAY, inputs & STATUS_INPUT_PHOTO_EYE);
     }
   }
-  // else{
-  //   Serial.println("Not Successfull Ethernet Connection");
-  // }
+  return true; // Repeat the timer
+}
+
+// Input scanner change callback (network task)
+void onInputChange(uint8_t pin, bool level, void *) {
+  LOG_INFO("[INPUT] GPIO %u %s", pin, level ? "HIGH" : "LOW");
+}
 
- if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("Existing Wi-Fi connection");
-    activeClient = &wifiClient;
-    return 2;
+// Pass counter timer: fold the hardware count and the pass durations into
+// the MQTT status (published with the next status message)
+bool passCounterCallback(void *) {
+  passCounter.update();
+  if (mqttManager) {
+    PassStats stats = passCounter.stats();
+    mqttManager->updateTraffic(stats.passes, stats.lastDurationMs);
   }
+  return true; // Repeat the timer
+}
 
-  // Use Wi-Fi connection
-  WiFi.begin("Wokwi-GUEST", "", 6);
-  Serial.println("Connecting via Wi-Fi...");
-  for (int i = 0; i < 50; i++) {
-    if ((WiFi.status() == WL_CONNECTED))
-      Serial.println(" CONNECTED");
-      break;
-    delay(100);
-    Serial.print(".");
+// Pass counter callback (network task): every completed pass to /events
+void onPass(uint32_t durationMs, void *) {
+  char json[64];
+  snprintf(json, sizeof(json), "{\"passes\":%lu,\"duration_ms\":%lu}",
+           (unsigned long)passCounter.passes(), (unsigned long)durationMs);
+  events.publish("pass", json);
+
+  LOG_INFO("[PASS] Photo eye pass %u, beam interrupted %u ms", passCounter.passes(), durationMs);
+}
+
+// Climate sensor callback (network task): every finished reading goes to
+// the MQTT status; a stale reading is reported as null
+void onClimateReading(const ClimateReading &reading, void *) {
+  if (mqttManager) {
+    mqttManager->updateClimate(reading.temperature, reading.humidity, reading.valid);
   }
+}
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("Connected to Wi-Fi ");
-    // Serial.println(WiFi.localIP());
-    // Additional Wi-Fi initialization if needed
-    activeClient = &wifiClient;
-    return 2;
+#if LOG_TCP_PORT
+// Log sink (log task): a new connection replaces the previous one and is
+// picked up with the next line; a slow client only holds up the log task
+void tcpLogSink(const char *line, size_t length, void *) {
+  if (logServer.hasClient()) {
+    logClient.stop();
+    logClient = logServer.accept();
   }
-  else{
-    Serial.println("Wi-Fi not Connected");
+  if (logClient.connected()) {
+    logClient.write((const uint8_t *)line, length);
   }
+}
+#endif
+
+// Debounced discrete inputs as STATUS_INPUT_* bits
+uint8_t readInputs() {
+  uint8_t inputs = 0;
+  if (inputScanner.level(BoardPolicy::PIN_GATE_LIGHTS)) inputs |= STATUS_INPUT_GATE_LIGHTS;
+  if (inputScanner.level(BoardPolicy::PIN_GATE_LOCK)) inputs |= STATUS_INPUT_GATE_LOCK;
+  if (inputScanner.level(BoardPolicy::PIN_EXTERNAL_RELAY)) inputs |= STATUS_INPUT_EXTERNAL_RELAY;
+  if (inputScanner.level(BoardPolicy::PIN_PHOTO_EYE)) inputs |= STATUS_INPUT_PHOTO_EYE;
+  return inputs;
+}
+
+void formatInputsJson(uint8_t inputs, char *json, size_t size) {
+  snprintf(json, size, "{\"gate_lights\":%d,\"gate_lock\":%d,\"external_relay\":%d,\"photo_eye\":%d}",
+           (inputs & STATUS_INPUT_GATE_LIGHTS) != 0, (inputs & STATUS_INPUT_GATE_LOCK) != 0,
+           (inputs & STATUS_INPUT_EXTERNAL_RELAY) != 0, (inputs & STATUS_INPUT_PHOTO_EYE) != 0);
+}
+
+// LittleFS file holding one gate's learned travel time
+void travelEstimatePath(uint8_t gateIndex, char *path, size_t size) {
+  if (gateIndex == 0) {
+    snprintf(path, size, "/travel.bin");
+  } else {
+    snprintf(path, size, "/travel%u.bin", gateIndex);
+  }
+}
+
+// Link manager action: begin a WiFi attempt (returns immediately)
+void startWifi() {
+  WiFi.begin("Wokwi-GUEST", "", 6);
+  Serial.println("[WiFi] Connecting via Wi-Fi...");
+}
 
-  activeClient = nullptr;
-  return 0;
+// Link manager action: drop WiFi while Ethernet is up
+void stopWifi() {
+  WiFi.disconnect();
+  Serial.println("[WiFi] Wi-Fi disconnected, using Ethernet");
 }
 
 // ============================================================================
 // MAIN LOOP
 // ============================================================================
+// All work runs in the control and network tasks started by setup()
 void loop() {
+  vTaskDelete(NULL);
+}
 
-    static unsigned long lastUpdate = 0;
-
-    // Update button state every 1ms
-    if (millis() - lastUpdate >= 1) {
-        lastUpdate = millis();
-        // gateLightsButton.update();
-        // gateLockButton.update();
-        // externalRelayButton.update();
-        // photoEyeButton.update();    
+// ============================================================================
+// NETWORK TASK
+// ============================================================================
+void networkTask(void *) {
+  for (;;) {
+    uint32_t waitMs = networkLoop();
+
+    // Sleep until the next deadline or a gate state notification; sockets
+    // are polled at least every NETWORK_TASK_MAX_WAIT_MS
+    if (waitMs > NETWORK_TASK_MAX_WAIT_MS) {
+      waitMs = NETWORK_TASK_MAX_WAIT_MS;
     }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+  }
+}
 
+// Control task state listener: deliver gate changes without waiting for the poll
+void wakeNetworkTask(void *) {
+  if (networkTaskHandle) {
+    xTaskNotifyGive(networkTaskHandle);
+  }
+}
 
+// One network iteration; returns the milliseconds until the next deadline
+uint32_t networkLoop() {
 
-  // Connection status is now reported by timer callback every 2 seconds
-  if (activeClient && connectionStatus > 0) {
-
-    // static unsigned long lastNetworkUpdate = 0;
-    // if (millis() - lastNetworkUpdate >= 500) {
-    //     lastNetworkUpdate = millis(); 
-    //     Serial.println("Active Network Loop!");
-    // }
+  networkLoopHistogram.tick();
+  unsigned long loopStart = micros();
 
-    server.handleClient();
-    ElegantOTA.loop();
+  // Apply network events and select the active link (never blocks)
+  linkManager.update();
+  NetworkClient* activeClient = linkManager.getActiveClient();
 
-    // Update MQTT manager (Requirements 7.1, 7.2, 7.3, 7.4)
+  // Gate state changes reported by the control task
+  GateSnapshot snapshot;
+  while (controlTask && controlTask->pollState(snapshot)) {
     if (mqttManager) {
-      mqttManager->setClient(activeClient);
-      mqttManager->update();
+      mqttManager->updateGateState(snapshot);
     }
+    streamedStates[snapshot.gate] = snapshot.state;
+  }
 
-    // mqttClient.setClient(*activeClient);
-    // if (!mqttClient.connected()) {
-    //   mqttReconnect();
-    // }
-    // mqttClient.loop();
+  // Every transition goes to the flash journal (off the control task)
+  // and, serialized once, to the /events subscribers
+  GateTransition transition;
+  while (controlTask && controlTask->pollTransition(transition)) {
+    journal.append(transition);
+    char json[112];
+    snprintf(json, sizeof(json), "{\"gate\":%u,\"from\":\"%s\",\"to\":\"%s\",\"source\":\"%s\",\"uptime_ms\":%lu}",
+             transition.gate, gateStateName(transition.from), gateStateName(transition.to),
+             commandSourceName(transition.source), (unsigned long)transition.timestamp);
+    events.publish("transition", json);
   }
 
-  unsigned long loopStart = millis();
+  // Persist a gate's travel estimate whenever a close added a sample
+  for (uint8_t i = 0; gate && filesystemMounted && i < Gate::GATE_COUNT; i++) {
+    TravelEstimate travel = gate->travelEstimator(i).estimate();
+    if (travel.samples != savedTravelSamples[i]) {
+      savedTravelSamples[i] = travel.samples;
+      char path[16];
+      travelEstimatePath(i, path, sizeof(path));
+      if (!gate->travelEstimator(i).save(LittleFS, path)) {
+        LOG_ERROR("[ERROR] Failed to save travel estimate for gate %u", i);
+      }
+    }
+  }
 
-  // Handle button input with debouncing
-  // handleButtonInput();
+  // Connection status is now reported by timer callback every 5 seconds
+  if (activeClient) {
 
-  // Update gate controller
-  if (gate) {
-    gate->update();
+    {
+      CycleTimer timer(metrics.subsystem(SUBSYSTEM_HTTP));
+      server.update();
+    }
+    otaServer.handleClient();
+    ElegantOTA.loop();
 
-    // Check for gate state changes and update LEDs
-    GateState currentState = gate->getState();
-    if (currentState != previousGateState) {
-      if (ledManager) {
-        ledManager->setStatus(currentState);
-      }
-      previousGateState = currentState;
+    // Update MQTT manager (Requirements 7.1, 7.2, 7.3, 7.4)
+    if (mqttManager) {
+      CycleTimer timer(metrics.subsystem(SUBSYSTEM_MQTT));
+      mqttManager->setClient(activeClient);
+      mqttManager->update();
     }
   }
 
-  // Update LED manager
-  if (ledManager) {
-    ledManager->update();
+  // Run due periodic checks and reports
+  uint32_t waitMs;
+  {
+    CycleTimer timer(metrics.subsystem(SUBSYSTEM_NETWORK_TIMERS));
+    waitMs = networkScheduler.tick();
+  }
+  if (mqttManager) {
+    uint32_t publishWaitMs = mqttManager->msUntilNextPublish();
+    if (publishWaitMs < waitMs) {
+      waitMs = publishWaitMs;
+    }
+  }
+  if (activeClient) {
+    // Pending response pieces, pipelined requests and connection timeouts
+    uint32_t httpWaitMs = server.msUntilNextEvent();
+    if (httpWaitMs < waitMs) {
+      waitMs = httpWaitMs;
+    }
   }
-
-  // Tick main timer for any scheduled tasks
-  mainTimer.tick();
-
-  // Calculate loop execution time
-  unsigned long loopTime = millis() - loopStart;
 
   // Ensure loop completes within 1 second (Requirement 5.2)
-  if (loopTime > 1000) {
-    Serial.print("[WARNING] Loop execution time exceeded 1 second: ");
-    Serial.print(loopTime);
-    Serial.println("ms");
+  unsigned long loopTime = micros() - loopStart;
+  if (loopTime > 1000000) {
+    LOG_WARN("[WARNING] Network loop execution time exceeded 1 second: %lu ms", loopTime / 1000);
   }
 
-  // Small delay to prevent excessive CPU usage
-  delay(10);
+  return waitMs;
 }
 
 // ============================================================================
@@ -614,29 +943,20 @@ void loop() {
 // ============================================================================
 void initializeGPIO() {
 
-  // Configure LED outputs
-  pinMode(config.redLedPin, OUTPUT);
-  pinMode(config.greenLedPin, OUTPUT);
-  digitalWrite(config.redLedPin, LOW);
-  digitalWrite(config.greenLedPin, LOW);
-
-  // Configure relay outputs
-  pinMode(config.openRelayPin, OUTPUT);
-  pinMode(config.closeRelayPin, OUTPUT);
-  pinMode(config.stopRelayPin, OUTPUT);
-  digitalWrite(config.openRelayPin, LOW);
-  digitalWrite(config.closeRelayPin, LOW);
-  digitalWrite(config.stopRelayPin, LOW);
-  
-  // Configure sensor input with internal pull-up  
-  pinMode(config.gateLightsPin, INPUT_PULLUP);
-  pinMode(config.gateLockPin, INPUT_PULLUP);
-  pinMode(config.externalRelayPin, INPUT);
-  pinMode(config.photoEyePin, INPUT);
-
-  // Configure sensor input with internal pull-up
-  pinMode(config.sensor1Pin, INPUT);
-  pinMode(config.sensor2Pin, INPUT);
+  // Relays and LEDs start released; OUTPUT_PINS covers every gate's relays
+  for (uint8_t pin : BoardPolicy::OUTPUT_PINS) {
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, LOW);
+  }
+
+  // Gate controller inputs, position sensors and optional sensors
+  for (uint8_t pin : BoardPolicy::INPUT_PINS) {
+    bool pullup = false;
+    for (uint8_t pullupPin : BoardPolicy::PULLUP_PINS) {
+      pullup = pullup || pullupPin == pin;
+    }
+    pinMode(pin, pullup ? INPUT_PULLUP : INPUT);
+  }
   
 }
 
@@ -717,15 +1037,26 @@ void printConfigSummary() {
   // Serial.println(config.statusTopic);
   // Serial.print("  Command Topic: ");
   // Serial.println(config.commandTopic);
+  Serial.print("  Gates: ");
+  Serial.println(Gate::GATE_COUNT);
   Serial.print("  Gate Operation Time: ");
-  Serial.print(config.gateOperationTime);
-  Serial.println("ms");
+  Serial.print(BoardPolicy::OPERATION_TIME_MS);
+  Serial.println("ms (until learned)");
   Serial.print("  Relay Pulse Time: ");
-  Serial.print(config.relayPulseTime);
+  Serial.print(BoardPolicy::RELAY_PULSE_MS);
   Serial.println("ms");
-  Serial.print("  Publish Interval: ");
+  Serial.print("  Publish Heartbeat: ");
   Serial.print(config.publishInterval);
   Serial.println("ms");
+  Serial.print("  Publish Hold-off: ");
+  Serial.print(config.publishHoldoff);
+  Serial.println("ms");
+  Serial.print("  Status Format: ");
+  Serial.println(statusFormatName(config.statusFormat));
+  Serial.print("  Status QoS: ");
+  Serial.println(config.statusQos);
+  Serial.print("  Status Retain: ");
+  Serial.println(config.statusRetain ? "on" : "off");
 }
 
 // ============================================================================
@@ -738,5 +1069,5 @@ void printConfigSummary() {
  * @return NetworkClient* Pointer to active client, or nullptr if no connection
  */
 NetworkClient* getActiveClient() {
-  return activeClient;
+  return linkManager.getActiveClient();
 }
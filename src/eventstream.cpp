@@ -0,0 +1,70 @@
+/**
+ * EventStream.cpp - ESP32 Swing Gate Controller Server-Sent Events buffer
+ *
+ * Implementation of the shared event ring.
+ */
+
+#include "eventstream.h"
+
+// Positions are reduced modulo the ring size; a power of two keeps that
+// consistent when the 32-bit positions wrap
+static_assert((EventStream::BUFFER_SIZE & (EventStream::BUFFER_SIZE - 1)) == 0,
+              "Event ring size must be a power of two");
+
+// ============================================================================
+// EVENT STREAM CLASS IMPLEMENTATION
+// ============================================================================
+
+EventStream::EventStream() : _head(0), _lastId(0) {
+}
+
+bool EventStream::publish(const char* event, const char* data) {
+    char text[EVENT_SIZE];
+    size_t length = format(text, sizeof(text), event, data, _lastId + 1);
+    if (length == 0) {
+        Serial.print("[ERROR] Event too large for the event stream, dropped: ");
+        Serial.println(event);
+        return false;
+    }
+    _lastId++;
+    _append(text, length);
+    return true;
+}
+
+void EventStream::heartbeat() {
+    static const char COMMENT[] = ":\n\n";
+    _append(COMMENT, sizeof(COMMENT) - 1);
+}
+
+size_t EventStream::format(char* buffer, size_t size, const char* event, const char* data, uint32_t id) {
+    int length;
+    if (id) {
+        length = snprintf(buffer, size, "id: %lu\nevent: %s\ndata: %s\n\n", (unsigned long)id, event, data);
+    } else {
+        length = snprintf(buffer, size, "event: %s\ndata: %s\n\n", event, data);
+    }
+    return length > 0 && (size_t)length < size ? length : 0;
+}
+
+size_t EventStream::read(uint32_t cursor, const char*& data) const {
+    if (cursor == _head || lapped(cursor)) {
+        return 0;
+    }
+    size_t offset = cursor % BUFFER_SIZE;
+    size_t pending = _head - cursor;
+    size_t contiguous = BUFFER_SIZE - offset;
+    data = _buffer + offset;
+    return pending < contiguous ? pending : contiguous;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+void EventStream::_append(const char* data, size_t length) {
+    size_t offset = _head % BUFFER_SIZE;
+    size_t first = length < BUFFER_SIZE - offset ? length : BUFFER_SIZE - offset;
+    memcpy(_buffer + offset, data, first);
+    memcpy(_buffer, data + first, length - first);
+    _head += length;
+}
@@ -0,0 +1,84 @@
+/**
+ * EventStream.h - ESP32 Swing Gate Controller Server-Sent Events buffer
+ *
+ * Shared ring of pre-serialized SSE events. publish() formats an event into
+ * the ring once; every subscriber then sends the same bytes from its own
+ * cursor, so a subscriber costs a 32-bit position rather than a copy of the
+ * events. Cursors are absolute byte positions: a subscriber more than
+ * BUFFER_SIZE bytes behind the head has lost events and must be dropped.
+ *
+ * Owned by the network task; not thread-safe.
+ */
+
+#ifndef EventStream_h
+#define EventStream_h
+
+#include "Arduino.h"
+
+// ============================================================================
+// EVENT STREAM CLASS DECLARATION
+// ============================================================================
+class EventStream {
+public:
+    static const size_t BUFFER_SIZE = 2048;     // Bytes of recent events kept for subscribers
+    static const size_t EVENT_SIZE = 256;       // Largest event including SSE framing
+
+    EventStream();
+
+    /**
+     * Serialize an event into the ring
+     * @param event Event name (SSE "event:" field)
+     * @param data Single-line payload (SSE "data:" field)
+     * @return false if the event is larger than EVENT_SIZE and was dropped
+     */
+    bool publish(const char* event, const char* data);
+
+    /**
+     * Append an SSE comment line, which keeps idle connections (and proxies)
+     * alive and lets dead subscribers be detected by a failing send
+     */
+    void heartbeat();
+
+    /**
+     * Format one event in SSE wire format
+     * @param buffer Destination buffer
+     * @param size Size of destination buffer in bytes
+     * @param event Event name
+     * @param data Single-line payload
+     * @param id Event id, or 0 to omit the "id:" field
+     * @return Length written (not NUL-terminated), or 0 if it did not fit
+     */
+    static size_t format(char* buffer, size_t size, const char* event, const char* data, uint32_t id);
+
+    /**
+     * Position after the newest byte; new subscribers start here
+     */
+    uint32_t head() const { return _head; }
+
+    /**
+     * Contiguous unsent bytes at a subscriber's cursor
+     * @param cursor Subscriber position
+     * @param data Receives a pointer into the ring
+     * @return Number of bytes at data (0 when caught up or lapped)
+     */
+    size_t read(uint32_t cursor, const char*& data) const;
+
+    /**
+     * Whether events at a cursor were overwritten before being sent
+     */
+    bool lapped(uint32_t cursor) const { return _head - cursor > BUFFER_SIZE; }
+
+    /**
+     * Id of the newest published event (0 before the first)
+     */
+    uint32_t lastId() const { return _lastId; }
+
+private:
+    char _buffer[BUFFER_SIZE];
+    uint32_t _head;         // Total bytes written; _buffer[_head % BUFFER_SIZE] is next
+    uint32_t _lastId;
+
+    void _append(const char* data, size_t length);
+};
+
+#endif // EventStream_h
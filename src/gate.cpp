@@ -1,439 +1,727 @@
 /**
  * Gate.cpp - ESP32 Swing Gate Controller Implementation
- * 
- * Basic implementation stub for the Gate class.
- * This provides the foundation structure that will be expanded
- * in subsequent tasks.
+ *
+ * Implementation of the GateController template. Pins and timings come
+ * from the board policy as compile-time constants; the template is
+ * explicitly instantiated for BoardPolicy at the end of this file.
  */
 
 #include "Arduino.h"
 #include "gate.h"
+#include "logger.h"
 
 // ============================================================================
-// GPIO PIN DEFINITIONS (extern declarations from header)
+// STATE NAMES
 // ============================================================================
-// const int PIN_LED_GATE_CLOSED = 17;  // Red LED: closed (blink = closing)
-// const int PIN_LED_GATE_OPEN = 5;    // Green LED: open (blink = opening)
-
-const int PIN_RELAY_GATE_CLOSE = 12;  // Close relay control
-const int PIN_RELAY_GATE_OPEN = 15;   // Open relay control
-const int PIN_RELAY_GATE_STOP = 14;   // Stop relay control
-
-const int PIN_SENSOR_GATE_OPEN = 33; // Gate position sensor
-const int PIN_BUTTON = 35;           // Manual control button
+const char* gateStateName(GateState state) {
+    switch (state) {
+        case GATE_UNKNOWN:  return "UNKNOWN";
+        case GATE_CLOSED:   return "CLOSED";
+        case GATE_OPENING:  return "OPENING";
+        case GATE_OPEN:     return "OPEN";
+        case GATE_CLOSING:  return "CLOSING";
+        default:            return "INVALID";
+    }
+}
 
 // ============================================================================
 // GATE CLASS IMPLEMENTATION
 // ============================================================================
 
-Gate::Gate() : 
-    _currentState(GATE_UNKNOWN),
-    _previousState(GATE_UNKNOWN),
-    _sensorState(false),
-    _previousSensorState(false),
-    _lastStateChange(0),
-    _lastSensorRead(0),
-    _relayActivationTime(0),
-    _relayActive(false),
-    _initialized(false)
+template <typename Policy>
+GateController<Policy>::GateController(Scheduler& scheduler) :
+    _scheduler(scheduler),
+    _relayRelease(NO_SCHEDULE),
+    _sensorState(0),
+    _pendingSensorState(0),
+    _sensorEdgePending(0),
+    _relayActive(0),
+    _closeTimed(0),
+    _motionLamp(0),
+    _motionActive(0),
+    _motionSeen(0),
+    _lockEngaged(0),
+    _initialized(false),
+    _stateCallback(nullptr),
+    _stateCallbackContext(nullptr)
 {
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        _currentState[gate] = GATE_UNKNOWN;
+        _previousState[gate] = GATE_UNKNOWN;
+        _lastStateChange[gate] = 0;
+        _lastSensorRead[gate] = 0;
+        _lastSensorEdgeUs[gate] = 0;
+        _relayActivationTime[gate] = 0;
+        _closeStart[gate] = 0;
+        _droppedSensorEdges[gate] = 0;
+        _motionStart[gate] = 0;
+        _lastMotionEdge[gate] = 0;
+        _sensorEdges[gate].setPin(Policy::GATE_POSITION_SENSOR[gate]);
+        if (_hasMotionInput(gate)) {
+            _motionEdges[gate].setPin(Policy::GATE_MOTION_INPUT[gate]);
+        }
+        _travel[gate].setDefault(Policy::OPERATION_TIME_MS);
+    }
     Serial.println("[GATE] Gate controller constructor called");
 }
 
-Gate::~Gate() {
+template <typename Policy>
+GateController<Policy>::~GateController() {
+    // The interrupts hold a pointer into this object
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        _sensorEdges[gate].end();
+        _motionEdges[gate].end();
+    }
     Serial.println("[GATE] Gate controller destructor called");
 }
 
-void Gate::initialize() {
-    Serial.println("[GATE] Initializing gate controller...");
+template <typename Policy>
+void GateController<Policy>::initialize() {
+    Serial.print("[GATE] Initializing gate controller for ");
+    Serial.print(GATE_COUNT);
+    Serial.println(GATE_COUNT == 1 ? " gate..." : " gates...");
     
     // Note: GPIO pins are already configured in main setup()
-    // Read initial sensor state and determine boot-up state
-    _sensorState = _readSensor();
-    _previousSensorState = _sensorState;
+    uint32_t now = millis();
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        // Start edge capture before the initial read so no edge is missed in between
+        _sensorEdges[gate].begin();
+    
+        // Read initial sensor state
+        bool level = _readSensor(gate);
+        _setBit(_sensorState, gate, level);
+        _setBit(_pendingSensorState, gate, level);
+        _lastStateChange[gate] = now;
+        _lastSensorRead[gate] = now;
+    
+        // Fusion inputs: a light already on at boot means the gate is moving
+        if (_hasMotionInput(gate)) {
+            _motionEdges[gate].begin();
+            bool lamp = digitalRead(Policy::GATE_MOTION_INPUT[gate]) == Policy::FUSION_INPUT_ACTIVE_LEVEL;
+            _setBit(_motionLamp, gate, lamp);
+            _setBit(_motionActive, gate, lamp);
+            _motionStart[gate] = now;
+            _lastMotionEdge[gate] = now;
+        }
+        if (_hasLockInput(gate)) {
+            _setBit(_lockEngaged, gate,
+                    digitalRead(Policy::GATE_LOCK_INPUT[gate]) == Policy::FUSION_INPUT_ACTIVE_LEVEL);
+        }
+    }
     
     _initialized = true;
-    _lastStateChange = millis();
-    _lastSensorRead = millis();
     
     // Handle boot-up state detection
-    _handleBootupState();
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        _handleBootupState(gate);
+    }
     
     Serial.println("[GATE] Gate controller initialized successfully");
 }
 
-void Gate::update() {
+template <typename Policy>
+void GateController<Policy>::update() {
     if (!_initialized) return;
     
-    // Tick timers first
-    _stateTimer.tick();
-    _relayTimer.tick();
-    
-    // Read sensor state with debouncing
-    unsigned long currentTime = millis();
-    // if (currentTime - _lastSensorRead >= 50) { // 50ms debounce
-    //     bool newSensorState = _readSensor();
-    //     if (newSensorState != _previousSensorState) {
-    //         _sensorState = newSensorState;
-    //         _previousSensorState = newSensorState;
-    //         _lastSensorRead = currentTime;
-            
-    //         Serial.print("[SENSOR] Sensor state changed to: ");
-    //         Serial.println(_sensorState ? "HIGH (closed)" : "LOW (open/moving)");
-    //     }
-    // }
-    
-    // Safety check: ensure relay is deactivated after 500ms even if timer fails
-    if (_relayActive && (currentTime - _relayActivationTime >= 500)) {
-        Serial.println("[SAFETY] Relay timeout - forcing deactivation");
-        _deactivateRelays();
-    }
-    
-    // State machine logic
-    switch (_currentState) {
-        case GATE_UNKNOWN:
-            // Determine initial state based on sensor
-            if (_sensorState) {
-                // Sensor HIGH - gate is closed (instant detection)
-                _updateGateState(GATE_CLOSED);
-            } else {
-                // Sensor is LOW - could be open, opening, or closing
-                // Wait for 20 seconds to determine stable state
-                if (currentTime - _lastStateChange >= 20000) {
-                    if (_sensorState) {
-                        // Sensor HIGH after 20s - gate is closed (instant)
-                        _updateGateState(GATE_CLOSED);
-                    } else {
-                        // Sensor LOW after 20s - gate is open
-                        _updateGateState(GATE_OPEN);
-                    }
-                }
-            }
-            break;
-            
-        case GATE_CLOSED:
-            // Gate is closed - sensor should be HIGH
-            if (!_sensorState) {
-                // Sensor went LOW - gate is no longer closed
-                // Since we were closed, assume opening
-                _updateGateState(GATE_OPENING);
-            }
-            break;
-            
-        case GATE_OPENING:
-            // Check for instant closed state detection (sensor HIGH)
-            if (_sensorState) {
-                // Sensor HIGH - gate is closed (instant detection per Requirement 2.3)
-                _updateGateState(GATE_CLOSED);
-            } else if (currentTime - _lastStateChange >= 20000) {
-                // Gate takes ~20 seconds to fully open (Requirement 2.3)
-                // Sensor LOW after 20s - gate is now fully open
-                _updateGateState(GATE_OPEN);
-            }
-            break;
-            
-        case GATE_OPEN:
-            // Gate is open - sensor should be LOW
-            if (_sensorState) {
-                // Sensor HIGH - gate is closed (instant detection per Requirement 2.3 & 2.6)
-                // This handles manual closure or external factors closing the gate
-                _updateGateState(GATE_CLOSED);
-            }
-            break;
-            
-        case GATE_CLOSING:
-            // Check for instant closed state detection (sensor HIGH)
-            if (_sensorState) {
-                // Sensor HIGH - gate is closed (instant detection per Requirement 2.3)
-                _updateGateState(GATE_CLOSED);
-            } else if (currentTime - _lastStateChange >= 20000) {
-                // Gate closing - check if 20 seconds elapsed
-                // Sensor LOW after 20s - gate is still open (operation failed)
-                _updateGateState(GATE_OPEN);
-            }
-            break;
+    // One pass over all gates: debounce, relay safety and state machine
+    uint32_t currentTime = millis();
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        _updateGate(gate, currentTime);
     }
 }
 
-void Gate::toggle() {
-    Serial.println("[BUTTON] Button pressed - Gate command: TOGGLE");
+template <typename Policy>
+void GateController<Policy>::toggle(uint8_t gate) {
+    LOG_INFO("[BUTTON] Button pressed - Gate command: TOGGLE");
     
-    if (!_initialized) {
-        Serial.println("[ERROR] Gate not initialized, ignoring toggle command");
+    if (!_initialized || gate >= GATE_COUNT) {
+        LOG_ERROR("[ERROR] Gate not initialized, ignoring toggle command");
         return;
     }
     
     // Prevent multiple activations during gate movement
-    if (isMoving()) {
-        Serial.println("[GATE] Gate is moving, ignoring toggle command");
+    if (isMoving(gate)) {
+        LOG_INFO("[GATE] Gate is moving, ignoring toggle command");
         return;
     }
     
     // Prevent activation while relay is active
-    if (_relayActive) {
-        Serial.println("[GATE] Relay is active, ignoring toggle command");
+    if (_relayActive & _bit(gate)) {
+        LOG_INFO("[GATE] Relay is active, ignoring toggle command");
         return;
     }
     
-    switch (_currentState) {
+    switch (_currentState[gate]) {
         case GATE_CLOSED:
-            openGate();
+            openGate(gate);
             break;
         case GATE_OPEN:
-            closeGate();
+            closeGate(gate);
             break;
         case GATE_UNKNOWN:
-            Serial.println("[GATE] Gate state unknown - attempting to determine state and operate");
+            LOG_INFO("[GATE] Gate state unknown - attempting to determine state and operate");
             // In unknown state, try to determine current state based on sensor and operate accordingly
-            if (_sensorState) {
+            if (_sensorState & _bit(gate)) {
                 // Sensor HIGH - gate is closed, so open it
-                Serial.println("[GATE] Sensor HIGH in unknown state - treating as closed, opening gate");
-                _updateGateState(GATE_CLOSED);
-                openGate();
+                LOG_INFO("[GATE] Sensor HIGH in unknown state - treating as closed, opening gate");
+                _updateGateState(gate, GATE_CLOSED);
+                openGate(gate);
             } else {
                 // Sensor LOW - gate is likely open, so close it
-                Serial.println("[GATE] Sensor LOW in unknown state - treating as open, closing gate");
-                _updateGateState(GATE_OPEN);
-                closeGate();
+                LOG_INFO("[GATE] Sensor LOW in unknown state - treating as open, closing gate");
+                _updateGateState(gate, GATE_OPEN);
+                closeGate(gate);
             }
             break;
         default:
-            Serial.println("[GATE] Gate is moving, toggle ignored");
+            LOG_INFO("[GATE] Gate is moving, toggle ignored");
             break;
     }
 }
 
 
-void Gate::stopGate() {
-    Serial.println("[BUTTON] Button pressed - Gate command: STOP");
+template <typename Policy>
+void GateController<Policy>::stopGate(uint8_t gate) {
+    LOG_INFO("[BUTTON] Button pressed - Gate command: STOP");
     
-    if (!_initialized) {
-        Serial.println("[ERROR] Gate not initialized, ignoring STOP command");
+    if (!_initialized || gate >= GATE_COUNT) {
+        LOG_ERROR("[ERROR] Gate not initialized, ignoring STOP command");
         return;
     }
     
     // Prevent activation while relay is active
-    if (_relayActive) {
-        Serial.println("[GATE] Relay is active, ignoring STOP command");
+    if (_relayActive & _bit(gate)) {
+        LOG_INFO("[GATE] Relay is active, ignoring STOP command");
         return;
     }
     
-    // Activate open relay for 500ms
-    _activateRelay(PIN_RELAY_GATE_STOP, "Stop");
+    // Some gates have no stop input (pedestrian gate on the expansion)
+    if (Policy::GATE_RELAY_STOP[gate] == NO_PIN) {
+        LOG_WARN("[GATE] Gate %u has no stop relay, ignoring STOP command", gate);
+        return;
+    }
     
-    // Update state to opening
-    // _updateGateState(GATE_OPENING);
+    // Activate stop relay for one pulse
+    _activateRelay(gate, Policy::GATE_RELAY_STOP[gate], "Stop");
 }
 
-void Gate::openGate() {
-    Serial.println("[BUTTON] Button pressed - Gate command: OPEN");
+template <typename Policy>
+void GateController<Policy>::openGate(uint8_t gate) {
+    LOG_INFO("[BUTTON] Button pressed - Gate command: OPEN");
     
-    if (!_initialized) {
-        Serial.println("[ERROR] Gate not initialized, ignoring OPEN command");
+    if (!_initialized || gate >= GATE_COUNT) {
+        LOG_ERROR("[ERROR] Gate not initialized, ignoring OPEN command");
         return;
     }
     
-    // Only allow opening if gate is closed
-    // if (_currentState != GATE_CLOSED) {
-    //     Serial.println("[GATE] Gate is not closed, cannot open");
-    //     return;
-    // }
-    
     // Prevent activation while relay is active
-    if (_relayActive) {
-        Serial.println("[GATE] Relay is active, ignoring OPEN command");
+    if (_relayActive & _bit(gate)) {
+        LOG_INFO("[GATE] Relay is active, ignoring OPEN command");
         return;
     }
     
-    // Activate open relay for 500ms
-    _activateRelay(PIN_RELAY_GATE_OPEN, "Open");
+    // Activate open relay for one pulse
+    _activateRelay(gate, Policy::GATE_RELAY_OPEN[gate], "Open");
     
     // Update state to opening
-    _updateGateState(GATE_OPENING);
+    _updateGateState(gate, GATE_OPENING);
 }
 
-void Gate::closeGate() {
-    Serial.println("[BUTTON] Button pressed - Gate command: CLOSE");
+template <typename Policy>
+void GateController<Policy>::closeGate(uint8_t gate) {
+    LOG_INFO("[BUTTON] Button pressed - Gate command: CLOSE");
     
-    if (!_initialized) {
-        Serial.println("[ERROR] Gate not initialized, ignoring CLOSE command");
+    if (!_initialized || gate >= GATE_COUNT) {
+        LOG_ERROR("[ERROR] Gate not initialized, ignoring CLOSE command");
         return;
     }
     
-    // Only allow closing if gate is open
-    // if (_currentState != GATE_OPEN) {
-    //     Serial.println("[GATE] Gate is not open, cannot close");
-    //     return;
-    // }
-    
     // Prevent activation while relay is active
-    if (_relayActive) {
-        Serial.println("[GATE] Relay is active, ignoring CLOSE command");
+    if (_relayActive & _bit(gate)) {
+        LOG_INFO("[GATE] Relay is active, ignoring CLOSE command");
         return;
     }
     
-    // Activate close relay for 500ms
-    _activateRelay(PIN_RELAY_GATE_CLOSE, "Close");
+    // Activate close relay for one pulse
+    _activateRelay(gate, Policy::GATE_RELAY_CLOSE[gate], "Close");
     
     // Update state to closing
-    _updateGateState(GATE_CLOSING);
+    _updateGateState(gate, GATE_CLOSING);
 }
 
-GateState Gate::getState() const {
-    return _currentState;
+template <typename Policy>
+uint32_t GateController<Policy>::msUntilNextEvent() const {
+    if (!_initialized) {
+        return Policy::IDLE_POLL_MS;
+    }
+    
+    uint32_t currentTime = millis();
+    uint32_t currentTimeUs = micros();
+    uint32_t next = Policy::IDLE_POLL_MS;
+    
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        // Re-sample the sensor fast while the gate may be moving, slowly at rest
+        GateState state = _currentState[gate];
+        bool settled = state == GATE_CLOSED || state == GATE_OPEN;
+        if (!settled && Policy::MOVING_POLL_MS < next) {
+            next = Policy::MOVING_POLL_MS;
+        }
+    
+        // Debounce window of the last captured edge (rounded up to whole ms)
+        if (_sensorEdgePending & _bit(gate)) {
+            uint32_t quiet = currentTimeUs - _lastSensorEdgeUs[gate];
+            uint32_t remaining = quiet >= Policy::SENSOR_DEBOUNCE_US
+                                     ? 0 : (Policy::SENSOR_DEBOUNCE_US - quiet + 999) / 1000;
+            if (remaining < next) next = remaining;
+        }
+    
+        // Travel timeout in UNKNOWN/OPENING/CLOSING
+        if (!settled) {
+            uint32_t limit = _travelLimitMs(gate);
+            uint32_t elapsed = currentTime - _lastStateChange[gate];
+            uint32_t remaining = elapsed >= limit ? 0 : limit - elapsed;
+            if (remaining < next) next = remaining;
+        }
+    
+        // Warning light dark long enough to call the move over
+        if ((_motionActive & ~_motionLamp) & _bit(gate)) {
+            uint32_t elapsed = currentTime - _lastMotionEdge[gate];
+            uint32_t remaining = elapsed >= Policy::MOTION_HOLD_MS ? 0 : Policy::MOTION_HOLD_MS - elapsed;
+            if (remaining < next) next = remaining;
+        }
+    
+        // Relay safety timeout
+        if (_relayActive & _bit(gate)) {
+            uint32_t elapsed = currentTime - _relayActivationTime[gate];
+            uint32_t remaining = elapsed >= Policy::RELAY_PULSE_MS ? 0 : Policy::RELAY_PULSE_MS - elapsed;
+            if (remaining < next) next = remaining;
+        }
+    }
+    
+    return next;
 }
 
-bool Gate::isMoving() const {
-    return (_currentState == GATE_OPENING || _currentState == GATE_CLOSING);
+template <typename Policy>
+void GateController<Policy>::onSensorEdge(EdgeWakeHandler handler, void* arg) {
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        _sensorEdges[gate].setWakeHandler(handler, arg);
+        _motionEdges[gate].setWakeHandler(handler, arg);
+    }
 }
 
-bool Gate::isRelayActive() const {
-    return _relayActive;
+template <typename Policy>
+GateState GateController<Policy>::getState(uint8_t gate) const {
+    return gate < GATE_COUNT ? _currentState[gate] : GATE_UNKNOWN;
 }
 
-String Gate::getStateString() const {
-    switch (_currentState) {
-        case GATE_UNKNOWN:  return "UNKNOWN";
-        case GATE_CLOSED:   return "CLOSED";
-        case GATE_OPENING:  return "OPENING";
-        case GATE_OPEN:     return "OPEN";
-        case GATE_CLOSING:  return "CLOSING";
-        default:            return "INVALID";
-    }
+template <typename Policy>
+bool GateController<Policy>::isMoving(uint8_t gate) const {
+    GateState state = getState(gate);
+    return (state == GATE_OPENING || state == GATE_CLOSING);
+}
+
+template <typename Policy>
+bool GateController<Policy>::isRelayActive(uint8_t gate) const {
+    return gate < GATE_COUNT && (_relayActive & _bit(gate));
+}
+
+template <typename Policy>
+bool GateController<Policy>::getSensorState(uint8_t gate) const {
+    return gate < GATE_COUNT && (_sensorState & _bit(gate));
+}
+
+template <typename Policy>
+String GateController<Policy>::getStateString(uint8_t gate) const {
+    return gateStateName(getState(gate));
+}
+
+template <typename Policy>
+void GateController<Policy>::onStateChange(GateStateCallback callback, void* context) {
+    _stateCallback = callback;
+    _stateCallbackContext = context;
+}
+
+template <typename Policy>
+TravelEstimator& GateController<Policy>::travelEstimator(uint8_t gate) {
+    return _travel[gate < GATE_COUNT ? gate : 0];
 }
 
 // ============================================================================
-// PRIVATE METHODS (Stubs for future implementation)
+// PRIVATE METHODS
 // ============================================================================
 
-void Gate::_updateGateState(GateState newState) {
-    if (_currentState != newState) {
+template <typename Policy>
+void GateController<Policy>::_setBit(GateMask& mask, uint8_t gate, bool value) {
+    if (value) {
+        mask |= _bit(gate);
+    } else {
+        mask &= ~_bit(gate);
+    }
+}
+
+template <typename Policy>
+void GateController<Policy>::_updateGate(uint8_t gate, uint32_t currentTime) {
+    // Drain and debounce captured sensor edges, then the fusion inputs
+    _processSensorEdges(gate);
+    _processFusionInputs(gate, currentTime);
+    
+    // Safety check: ensure relay is deactivated after the pulse time even if the deadline is lost
+    if ((_relayActive & _bit(gate)) && (currentTime - _relayActivationTime[gate] >= Policy::RELAY_PULSE_MS)) {
+        LOG_WARN("[SAFETY] Relay timeout - forcing deactivation");
+        _deactivateRelays(gate);
+    }
+    
+    bool sensorHigh = _sensorState & _bit(gate);
+    bool lockEngaged = _lockEngaged & _bit(gate);
+    
+    // State machine logic
+    switch (_currentState[gate]) {
+        case GATE_UNKNOWN:
+            // Determine initial state based on sensor
+            if (sensorHigh || lockEngaged) {
+                // Sensor HIGH or lock engaged - gate is closed (instant detection)
+                _updateGateState(gate, GATE_CLOSED);
+            } else if (_motionEndedInState(gate)) {
+                // The move in progress at boot has ended away from closed
+                _updateGateState(gate, GATE_OPEN);
+            } else {
+                // Sensor is LOW - could be open, opening, or closing
+                // Wait for a full travel (with margin) to determine stable state
+                if (currentTime - _lastStateChange[gate] >= _travelLimitMs(gate)) {
+                    // Sensor still LOW after any move must have ended - gate is open
+                    _updateGateState(gate, GATE_OPEN);
+                }
+            }
+            break;
+    
+        case GATE_CLOSED:
+            // Gate is closed - sensor should be HIGH
+            if (!sensorHigh) {
+                // Sensor went LOW - gate is no longer closed
+                // Since we were closed, assume opening
+                _updateGateState(gate, GATE_OPENING);
+            } else if (_motionStartedInState(gate)) {
+                // Warning light came on - opening, before the leaf leaves the sensor
+                _updateGateState(gate, GATE_OPENING);
+            }
+            break;
+    
+        case GATE_OPENING:
+            // Check for instant closed state detection (sensor HIGH)
+            if (sensorHigh) {
+                // Sensor HIGH - gate is closed (instant detection per Requirement 2.3),
+                // unless it has not left the closed position yet: the sensor has
+                // not changed since the open began and the light shows (or may
+                // still show) the gate starting
+                bool sensorUnchanged = (int32_t)(_lastSensorRead[gate] - _lastStateChange[gate]) < 0;
+                bool starting = sensorUnchanged && _hasMotionInput(gate) &&
+                                ((_motionActive & _bit(gate)) ||
+                                 currentTime - _lastStateChange[gate] < Policy::MOTION_HOLD_MS);
+                if (!starting) {
+                    _updateGateState(gate, GATE_CLOSED);
+                }
+            } else if (_motionEndedInState(gate)) {
+                // Warning light went dark with the sensor LOW - end of travel
+                _updateGateState(gate, GATE_OPEN);
+            } else if (currentTime - _lastStateChange[gate] >= _travelLimitMs(gate)) {
+                // Sensor LOW after the learned travel time - gate is now fully open
+                _updateGateState(gate, GATE_OPEN);
+            }
+            break;
+    
+        case GATE_OPEN:
+            // Gate is open - sensor should be LOW
+            if (sensorHigh) {
+                // Sensor HIGH - gate is closed (instant detection per Requirement 2.3 & 2.6)
+                // This handles manual closure or external factors closing the gate
+                _updateGateState(gate, GATE_CLOSED);
+            } else if (_motionStartedInState(gate)) {
+                // Warning light came on - an open gate can only be closing
+                _updateGateState(gate, GATE_CLOSING);
+            }
+            break;
+    
+        case GATE_CLOSING:
+            // Check for instant closed state detection (sensor HIGH)
+            if (sensorHigh || lockEngaged) {
+                // Sensor HIGH or lock engaged - gate is closed (instant detection per Requirement 2.3)
+                _updateGateState(gate, GATE_CLOSED);
+            } else if (_motionEndedInState(gate)) {
+                // Warning light went dark short of closed - stopped or
+                // reversed by an obstruction, the gate is open
+                _updateGateState(gate, GATE_OPEN);
+            } else if (currentTime - _lastStateChange[gate] >= _travelLimitMs(gate)) {
+                // Sensor LOW well past the learned travel time - gate is still
+                // open (operation failed)
+                _updateGateState(gate, GATE_OPEN);
+            }
+            break;
+    }
+}
+
+template <typename Policy>
+void GateController<Policy>::_updateGateState(uint8_t gate, GateState newState) {
+    GateState oldState = _currentState[gate];
+    if (oldState != newState) {
         // Validate state transition
-        if (!_isValidStateTransition(_currentState, newState)) {
-            Serial.print("[ERROR] Invalid state transition attempted: ");
-            Serial.print(getStateString());
-            Serial.print(" -> ");
-            
-            // Temporarily set state to get new state string
-            GateState temp = _currentState;
-            _currentState = newState;
-            Serial.println(getStateString());
-            _currentState = temp;
-            
+        if (!isValidGateTransition(oldState, newState)) {
+            LOG_ERROR("[ERROR] Invalid state transition attempted: %s -> %s",
+                      gateStateName(oldState), gateStateName(newState));
             return; // Don't change state if transition is invalid
         }
-        
-        _logStateChange(_currentState, newState);
-        _previousState = _currentState;
-        _currentState = newState;
-        _lastStateChange = millis();
+    
+        _logStateChange(gate, oldState, newState);
+        uint32_t now = millis();
+    
+        // Learn the travel time from closes that start fully open and end on
+        // the sensor, including ones that outlasted the CLOSING timeout
+        if (newState == GATE_CLOSING) {
+            _setBit(_closeTimed, gate, oldState == GATE_OPEN);
+            _closeStart[gate] = now;
+        } else if (newState == GATE_CLOSED && (_closeTimed & _bit(gate))) {
+            uint32_t travel = now - _closeStart[gate];
+            if (_travel[gate].addSample(travel)) {
+                LOG_INFO("[TRAVEL] Gate %u closed in %u ms, expected travel now %u ms, timeout %u ms",
+                         gate, travel, _travel[gate].expectedMs(), _travel[gate].timeoutMs());
+            }
+            _setBit(_closeTimed, gate, false);
+        } else if (newState != GATE_OPEN) {
+            _setBit(_closeTimed, gate, false);
+        }
+    
+        _previousState[gate] = oldState;
+        _currentState[gate] = newState;
+        _lastStateChange[gate] = now;
+        _setBit(_motionSeen, gate, _motionActive & _bit(gate));
+    
+        // Notify listener (e.g. event-driven MQTT publish)
+        if (_stateCallback) {
+            _stateCallback(gate, oldState, newState, _stateCallbackContext);
+        }
     }
 }
 
-bool Gate::_readSensor() {
+template <typename Policy>
+bool GateController<Policy>::_readSensor(uint8_t gate) {
     // Read sensor state - HIGH when gate is closed, LOW when open/moving
-    return digitalRead(PIN_SENSOR_GATE_OPEN);
+    return digitalRead(Policy::GATE_POSITION_SENSOR[gate]);
 }
 
-void Gate::_activateRelay(int relayPin, const char* relayName) {
-    if (_relayActive) {
-        Serial.println("[ERROR] Relay already active, cannot activate another");
+template <typename Policy>
+void GateController<Policy>::_processSensorEdges(uint8_t gate) {
+    // Take every edge captured by the ISR since the last update; only the
+    // most recent level and its timestamp matter for debouncing
+    InputEdge edge;
+    while (_sensorEdges[gate].pop(edge)) {
+        _setBit(_pendingSensorState, gate, edge.level);
+        _lastSensorEdgeUs[gate] = edge.timestampUs;
+        _sensorEdgePending |= _bit(gate);
+    }
+    
+    // Edges were lost to a full buffer - the last popped level may be stale
+    uint32_t dropped = _sensorEdges[gate].droppedEdges();
+    if (dropped != _droppedSensorEdges[gate]) {
+        _droppedSensorEdges[gate] = dropped;
+        _setBit(_pendingSensorState, gate, _readSensor(gate));
+        _sensorEdgePending |= _bit(gate);
+        LOG_WARN("[SENSOR] Edge buffer overflow - re-reading sensor");
+    }
+    
+    // No edge seen but the pin disagrees with the debounced level: an
+    // interrupt was missed. Sampled on every wake-up, i.e. at the
+    // state-dependent poll period when nothing else happens.
+    if (!(_sensorEdgePending & _bit(gate))) {
+        bool level = _readSensor(gate);
+        if (level != (bool)(_sensorState & _bit(gate))) {
+            _setBit(_pendingSensorState, gate, level);
+            _lastSensorEdgeUs[gate] = micros();
+            _sensorEdgePending |= _bit(gate);
+        }
+    }
+    
+    // Accept the level once the input has been quiet for the debounce window
+    if (!(_sensorEdgePending & _bit(gate)) ||
+        (uint32_t)(micros() - _lastSensorEdgeUs[gate]) < Policy::SENSOR_DEBOUNCE_US) {
+        return;
+    }
+    _sensorEdgePending &= ~_bit(gate);
+    
+    if ((_pendingSensorState ^ _sensorState) & _bit(gate)) {
+        _sensorState ^= _bit(gate);
+        _lastSensorRead[gate] = millis();
+    
+        LOG_INFO("[SENSOR] Gate %u sensor state changed to: %s", gate,
+                 (_sensorState & _bit(gate)) ? "HIGH (closed)" : "LOW (open/moving)");
+    }
+}
+
+template <typename Policy>
+void GateController<Policy>::_processFusionInputs(uint8_t gate, uint32_t currentTime) {
+    if (_hasMotionInput(gate)) {
+        // Only the activity of the light matters (blinking or steady), so
+        // edges need no debouncing: the last level and edge time suffice
+        InputEdge edge;
+        bool edges = false;
+        while (_motionEdges[gate].pop(edge)) {
+            _setBit(_motionLamp, gate, edge.level == Policy::FUSION_INPUT_ACTIVE_LEVEL);
+            edges = true;
+        }
+        if (edges) {
+            if (!(_motionActive & _bit(gate))) {
+                _motionStart[gate] = currentTime;
+                LOG_INFO("[FUSION] Gate %u warning light on - moving", gate);
+            }
+            _lastMotionEdge[gate] = currentTime;
+            _motionActive |= _bit(gate);
+            _motionSeen |= _bit(gate);
+        } else if ((_motionActive & ~_motionLamp & _bit(gate)) &&
+                   currentTime - _lastMotionEdge[gate] >= Policy::MOTION_HOLD_MS) {
+            _motionActive &= ~_bit(gate);
+            LOG_INFO("[FUSION] Gate %u warning light dark - stopped", gate);
+        }
+    }
+    
+    // The lock changes once per move; sampled at the state-dependent poll period
+    if (_hasLockInput(gate)) {
+        bool engaged = digitalRead(Policy::GATE_LOCK_INPUT[gate]) == Policy::FUSION_INPUT_ACTIVE_LEVEL;
+        if (engaged != (bool)(_lockEngaged & _bit(gate))) {
+            _setBit(_lockEngaged, gate, engaged);
+            LOG_INFO("[FUSION] Gate %u lock %s", gate, engaged ? "engaged" : "released");
+        }
+    }
+}
+
+template <typename Policy>
+bool GateController<Policy>::_motionStartedInState(uint8_t gate) const {
+    // Light came on after the current state began (a light still running
+    // from the move that led here does not count)
+    return (_motionActive & _bit(gate)) && (int32_t)(_motionStart[gate] - _lastStateChange[gate]) >= 0;
+}
+
+template <typename Policy>
+bool GateController<Policy>::_motionEndedInState(uint8_t gate) const {
+    return (_motionSeen & ~_motionActive) & _bit(gate);
+}
+
+template <typename Policy>
+void GateController<Policy>::_activateRelay(uint8_t gate, uint8_t relayPin, const char* relayName) {
+    if (_relayActive & _bit(gate)) {
+        LOG_ERROR("[ERROR] Relay already active, cannot activate another");
         return;
     }
     
     // Activate the relay
     digitalWrite(relayPin, HIGH);
-    _relayActive = true;
-    _relayActivationTime = millis();
+    _relayActive |= _bit(gate);
+    _relayActivationTime[gate] = millis();
     
-    Serial.print("[RELAY] ");
-    Serial.print(relayName);
-    Serial.println(" relay activated");
+    LOG_INFO("[RELAY] Gate %u %s relay activated", gate, relayName);
     
-    // Set up timer to deactivate relay after 500ms
-    _relayTimer.in(500, [](void* gate) -> bool {
-        static_cast<Gate*>(gate)->_deactivateRelays();
-        return false; // Don't repeat
-    }, this);
+    // Deactivate relay after the policy pulse time
+    _scheduleRelayRelease();
 }
 
-void Gate::_deactivateRelays() {
-    // Deactivate both relays to be safe
-    digitalWrite(PIN_RELAY_GATE_OPEN, LOW);
-    digitalWrite(PIN_RELAY_GATE_CLOSE, LOW);
-    digitalWrite(PIN_RELAY_GATE_STOP, LOW);
+template <typename Policy>
+void GateController<Policy>::_deactivateRelays(uint8_t gate) {
+    // Deactivate all relays of the gate to be safe
+    digitalWrite(Policy::GATE_RELAY_OPEN[gate], LOW);
+    digitalWrite(Policy::GATE_RELAY_CLOSE[gate], LOW);
+    if (Policy::GATE_RELAY_STOP[gate] != NO_PIN) {
+        digitalWrite(Policy::GATE_RELAY_STOP[gate], LOW);
+    }
     
-    if (_relayActive) {
-        unsigned long activeDuration = millis() - _relayActivationTime;
-        Serial.print("[RELAY] Relay deactivated after ");
-        Serial.print(activeDuration);
-        Serial.println("ms");
+    if (_relayActive & _bit(gate)) {
+        uint32_t activeDuration = millis() - _relayActivationTime[gate];
+        LOG_INFO("[RELAY] Gate %u relay deactivated after %ums", gate, activeDuration);
     }
     
-    _relayActive = false;
-    _relayActivationTime = 0;
+    _relayActive &= ~_bit(gate);
+    _relayActivationTime[gate] = 0;
+    _scheduleRelayRelease();
 }
 
-void Gate::_logStateChange(GateState oldState, GateState newState) {
-    Serial.print("[STATE] Gate state changed: ");
-    
-    // Print old state
-    switch (oldState) {
-        case GATE_UNKNOWN:  Serial.print("UNKNOWN"); break;
-        case GATE_CLOSED:   Serial.print("CLOSED"); break;
-        case GATE_OPENING:  Serial.print("OPENING"); break;
-        case GATE_OPEN:     Serial.print("OPEN"); break;
-        case GATE_CLOSING:  Serial.print("CLOSING"); break;
-        default:            Serial.print("INVALID"); break;
+template <typename Policy>
+void GateController<Policy>::_scheduleRelayRelease() {
+    // One deadline covers every gate: the earliest pulse end
+    _scheduler.cancel(_relayRelease);
+    if (!_relayActive) {
+        return;
     }
     
-    Serial.print(" -> ");
-    
-    // Print new state
-    switch (newState) {
-        case GATE_UNKNOWN:  Serial.println("UNKNOWN"); break;
-        case GATE_CLOSED:   Serial.println("CLOSED"); break;
-        case GATE_OPENING:  Serial.println("OPENING"); break;
-        case GATE_OPEN:     Serial.println("OPEN"); break;
-        case GATE_CLOSING:  Serial.println("CLOSING"); break;
-        default:            Serial.println("INVALID"); break;
+    uint32_t now = millis();
+    uint32_t next = Policy::RELAY_PULSE_MS;
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        if (_relayActive & _bit(gate)) {
+            uint32_t elapsed = now - _relayActivationTime[gate];
+            uint32_t remaining = elapsed >= Policy::RELAY_PULSE_MS ? 0 : Policy::RELAY_PULSE_MS - elapsed;
+            if (remaining < next) next = remaining;
+        }
     }
+    _relayRelease = _scheduler.in(next, _relayReleaseHandler, this);
 }
 
-bool Gate::_isValidStateTransition(GateState from, GateState to) {
-    // Define valid state transitions (Requirement 2.6: Allow manual/external gate closure from any state)
-    switch (from) {
-        case GATE_UNKNOWN:
-            return (to == GATE_CLOSED || to == GATE_OPEN || to == GATE_OPENING || to == GATE_CLOSING);
-            
-        case GATE_CLOSED:
-            return (to == GATE_OPENING || to == GATE_UNKNOWN);
-            
-        case GATE_OPENING:
-            return (to == GATE_OPEN || to == GATE_CLOSED || to == GATE_UNKNOWN);
-            
-        case GATE_OPEN:
-            return (to == GATE_CLOSING || to == GATE_CLOSED || to == GATE_UNKNOWN);
-            
-        case GATE_CLOSING:
-            return (to == GATE_CLOSED || to == GATE_OPEN || to == GATE_UNKNOWN);
-            
-        default:
-            return false;
+template <typename Policy>
+bool GateController<Policy>::_relayReleaseHandler(void* gate) {
+    GateController* self = static_cast<GateController*>(gate);
+    self->_relayRelease = NO_SCHEDULE;
+    
+    uint32_t now = millis();
+    for (uint8_t index = 0; index < GATE_COUNT; index++) {
+        if ((self->_relayActive & _bit(index)) &&
+            now - self->_relayActivationTime[index] >= Policy::RELAY_PULSE_MS) {
+            self->_deactivateRelays(index);
+        }
+    }
+    
+    // Pulses still running on other gates
+    if (self->_relayRelease == NO_SCHEDULE) {
+        self->_scheduleRelayRelease();
     }
+    return false; // Don't repeat
 }
 
-void Gate::_handleBootupState() {
-    Serial.println("[GATE] Handling bootup state detection");
+template <typename Policy>
+void GateController<Policy>::_logStateChange(uint8_t gate, GateState oldState, GateState newState) {
+    LOG_INFO("[STATE] Gate %u state changed: %s -> %s", gate,
+             gateStateName(oldState), gateStateName(newState));
+}
+
+template <typename Policy>
+void GateController<Policy>::_handleBootupState(uint8_t gate) {
+    LOG_INFO("[GATE] Handling bootup state detection");
     
-    if (_sensorState) {
+    if (_sensorState & _bit(gate)) {
         // Sensor HIGH - gate is closed
-        _updateGateState(GATE_CLOSED);
-        Serial.println("[GATE] Boot-up: Gate detected as CLOSED (sensor HIGH)");
+        _updateGateState(gate, GATE_CLOSED);
+        LOG_INFO("[GATE] Boot-up: Gate detected as CLOSED (sensor HIGH)");
     } else {
         // Sensor LOW - gate could be open, opening, or closing
-        // Set to UNKNOWN and let the state machine determine after 20 seconds
-        _updateGateState(GATE_UNKNOWN);
-        Serial.println("[GATE] Boot-up: Gate sensor LOW - waiting 20 seconds to determine state");
+        // Set to UNKNOWN and let the state machine determine after a full travel
+        _updateGateState(gate, GATE_UNKNOWN);
+        LOG_INFO("[GATE] Boot-up: Gate sensor LOW - waiting one travel time to determine state");
     }
 }
+
+template <typename Policy>
+uint32_t GateController<Policy>::_travelLimitMs(uint8_t gate) const {
+    // OPENING has no end-position signal and its travel time is only learned
+    // from closes, so without the warning light it ends at the same margin
+    // that CLOSING and boot wait for: reporting OPEN late is harmless,
+    // reporting it while the leaf still moves is not
+    return _travel[gate].timeoutMs();
+}
+
+// ============================================================================
+// EXPLICIT INSTANTIATION
+// ============================================================================
+template class GateController<BoardPolicy>;
+
+#if !defined(ARDUINO_ARCH_ESP32)
+// Host build: the other real board and a synthetic three-gate layout, for bench-gates
+#if defined(BOARD_DUAL_GATE)
+template class GateController<GateGuardianBoard>;
+#else
+template class GateController<GateGuardianDualBoard>;
+#endif
+template class GateController<HostSyntheticTripleGateBoard>;
+#endif
@@ -3,31 +3,20 @@
  * 
  * Defines the Gate class interface and related enumerations
  * for controlling and monitoring a Sommer Twist 350 swing gate.
+ *
+ * The controller is a template over a board policy (see boardpolicy.h)
+ * so pins, timings and the number of gates are compile-time constants;
+ * Gate is the specialization for the board the firmware is built for.
  */
 
 #ifndef Gate_h
 #define Gate_h
 
 #include "Arduino.h"
-#include <arduino-timer.h>
-
-// ============================================================================
-// GPIO PIN DEFINITIONS
-// ============================================================================
-// LED Indicators
-extern const int PIN_LED_GATE_CLOSED;  // Red LED: closed (blink = closing)
-extern const int PIN_LED_GATE_OPEN;    // Green LED: open (blink = opening)
-
-// Relay Controls
-extern const int PIN_RELAY_GATE_CLOSE; // Close relay control
-extern const int PIN_RELAY_GATE_OPEN;  // Open relay control
-extern const int PIN_RELAY_GATE_STOP;  // Stop relay control
-
-// Sensor Input
-extern const int PIN_SENSOR_GATE_OPEN;  // High when gate is closed; Low when gate is: open, opening or closing
-
-// Button Input
-extern const int PIN_BUTTON;           // Manual control button
+#include "boardpolicy.h"
+#include "edgecapture.h"
+#include "scheduler.h"
+#include "travelestimator.h"
 
 // ============================================================================
 // GATE STATE ENUMERATION
@@ -40,20 +29,94 @@ enum GateState : byte {
     GATE_CLOSING    // Gate is in process of closing
 };
 
+static constexpr uint8_t GATE_STATE_COUNT = 5;
+
+// ============================================================================
+// STATE TRANSITION TABLE
+// ============================================================================
+constexpr uint8_t gateStateBit(GateState state) {
+    return (uint8_t)(1u << state);
+}
+
+// Entry [from] has bit [to] set when from -> to is allowed
+// (Requirement 2.6: allow manual/external gate closure from any state)
+constexpr uint8_t GATE_TRANSITIONS[GATE_STATE_COUNT] = {
+    /* UNKNOWN */ gateStateBit(GATE_CLOSED) | gateStateBit(GATE_OPEN) |
+                  gateStateBit(GATE_OPENING) | gateStateBit(GATE_CLOSING),
+    /* CLOSED  */ gateStateBit(GATE_OPENING) | gateStateBit(GATE_UNKNOWN),
+    /* OPENING */ gateStateBit(GATE_OPEN) | gateStateBit(GATE_CLOSED) | gateStateBit(GATE_UNKNOWN),
+    /* OPEN    */ gateStateBit(GATE_CLOSING) | gateStateBit(GATE_CLOSED) | gateStateBit(GATE_UNKNOWN),
+    /* CLOSING */ gateStateBit(GATE_CLOSED) | gateStateBit(GATE_OPEN) | gateStateBit(GATE_UNKNOWN)
+};
+
+constexpr bool isValidGateTransition(GateState from, GateState to) {
+    return from < GATE_STATE_COUNT && ((GATE_TRANSITIONS[from] >> to) & 1);
+}
+
+static_assert(isValidGateTransition(GATE_OPENING, GATE_CLOSED) &&
+              isValidGateTransition(GATE_OPEN, GATE_CLOSED) &&
+              isValidGateTransition(GATE_CLOSING, GATE_CLOSED),
+              "Sensor HIGH must always be able to close the gate (Requirement 2.6)");
+static_assert(!isValidGateTransition(GATE_CLOSED, GATE_OPEN),
+              "A closed gate must pass through OPENING");
+
+/**
+ * Get state name for logging/MQTT without allocating
+ * @param state Gate state
+ * @return Static string representation of the state
+ */
+const char* gateStateName(GateState state);
+
+/**
+ * Callback invoked after every gate state transition
+ * @param gate Index of the gate that changed (column of the board policy)
+ * @param oldState State before the transition
+ * @param newState State after the transition
+ * @param context Opaque pointer given at registration
+ */
+typedef void (*GateStateCallback)(uint8_t gate, GateState oldState, GateState newState, void* context);
+
+// One bit per gate (bit i = gate i)
+typedef uint32_t GateMask;
+
 // ============================================================================
 // GATE CLASS DECLARATION
 // ============================================================================
-class Gate {
+/**
+ * State machines of every gate on the board
+ * Per-gate state is kept as a struct of arrays (one array or bit mask per
+ * field), and update() advances all gates in a single pass.
+ *
+ * The position sensor only tells closed from not closed. Where the policy
+ * wires a gate's warning light (GATE_MOTION_INPUT) and lock
+ * (GATE_LOCK_INPUT), their evidence is fused in:
+ * - the light coming on while CLOSED or OPEN starts OPENING or CLOSING,
+ *   also for moves started by a remote or keypad
+ * - the light going dark for MOTION_HOLD_MS ends OPENING at OPEN, and a
+ *   CLOSING that stopped short of the sensor at OPEN, without waiting for
+ *   the travel timeout
+ * - the sensor still reading closed while the light shows the gate
+ *   starting to open is not taken as CLOSED
+ * - the lock engaging ends CLOSING (or boot) at CLOSED
+ * Gates without these inputs fall back to the sensor and travel timeouts.
+ */
+template <typename Policy>
+class GateController {
+    static_assert(BoardPolicyCheck<Policy>::ok, "Invalid board policy");
+
 public:
+    static constexpr uint8_t GATE_COUNT = Policy::GATE_COUNT;
+
     /**
      * Constructor - Initialize gate controller
+     * @param scheduler Scheduler of the task running the gates (relay release)
      */
-    Gate();
+    explicit GateController(Scheduler& scheduler);
     
     /**
      * Destructor - Clean up resources
      */
-    ~Gate();
+    ~GateController();
     
     /**
      * Initialize gate controller
@@ -62,87 +125,169 @@ public:
     void initialize();
     
     /**
-     * Update gate state machine
-     * Should be called regularly in main loop
+     * Update every gate state machine in one pass
+     * Call on every wake-up of the control task
      */
     void update();
     
+    /**
+     * Time until update() next has work to do without an input event
+     * Covers the debounce window, travel timeout, relay safety timeout and
+     * the state-dependent sensor re-sampling period of every gate.
+     * @return Milliseconds until the next update() is needed
+     */
+    uint32_t msUntilNextEvent() const;
+    
+    /**
+     * Register a handler called from the sensor interrupts after each edge
+     * Used to wake the control task; the handler must be IRAM-safe.
+     * @param handler Handler, or nullptr to remove
+     * @param arg Passed to the handler
+     */
+    void onSensorEdge(EdgeWakeHandler handler, void* arg);
+    
     /**
      * Toggle gate state (open if closed, close if open)
      * Equivalent to button press functionality
+     * @param gate Gate index (0 to GATE_COUNT - 1)
      */
-    void toggle();
+    void toggle(uint8_t gate);
     
     /**
      * Command gate to stop
      * Only effective if gate is currently moving
+     * @param gate Gate index
      */
-    void stopGate();
+    void stopGate(uint8_t gate);
 
     /**
      * Command gate to open
      * Only effective if gate is currently closed
+     * @param gate Gate index
      */
-    void openGate();
+    void openGate(uint8_t gate);
     
     /**
      * Command gate to close  
      * Only effective if gate is currently open
+     * @param gate Gate index
      */
-    void closeGate();
+    void closeGate(uint8_t gate);
     
     /**
      * Get current gate state
+     * @param gate Gate index
      * @return Current GateState enumeration value
      */
-    GateState getState() const;
+    GateState getState(uint8_t gate) const;
     
     /**
      * Check if gate is currently moving
+     * @param gate Gate index
      * @return true if gate is opening or closing
      */
-    bool isMoving() const;
+    bool isMoving(uint8_t gate) const;
     
     /**
-     * Check if relay is currently active
+     * Check if the gate's relay is currently active
+     * @param gate Gate index
      * @return true if relay is currently activated
      */
-    bool isRelayActive() const;
+    bool isRelayActive(uint8_t gate) const;
+    
+    /**
+     * Get debounced position sensor level
+     * @param gate Gate index
+     * @return true if sensor is HIGH (gate closed)
+     */
+    bool getSensorState(uint8_t gate) const;
     
     /**
      * Get state as string for logging/MQTT
+     * @param gate Gate index
      * @return String representation of current state
      */
-    String getStateString() const;
+    String getStateString(uint8_t gate) const;
+    
+    /**
+     * Register a callback for state transitions (replaces any previous one)
+     * Called from update()/commands in the context that changed the state.
+     * @param callback Function to call, or nullptr to remove
+     * @param context Opaque pointer passed back to the callback
+     */
+    void onStateChange(GateStateCallback callback, void* context);
+    
+    /**
+     * Learned travel time used for the OPENING/CLOSING/boot timeouts
+     * Load a persisted estimate before the control task starts; estimate()
+     * and save() may be used from other tasks afterwards.
+     * @param gate Gate index
+     */
+    TravelEstimator& travelEstimator(uint8_t gate);
 
 private:
-    // Timer management
-    Timer<> _stateTimer;        // Timer for gate operation timing
-    Timer<> _relayTimer;        // Timer for relay pulse control
+    // Deadline management
+    Scheduler& _scheduler;      // Control task scheduler
+    ScheduleId _relayRelease;   // Earliest pending relay pulse end
+    
+    // Per-gate state (struct of arrays, indexed by gate)
+    GateState _currentState[GATE_COUNT];        // Current gate state
+    GateState _previousState[GATE_COUNT];       // Previous state for change detection
+    uint32_t _lastStateChange[GATE_COUNT];      // Timestamp of last state change
+    uint32_t _lastSensorRead[GATE_COUNT];       // Timestamp of last debounced sensor change
+    uint32_t _lastSensorEdgeUs[GATE_COUNT];     // ISR timestamp of the last captured edge
+    uint32_t _relayActivationTime[GATE_COUNT];  // Timestamp when relay was activated
+    uint32_t _closeStart[GATE_COUNT];           // Start of a close from fully open
+    uint32_t _droppedSensorEdges[GATE_COUNT];   // Overflow count already handled
+    uint32_t _motionStart[GATE_COUNT];          // Warning light came on (after being dark)
+    uint32_t _lastMotionEdge[GATE_COUNT];       // Last warning light edge
     
-    // State tracking
-    GateState _currentState;    // Current gate state
-    GateState _previousState;   // Previous state for change detection
-    bool _sensorState;          // Current sensor reading
-    bool _previousSensorState;  // Previous sensor reading for debouncing
+    // Per-gate flags (bit i = gate i)
+    GateMask _sensorState;          // Debounced sensor level
+    GateMask _pendingSensorState;   // Last captured level, not yet stable
+    GateMask _sensorEdgePending;    // An edge awaits debouncing
+    GateMask _relayActive;          // A relay is currently active
+    GateMask _closeTimed;           // A close is being timed
+    GateMask _motionLamp;           // Warning light input is active
+    GateMask _motionActive;         // Light on or blinking: the gate is moving
+    GateMask _motionSeen;           // Light was active since the last state change
+    GateMask _lockEngaged;          // Lock input is active (gate at the closed position)
     
-    // Timing variables
-    unsigned long _lastStateChange;     // Timestamp of last state change
-    unsigned long _lastSensorRead;      // Timestamp of last sensor reading
-    unsigned long _relayActivationTime; // Timestamp when relay was activated
+    // Per-gate inputs and learning
+    EdgeCapture _sensorEdges[GATE_COUNT];   // ISR-captured position sensor edges
+    EdgeCapture _motionEdges[GATE_COUNT];   // ISR-captured warning light edges
+    TravelEstimator _travel[GATE_COUNT];    // Learned end-to-end travel time
     
     // Control flags
-    bool _relayActive;          // Flag indicating relay is currently active
     bool _initialized;          // Flag indicating initialization complete
     
+    // State change notification
+    GateStateCallback _stateCallback;   // Transition listener
+    void* _stateCallbackContext;        // Listener context
+    
     // Private methods
-    void _updateGateState(GateState newState);
-    bool _readSensor();
-    void _activateRelay(int relayPin, const char* relayName);
-    void _deactivateRelays();
-    void _logStateChange(GateState oldState, GateState newState);
-    bool _isValidStateTransition(GateState from, GateState to);
-    void _handleBootupState();
+    static constexpr GateMask _bit(uint8_t gate) { return (GateMask)1 << gate; }
+    static void _setBit(GateMask& mask, uint8_t gate, bool value);
+    void _updateGate(uint8_t gate, uint32_t currentTime);
+    void _updateGateState(uint8_t gate, GateState newState);
+    bool _readSensor(uint8_t gate);
+    void _processSensorEdges(uint8_t gate);
+    void _processFusionInputs(uint8_t gate, uint32_t currentTime);
+    bool _motionStartedInState(uint8_t gate) const;
+    bool _motionEndedInState(uint8_t gate) const;
+    static constexpr bool _hasMotionInput(uint8_t gate) { return Policy::GATE_MOTION_INPUT[gate] != NO_PIN; }
+    static constexpr bool _hasLockInput(uint8_t gate) { return Policy::GATE_LOCK_INPUT[gate] != NO_PIN; }
+    void _activateRelay(uint8_t gate, uint8_t relayPin, const char* relayName);
+    void _deactivateRelays(uint8_t gate);
+    void _scheduleRelayRelease();
+    static bool _relayReleaseHandler(void* gate);
+    void _logStateChange(uint8_t gate, GateState oldState, GateState newState);
+    void _handleBootupState(uint8_t gate);
+    uint32_t _travelLimitMs(uint8_t gate) const;
 };
 
+// Gate controller for the board the firmware is built for
+// (gate.cpp explicitly instantiates it)
+typedef GateController<BoardPolicy> Gate;
+
 #endif // Gate_h
@@ -0,0 +1,747 @@
+/**
+ * HttpServer.cpp - ESP32 Swing Gate Controller event-driven HTTP server
+ *
+ * Implementation of the connection slots, the incremental request parser
+ * and the non-blocking response writer.
+ */
+
+#include "httpserver.h"
+#include "scheduler.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <errno.h>
+#include <lwip/sockets.h>
+#endif
+
+namespace {
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default:  return "Unknown";
+    }
+}
+
+HttpMethod parseMethod(const char* text) {
+    if (strcmp(text, "GET") == 0) return HTTP_METHOD_GET;
+    if (strcmp(text, "POST") == 0) return HTTP_METHOD_POST;
+    if (strcmp(text, "PUT") == 0) return HTTP_METHOD_PUT;
+    if (strcmp(text, "DELETE") == 0) return HTTP_METHOD_DELETE;
+    return HTTP_METHOD_OTHER;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Closing chunk of a chunked body
+const char LAST_CHUNK[] = "0\r\n\r\n";
+const size_t LAST_CHUNK_LENGTH = sizeof(LAST_CHUNK) - 1;
+
+} // namespace
+
+// ============================================================================
+// HTTP BODY
+// ============================================================================
+
+bool HttpBody::write(const char* data, size_t length) {
+    if (length == 0 || _overflow) {
+        return !_overflow;
+    }
+
+    // Chunk framing: "<hex length>\r\n" + data + "\r\n"
+    char header[12];
+    int headerLength = _chunked ? snprintf(header, sizeof(header), "%x\r\n", (unsigned)length) : 0;
+    size_t needed = headerLength + length + (_chunked ? 2 : 0);
+    if (_length + needed > _size) {
+        _overflow = true;
+        return false;
+    }
+
+    memcpy(_buffer + _length, header, headerLength);
+    _length += headerLength;
+    memcpy(_buffer + _length, data, length);
+    _length += length;
+    if (_chunked) {
+        _buffer[_length++] = '\r';
+        _buffer[_length++] = '\n';
+    }
+    return true;
+}
+
+void HttpBody::sink(const char* data, size_t length, void* context) {
+    static_cast<HttpBody*>(context)->write(data, length);
+}
+
+// ============================================================================
+// HTTP REQUEST
+// ============================================================================
+
+bool HttpRequest::arg(const char* name, char* value, size_t size) const {
+    if (!_query || size == 0) {
+        return false;
+    }
+
+    size_t nameLength = strlen(name);
+    const char* pair = _query;
+    while (*pair) {
+        const char* end = strchr(pair, '&');
+        if (!end) {
+            end = pair + strlen(pair);
+        }
+
+        if (strncmp(pair, name, nameLength) == 0 && (pair[nameLength] == '=' || pair + nameLength == end)) {
+            // Percent- and plus-decode the value
+            const char* in = pair + nameLength + (pair[nameLength] == '=' ? 1 : 0);
+            size_t length = 0;
+            while (in < end && length + 1 < size) {
+                if (*in == '%' && end - in >= 3 && hexValue(in[1]) >= 0 && hexValue(in[2]) >= 0) {
+                    value[length++] = (char)(hexValue(in[1]) << 4 | hexValue(in[2]));
+                    in += 3;
+                } else {
+                    value[length++] = *in == '+' ? ' ' : *in;
+                    in++;
+                }
+            }
+            value[length] = '\0';
+            return true;
+        }
+        pair = *end ? end + 1 : end;
+    }
+    return false;
+}
+
+void HttpRequest::addHeader(const char* name, const char* value) {
+    HttpServer::Connection& connection = _server._connections[_slot];
+    size_t free = sizeof(connection.extraHeaders) - connection.extraHeadersLength;
+    int length = snprintf(connection.extraHeaders + connection.extraHeadersLength, free,
+                          "%s: %s\r\n", name, value);
+    if (length < 0 || (size_t)length >= free) {
+        connection.extraHeaders[connection.extraHeadersLength] = '\0';
+        Serial.println("[ERROR] HTTP response header dropped, no room");
+        return;
+    }
+    connection.extraHeadersLength += length;
+}
+
+void HttpRequest::send(int status, const char* contentType, const char* body) {
+    send(status, contentType, body, strlen(body));
+}
+
+void HttpRequest::send(int status, const char* contentType, const char* body, size_t length) {
+    HttpServer::Connection& connection = _server._connections[_slot];
+    if (connection.responded) {
+        Serial.println("[ERROR] HTTP handler answered twice");
+        return;
+    }
+    connection.responded = true;
+
+    _server._writeHead(connection, status, contentType, (long)length);
+    if (connection.outputLength + length > sizeof(connection.output)) {
+        // Bodies this large must be streamed
+        Serial.println("[ERROR] HTTP response body exceeds output buffer");
+        connection.outputLength = 0;
+        connection.extraHeadersLength = 0;
+        connection.extraHeaders[0] = '\0';
+        connection.keepAlive = false;
+        _server._writeHead(connection, 500, "text/plain", 0);
+        return;
+    }
+    memcpy(connection.output + connection.outputLength, body, length);
+    connection.outputLength += length;
+}
+
+void HttpRequest::stream(int status, const char* contentType, HttpBodySource source, void* context,
+                         uint32_t position, uint32_t limit) {
+    HttpServer::Connection& connection = _server._connections[_slot];
+    if (connection.responded) {
+        Serial.println("[ERROR] HTTP handler answered twice");
+        return;
+    }
+    connection.responded = true;
+
+    // Without chunked encoding the end of the body is the end of the connection
+    if (!connection.chunked) {
+        connection.keepAlive = false;
+    }
+    _server._writeHead(connection, status, contentType, -1);
+    connection.source = source;
+    connection.sourceContext = context;
+    connection.position = position;
+    connection.limit = limit;
+    connection.pieces = 0;
+}
+
+void HttpRequest::subscribe(EventStream& events, const char* initial, size_t length) {
+    HttpServer::Connection& connection = _server._connections[_slot];
+    if (connection.responded) {
+        Serial.println("[ERROR] HTTP handler answered twice");
+        return;
+    }
+    if (_server.activeSubscribers() >= HttpServer::MAX_EVENT_STREAMS) {
+        send(503, "text/plain", "Too many event stream subscribers");
+        return;
+    }
+    connection.responded = true;
+
+    // The body is the raw event stream and ends when either side closes
+    connection.keepAlive = false;
+    connection.chunked = false;
+    addHeader("Cache-Control", "no-cache");
+    _server._writeHead(connection, 200, "text/event-stream", -1);
+    if (connection.outputLength + length > sizeof(connection.output)) {
+        Serial.println("[ERROR] Initial events exceed output buffer, not sent");
+        length = 0;
+    }
+    memcpy(connection.output + connection.outputLength, initial, length);
+    connection.outputLength += length;
+
+    connection.events = &events;
+    connection.cursor = events.head();
+    connection.state = HttpServer::SLOT_STREAMING;
+    Serial.println("[HTTP] Event stream subscriber connected");
+}
+
+// ============================================================================
+// HTTP SERVER CLASS IMPLEMENTATION
+// ============================================================================
+
+HttpServer::HttpServer(uint16_t port)
+    : _listener(port), _routeCount(0), _requestsServed(0), _connectionsAccepted(0), _connectionsTimedOut(0),
+      _subscribersDropped(0) {
+    for (uint8_t i = 0; i < MAX_CONNECTIONS; i++) {
+        _connections[i].state = SLOT_FREE;
+    }
+}
+
+bool HttpServer::on(const char* path, HttpMethod method, HttpHandler handler, void* context) {
+    if (_routeCount >= MAX_ROUTES || !handler || strlen(path) >= ROUTE_PATH_SIZE) {
+        Serial.print("[ERROR] HTTP route table full or path too long, not registering ");
+        Serial.println(path);
+        return false;
+    }
+    Route& route = _routes[_routeCount++];
+    strcpy(route.path, path);
+    route.method = method;
+    route.handler = handler;
+    route.context = context;
+    return true;
+}
+
+bool HttpServer::on(const char* path, HttpHandler handler, void* context) {
+    return on(path, HTTP_METHOD_ANY, handler, context);
+}
+
+void HttpServer::begin() {
+    _listener.begin();
+    _listener.setNoDelay(true);
+    Serial.print("[HTTP] Listening with ");
+    Serial.print(MAX_CONNECTIONS);
+    Serial.println(" connection slots");
+}
+
+void HttpServer::update() {
+    uint32_t now = millis();
+    _accept(now);
+    for (uint8_t slot = 0; slot < MAX_CONNECTIONS; slot++) {
+        _service(slot, now);
+    }
+}
+
+uint32_t HttpServer::msUntilNextEvent() const {
+    uint32_t now = millis();
+    uint32_t next = SCHEDULE_IDLE;
+
+    for (uint8_t slot = 0; slot < MAX_CONNECTIONS; slot++) {
+        const Connection& connection = _connections[slot];
+        uint32_t wait;
+        uint32_t timeout;
+        switch (connection.state) {
+            case SLOT_FREE:
+                continue;
+            case SLOT_WRITING:
+                // Socket was full: retry shortly; drained: next piece or request now
+                wait = connection.outputStart < connection.outputLength ? WRITE_RETRY_MS : 0;
+                break;
+            case SLOT_STREAMING:
+                if (connection.outputStart == connection.outputLength &&
+                    connection.cursor == connection.events->head()) {
+                    continue;   // Caught up: nothing until the next event
+                }
+                wait = WRITE_RETRY_MS;
+                break;
+            case SLOT_READING:
+                if (connection.scanned < connection.requestLength) {
+                    wait = 0;   // Pipelined request already buffered
+                    break;
+                }
+                timeout = connection.requestLength ? REQUEST_TIMEOUT_MS : KEEPALIVE_TIMEOUT_MS;
+                wait = now - connection.lastActivity >= timeout ? 0 : timeout - (now - connection.lastActivity);
+                break;
+            default:
+                wait = now - connection.lastActivity >= REQUEST_TIMEOUT_MS
+                           ? 0 : REQUEST_TIMEOUT_MS - (now - connection.lastActivity);
+                break;
+        }
+        if (wait < next) {
+            next = wait;
+        }
+    }
+    return next;
+}
+
+uint8_t HttpServer::activeConnections() const {
+    uint8_t count = 0;
+    for (uint8_t slot = 0; slot < MAX_CONNECTIONS; slot++) {
+        if (_connections[slot].state != SLOT_FREE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint8_t HttpServer::activeSubscribers() const {
+    uint8_t count = 0;
+    for (uint8_t slot = 0; slot < MAX_CONNECTIONS; slot++) {
+        if (_connections[slot].state == SLOT_STREAMING) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+void HttpServer::_accept(uint32_t now) {
+    for (uint8_t accepted = 0; accepted < MAX_CONNECTIONS && _listener.hasClient(); accepted++) {
+        // Free slot, or else the persistent connection idle the longest
+        int slot = -1;
+        uint32_t longestIdle = 0;
+        for (uint8_t i = 0; i < MAX_CONNECTIONS; i++) {
+            Connection& connection = _connections[i];
+            if (connection.state == SLOT_FREE) {
+                slot = i;
+                break;
+            }
+            bool idle = connection.state == SLOT_READING && connection.requestLength == 0 &&
+                        connection.client.available() == 0;
+            if (idle && now - connection.lastActivity >= longestIdle) {
+                longestIdle = now - connection.lastActivity;
+                slot = i;
+            }
+        }
+        if (slot < 0) {
+            return;     // Every slot busy: leave the rest in the listen backlog
+        }
+
+        Connection& connection = _connections[slot];
+        if (connection.state != SLOT_FREE) {
+            _close(connection);
+        }
+        connection.client = _listener.accept();
+        if (!connection.client) {
+            return;
+        }
+
+        connection.state = SLOT_READING;
+        connection.lastActivity = now;
+        connection.requestLength = 0;
+        connection.scanned = 0;
+        connection.discard = 0;
+        connection.outputStart = 0;
+        connection.outputLength = 0;
+        connection.source = nullptr;
+        connection.events = nullptr;
+        _connectionsAccepted++;
+    }
+}
+
+void HttpServer::_service(uint8_t slot, uint32_t now) {
+    Connection& connection = _connections[slot];
+    if (connection.state == SLOT_FREE) {
+        return;
+    }
+    if (!connection.client.connected()) {
+        _close(connection);
+        return;
+    }
+
+    if (connection.state == SLOT_STREAMING) {
+        _streamEvents(connection, now);
+        return;
+    }
+
+    if (connection.state == SLOT_DISCARDING) {
+        char scratch[64];
+        while (connection.discard > 0 && connection.client.available() > 0) {
+            size_t chunk = connection.discard < sizeof(scratch) ? connection.discard : sizeof(scratch);
+            int count = connection.client.read((uint8_t*)scratch, chunk);
+            if (count <= 0) {
+                break;
+            }
+            connection.discard -= count;
+            connection.lastActivity = now;
+        }
+        if (connection.discard == 0) {
+            connection.state = SLOT_READING;
+        } else if (now - connection.lastActivity >= REQUEST_TIMEOUT_MS) {
+            _connectionsTimedOut++;
+            _close(connection);
+            return;
+        }
+    }
+
+    if (connection.state == SLOT_READING) {
+        if (!_read(connection, now)) {
+            // No complete header block yet
+            uint32_t timeout = connection.requestLength ? REQUEST_TIMEOUT_MS : KEEPALIVE_TIMEOUT_MS;
+            if (now - connection.lastActivity >= timeout) {
+                if (connection.requestLength) {
+                    _connectionsTimedOut++;
+                }
+                _close(connection);
+            }
+            return;
+        }
+    }
+
+    if (connection.state == SLOT_WRITING) {
+        bool progress = _flush(connection, now);
+        if (connection.state == SLOT_WRITING && connection.outputStart == connection.outputLength) {
+            if (connection.source) {
+                // One body piece per update keeps every pass bounded
+                _refill(connection);
+                progress = _flush(connection, now) || progress;
+            } else {
+                _finishResponse(connection);
+            }
+        }
+        if (connection.state == SLOT_WRITING && !progress && now - connection.lastActivity >= WRITE_TIMEOUT_MS) {
+            _connectionsTimedOut++;
+            _close(connection);
+        }
+    }
+}
+
+bool HttpServer::_read(Connection& connection, uint32_t now) {
+    // Take whatever has arrived, up to the header buffer size
+    int available = connection.client.available();
+    size_t room = sizeof(connection.request) - connection.requestLength;
+    if (available > 0 && room > 0) {
+        size_t wanted = (size_t)available < room ? (size_t)available : room;
+        int count = connection.client.read((uint8_t*)connection.request + connection.requestLength, wanted);
+        if (count > 0) {
+            connection.requestLength += count;
+            connection.lastActivity = now;
+        }
+    }
+
+    // Resume the scan for the blank line ending the header block
+    uint8_t slot = &connection - _connections;
+    for (size_t i = connection.scanned; i < connection.requestLength; i++) {
+        if (connection.request[i] != '\n') {
+            continue;
+        }
+        bool bare = i >= 1 && connection.request[i - 1] == '\n';
+        bool crlf = i >= 2 && connection.request[i - 1] == '\r' && connection.request[i - 2] == '\n';
+        if (bare || crlf) {
+            connection.scanned = 0;
+            return _parseRequest(slot, i + 1);
+        }
+    }
+    connection.scanned = connection.requestLength;
+
+    if (connection.requestLength == sizeof(connection.request)) {
+        _sendError(slot, 431, "Request header too large");
+        return true;
+    }
+    return false;
+}
+
+bool HttpServer::_parseRequest(uint8_t slot, size_t headerLength) {
+    Connection& connection = _connections[slot];
+    char* text = connection.request;
+    text[headerLength - 1] = '\0';
+
+    // Request line: METHOD SP target SP version
+    char* lineEnd = strchr(text, '\n');
+    if (!lineEnd) {
+        _sendError(slot, 400, "Malformed request line");
+        return true;
+    }
+    *lineEnd = '\0';
+    if (lineEnd > text && lineEnd[-1] == '\r') {
+        lineEnd[-1] = '\0';
+    }
+    char* target = strchr(text, ' ');
+    char* version = target ? strchr(target + 1, ' ') : nullptr;
+    if (!target || !version || target[1] != '/') {
+        _sendError(slot, 400, "Malformed request line");
+        return true;
+    }
+    *target++ = '\0';
+    *version++ = '\0';
+
+    HttpRequest request(*this, slot);
+    request._method = parseMethod(text);
+    request._path = target;
+    char* query = strchr(target, '?');
+    if (query) {
+        *query++ = '\0';
+    }
+    request._query = query;
+
+    connection.chunked = strcmp(version, "HTTP/1.1") == 0;
+    connection.keepAlive = connection.chunked;
+
+    // Headers: only the ones that change how the connection is handled
+    uint32_t contentLength = 0;
+    char* line = lineEnd + 1;
+    while (line < text + headerLength - 1) {
+        char* end = strchr(line, '\n');
+        if (!end) {
+            break;
+        }
+        *end = '\0';
+        if (end > line && end[-1] == '\r') {
+            end[-1] = '\0';
+        }
+        char* colon = strchr(line, ':');
+        if (colon) {
+            *colon = '\0';
+            char* value = colon + 1;
+            while (*value == ' ' || *value == '\t') {
+                value++;
+            }
+            if (strcasecmp(line, "Connection") == 0) {
+                if (strcasecmp(value, "close") == 0) {
+                    connection.keepAlive = false;
+                } else if (strcasecmp(value, "keep-alive") == 0) {
+                    connection.keepAlive = true;
+                }
+            } else if (strcasecmp(line, "Content-Length") == 0) {
+                contentLength = strtoul(value, nullptr, 10);
+            }
+        }
+        line = end + 1;
+    }
+
+    // Keep-alive only while nobody waits for a slot, so persistent
+    // connections cannot starve new clients
+    if (connection.keepAlive && _listener.hasClient() && activeConnections() == MAX_CONNECTIONS) {
+        connection.keepAlive = false;
+    }
+
+    // Request bodies are not used by any route: skip them
+    size_t buffered = connection.requestLength - headerLength;
+    size_t bodyBuffered = contentLength < buffered ? contentLength : buffered;
+    connection.discard = contentLength - bodyBuffered;
+
+    connection.extraHeadersLength = 0;
+    connection.extraHeaders[0] = '\0';
+    connection.responded = false;
+    connection.outputStart = 0;
+    connection.outputLength = 0;
+    connection.source = nullptr;
+    connection.state = SLOT_WRITING;
+    _dispatch(request);
+    _requestsServed++;
+
+    // Keep pipelined bytes for the next request (the handler is done with the buffer)
+    size_t consumed = headerLength + bodyBuffered;
+    memmove(connection.request, connection.request + consumed, connection.requestLength - consumed);
+    connection.requestLength -= consumed;
+    return true;
+}
+
+void HttpServer::_dispatch(HttpRequest& request) {
+    bool pathMatched = false;
+    for (uint8_t i = 0; i < _routeCount; i++) {
+        const Route& route = _routes[i];
+        if (strcmp(route.path, request._path) != 0) {
+            continue;
+        }
+        pathMatched = true;
+        if (route.method == HTTP_METHOD_ANY || route.method == request._method) {
+            route.handler(request, route.context);
+            if (!_connections[request._slot].responded) {
+                request.send(500, "text/plain", "Handler sent no response");
+            }
+            return;
+        }
+    }
+
+    if (pathMatched) {
+        request.send(405, "text/plain", "Method not allowed");
+    } else {
+        request.send(404, "text/plain", "Not found");
+    }
+}
+
+bool HttpServer::_flush(Connection& connection, uint32_t now) {
+    bool progress = false;
+    while (connection.outputStart < connection.outputLength) {
+        int sent = _sendSome(connection.client, connection.output + connection.outputStart,
+                             connection.outputLength - connection.outputStart);
+        if (sent < 0) {
+            _close(connection);
+            return false;
+        }
+        if (sent == 0) {
+            break;      // Socket buffer full; try again on a later update
+        }
+        connection.outputStart += sent;
+        connection.lastActivity = now;
+        progress = true;
+    }
+    return progress;
+}
+
+void HttpServer::_refill(Connection& connection) {
+    // Leave room for the closing chunk after the last piece
+    HttpBody body(connection.output, sizeof(connection.output) - LAST_CHUNK_LENGTH, connection.chunked,
+                  connection.pieces++);
+    bool more = connection.source(body, connection.position, connection.limit, connection.sourceContext);
+    if (body._overflow) {
+        // Part of the body is lost, so the response cannot be completed
+        Serial.println("[ERROR] HTTP body piece exceeds output buffer, closing connection");
+        _close(connection);
+        return;
+    }
+
+    connection.outputStart = 0;
+    connection.outputLength = body._length;
+    if (!more) {
+        connection.source = nullptr;
+        if (connection.chunked) {
+            memcpy(connection.output + connection.outputLength, LAST_CHUNK, LAST_CHUNK_LENGTH);
+            connection.outputLength += LAST_CHUNK_LENGTH;
+        }
+    }
+}
+
+void HttpServer::_finishResponse(Connection& connection) {
+    if (!connection.keepAlive) {
+        _close(connection);
+        return;
+    }
+    connection.state = connection.discard > 0 ? SLOT_DISCARDING : SLOT_READING;
+    connection.outputStart = 0;
+    connection.outputLength = 0;
+}
+
+void HttpServer::_streamEvents(Connection& connection, uint32_t now) {
+    // Subscribers have nothing more to ask; drop whatever they send
+    char scratch[64];
+    while (connection.client.available() > 0 && connection.client.read((uint8_t*)scratch, sizeof(scratch)) > 0) {
+    }
+
+    // A subscriber the ring has lapped would receive a corrupted stream;
+    // dropping it keeps the loop and every other subscriber going
+    if (connection.events->lapped(connection.cursor)) {
+        Serial.println("[HTTP] Event stream subscriber fell behind, dropped");
+        _subscribersDropped++;
+        _close(connection);
+        return;
+    }
+
+    // Headers and initial events first, then the shared ring from the cursor
+    bool progress = _flush(connection, now);
+    if (connection.state != SLOT_STREAMING) {
+        return;
+    }
+    const char* data;
+    size_t length;
+    while (connection.outputStart == connection.outputLength &&
+           (length = connection.events->read(connection.cursor, data)) > 0) {
+        int sent = _sendSome(connection.client, data, length);
+        if (sent < 0) {
+            _close(connection);
+            return;
+        }
+        if (sent == 0) {
+            break;
+        }
+        connection.cursor += sent;
+        progress = true;
+    }
+
+    // The write timeout counts only while events are waiting
+    bool pending = connection.outputStart < connection.outputLength ||
+                   connection.cursor != connection.events->head();
+    if (progress || !pending) {
+        connection.lastActivity = now;
+    } else if (now - connection.lastActivity >= WRITE_TIMEOUT_MS) {
+        _connectionsTimedOut++;
+        _subscribersDropped++;
+        _close(connection);
+    }
+}
+
+void HttpServer::_writeHead(Connection& connection, int status, const char* contentType, long contentLength) {
+    char length[40];
+    if (contentLength >= 0) {
+        snprintf(length, sizeof(length), "Content-Length: %ld\r\n", contentLength);
+    } else {
+        snprintf(length, sizeof(length), "%s", connection.chunked ? "Transfer-Encoding: chunked\r\n" : "");
+    }
+
+    size_t free = sizeof(connection.output) - connection.outputLength;
+    int written = snprintf(connection.output + connection.outputLength, free,
+                           "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n%sConnection: %s\r\n%s\r\n",
+                           status, reasonPhrase(status), contentType, length,
+                           connection.keepAlive ? "keep-alive" : "close", connection.extraHeaders);
+    if (written > 0) {
+        connection.outputLength += (size_t)written < free ? written : free - 1;
+    }
+}
+
+void HttpServer::_sendError(uint8_t slot, int status, const char* message) {
+    Connection& connection = _connections[slot];
+    connection.keepAlive = false;
+    connection.responded = false;
+    connection.extraHeadersLength = 0;
+    connection.extraHeaders[0] = '\0';
+    connection.outputStart = 0;
+    connection.outputLength = 0;
+    connection.source = nullptr;
+    connection.requestLength = 0;
+    connection.state = SLOT_WRITING;
+
+    HttpRequest request(*this, slot);
+    request.send(status, "text/plain", message);
+}
+
+void HttpServer::_close(Connection& connection) {
+    connection.client.stop();
+    connection.state = SLOT_FREE;
+    connection.source = nullptr;
+    connection.events = nullptr;
+}
+
+int HttpServer::_sendSome(NetworkClient& client, const char* data, size_t length) {
+#if defined(ARDUINO_ARCH_ESP32)
+    // NetworkClient::write() retries until everything is sent; a non-blocking
+    // send() takes only what fits in the socket buffer
+    int sent = send(client.fd(), data, length, MSG_DONTWAIT);
+    if (sent < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+    return sent;
+#else
+    // Host: the simulated peer accepts only as much as its receive window
+    return client.write((const uint8_t*)data, length);
+#endif
+}
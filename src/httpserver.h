@@ -0,0 +1,311 @@
+/**
+ * HttpServer.h - ESP32 Swing Gate Controller event-driven HTTP server
+ *
+ * Replaces the synchronous WebServer for the status and command routes. A
+ * fixed table of connection slots is serviced from update(): request bytes
+ * are read as they arrive and scanned incrementally for the end of the
+ * header block, and responses are written only as far as the socket accepts
+ * them, so a slow or stalled client never holds up the network task or the
+ * other connections. HTTP/1.1 keep-alive and pipelined requests are
+ * supported; large bodies (/metrics, /journal) are produced a piece at a
+ * time by a body source and sent with chunked transfer encoding. Server-Sent
+ * Events subscribers hold their slot and are fed from a shared EventStream.
+ *
+ * All state is owned by the task calling update(); nothing allocates after
+ * construction.
+ */
+
+#ifndef HttpServer_h
+#define HttpServer_h
+
+#include "Arduino.h"
+#include <Network.h>
+#include "eventstream.h"
+
+// ============================================================================
+// REQUEST METHOD
+// ============================================================================
+enum HttpMethod : uint8_t {
+    HTTP_METHOD_GET,
+    HTTP_METHOD_POST,
+    HTTP_METHOD_PUT,
+    HTTP_METHOD_DELETE,
+    HTTP_METHOD_OTHER,
+    HTTP_METHOD_ANY         // Route matches every method
+};
+
+class HttpServer;
+class HttpRequest;
+
+/**
+ * Route handler; must answer with send() or stream() before returning
+ * @param request Parsed request, valid only during the call
+ * @param context Opaque pointer given to on()
+ */
+typedef void (*HttpHandler)(HttpRequest& request, void* context);
+
+// ============================================================================
+// STREAMED BODY
+// ============================================================================
+/**
+ * Receives one piece of a streamed body; every write() becomes one chunk
+ */
+class HttpBody {
+public:
+    /**
+     * Append data to the response
+     * @return false if the piece outgrew the connection's output buffer
+     */
+    bool write(const char* data, size_t length);
+
+    /**
+     * Sink adapter for producers that take (data, length, context)
+     * callbacks, e.g. Metrics::writePrometheus(); context is the HttpBody
+     */
+    static void sink(const char* data, size_t length, void* context);
+
+    /**
+     * Pieces produced before this one (0 for the first)
+     */
+    uint32_t piece() const { return _piece; }
+
+private:
+    friend class HttpServer;
+    HttpBody(char* buffer, size_t size, bool chunked, uint32_t piece)
+        : _buffer(buffer), _size(size), _length(0), _chunked(chunked), _overflow(false), _piece(piece) {}
+
+    char* _buffer;
+    size_t _size;
+    size_t _length;
+    bool _chunked;
+    bool _overflow;
+    uint32_t _piece;
+};
+
+/**
+ * Produces the next piece of a streamed body
+ * Called whenever the previous piece has been sent. A piece must fit in
+ * HttpServer::OUTPUT_SIZE (minus chunk framing).
+ * @param body Receives the piece
+ * @param position Resume cursor, updated by the source (starts at the
+ *                 value given to stream())
+ * @param limit Value given to stream(), e.g. the last record to include
+ * @param context Opaque pointer given to stream()
+ * @return true if more pieces follow, false when the body is complete
+ */
+typedef bool (*HttpBodySource)(HttpBody& body, uint32_t& position, uint32_t limit, void* context);
+
+// ============================================================================
+// REQUEST
+// ============================================================================
+class HttpRequest {
+public:
+    HttpMethod method() const { return _method; }
+
+    /**
+     * Path without the query string (NUL-terminated)
+     */
+    const char* path() const { return _path; }
+
+    /**
+     * Copy a decoded query string argument
+     * @param name Argument name
+     * @param value Receives the NUL-terminated value (truncated to fit)
+     * @param size Size of value
+     * @return false if the argument is absent
+     */
+    bool arg(const char* name, char* value, size_t size) const;
+
+    /**
+     * Add a response header; call before send() or stream()
+     */
+    void addHeader(const char* name, const char* value);
+
+    /**
+     * Answer with a complete body
+     * @param status HTTP status code
+     * @param contentType Content-Type header value
+     * @param body Body (not necessarily NUL-terminated)
+     * @param length Body length in bytes
+     */
+    void send(int status, const char* contentType, const char* body, size_t length);
+    void send(int status, const char* contentType, const char* body);
+
+    /**
+     * Answer with a body produced piece by piece (chunked on HTTP/1.1)
+     * @param status HTTP status code
+     * @param contentType Content-Type header value
+     * @param source Body source, called until it returns false
+     * @param context Passed to the source
+     * @param position Initial resume cursor
+     * @param limit Passed to the source unchanged
+     */
+    void stream(int status, const char* contentType, HttpBodySource source, void* context,
+                uint32_t position = 0, uint32_t limit = 0);
+
+    /**
+     * Answer with a text/event-stream that stays open and receives every
+     * event published to events from now on. Answers 503 when
+     * MAX_EVENT_STREAMS subscribers are already connected.
+     * @param events Shared event ring (must outlive the server)
+     * @param initial Events sent to this subscriber first, e.g. the current
+     *                state (EventStream::format() output)
+     * @param length Length of initial, at most OUTPUT_SIZE minus the headers
+     */
+    void subscribe(EventStream& events, const char* initial = nullptr, size_t length = 0);
+
+private:
+    friend class HttpServer;
+    HttpRequest(HttpServer& server, uint8_t slot) : _server(server), _slot(slot) {}
+
+    HttpServer& _server;
+    uint8_t _slot;
+    HttpMethod _method;
+    const char* _path;
+    const char* _query;
+};
+
+// ============================================================================
+// HTTP SERVER CLASS DECLARATION
+// ============================================================================
+class HttpServer {
+public:
+    static const uint8_t MAX_CONNECTIONS = 4;       // Concurrent client connections
+    static const uint8_t MAX_ROUTES = 24;
+    static const size_t ROUTE_PATH_SIZE = 24;      // Longest route path plus NUL
+    static const size_t REQUEST_SIZE = 512;         // Request line and headers
+    static const size_t OUTPUT_SIZE = 3072;         // Response headers or one body piece
+    static const size_t EXTRA_HEADERS_SIZE = 96;    // Headers added with addHeader()
+    static const uint32_t REQUEST_TIMEOUT_MS = 5000;    // Header block must arrive within
+    static const uint32_t KEEPALIVE_TIMEOUT_MS = 5000;  // Idle persistent connection lifetime
+    static const uint32_t WRITE_TIMEOUT_MS = 10000;     // Longest time without send progress
+    static const uint32_t WRITE_RETRY_MS = 5;           // Poll period while the socket is full
+    static const uint8_t MAX_EVENT_STREAMS = 2;     // Slots event subscribers may hold
+
+    /**
+     * Constructor
+     * @param port TCP port to listen on
+     */
+    explicit HttpServer(uint16_t port);
+
+    /**
+     * Register a route for an exact path
+     * @param path Request path without query string (copied)
+     * @param method Method to match, or HTTP_METHOD_ANY
+     * @param handler Called for matching requests
+     * @param context Passed to the handler
+     * @return false if the route table is full or the path too long
+     */
+    bool on(const char* path, HttpMethod method, HttpHandler handler, void* context = nullptr);
+    bool on(const char* path, HttpHandler handler, void* context = nullptr);
+
+    /**
+     * Start listening
+     */
+    void begin();
+
+    /**
+     * Accept connections, read requests and write responses (never blocks)
+     * Each connection handles at most one request per call.
+     */
+    void update();
+
+    /**
+     * Time until update() next has work to do without new network input
+     * Incoming data is only seen by polling, so callers still poll sockets
+     * at their usual period.
+     * @return Milliseconds until update() is needed, or SCHEDULE_IDLE
+     */
+    uint32_t msUntilNextEvent() const;
+
+    /**
+     * Connections currently open
+     */
+    uint8_t activeConnections() const;
+
+    // Counters since boot
+    uint32_t requestsServed() const { return _requestsServed; }
+    uint32_t connectionsAccepted() const { return _connectionsAccepted; }
+    uint32_t connectionsTimedOut() const { return _connectionsTimedOut; }
+    uint32_t subscribersDropped() const { return _subscribersDropped; }
+
+    /**
+     * Event stream subscribers currently connected
+     */
+    uint8_t activeSubscribers() const;
+
+private:
+    friend class HttpRequest;
+
+    enum SlotState : uint8_t {
+        SLOT_FREE,
+        SLOT_READING,       // Waiting for (the rest of) a request header block
+        SLOT_DISCARDING,    // Skipping a request body nobody reads
+        SLOT_WRITING,       // Sending a response
+        SLOT_STREAMING      // Sending events to a subscriber until it disconnects
+    };
+
+    struct Route {
+        char path[ROUTE_PATH_SIZE];
+        HttpMethod method;
+        HttpHandler handler;
+        void* context;
+    };
+
+    struct Connection {
+        NetworkClient client;
+        SlotState state;
+        bool keepAlive;         // Keep the connection after this response
+        bool chunked;           // Streamed body uses chunked encoding (HTTP/1.1)
+        bool responded;         // Handler answered the current request
+        uint32_t lastActivity;  // millis() of the last read or write progress
+
+        char request[REQUEST_SIZE];
+        uint16_t requestLength; // Bytes buffered (may include pipelined requests)
+        uint16_t scanned;       // Bytes already searched for the header end
+        uint32_t discard;       // Request body bytes still to skip
+
+        char output[OUTPUT_SIZE];
+        uint16_t outputStart;   // First unsent byte
+        uint16_t outputLength;  // End of buffered output
+
+        char extraHeaders[EXTRA_HEADERS_SIZE];
+        uint8_t extraHeadersLength;
+
+        HttpBodySource source;  // Streamed body, nullptr once complete
+        void* sourceContext;
+        uint32_t position;
+        uint32_t limit;
+        uint32_t pieces;        // Pieces produced so far
+
+        EventStream* events;    // Subscribed event ring (SLOT_STREAMING)
+        uint32_t cursor;        // Next event byte to send
+    };
+
+    NetworkServer _listener;
+    Route _routes[MAX_ROUTES];
+    uint8_t _routeCount;
+    Connection _connections[MAX_CONNECTIONS];
+
+    uint32_t _requestsServed;
+    uint32_t _connectionsAccepted;
+    uint32_t _connectionsTimedOut;
+    uint32_t _subscribersDropped;
+
+    // Private methods
+    void _accept(uint32_t now);
+    void _service(uint8_t slot, uint32_t now);
+    bool _read(Connection& connection, uint32_t now);
+    bool _parseRequest(uint8_t slot, size_t headerLength);
+    void _dispatch(HttpRequest& request);
+    bool _flush(Connection& connection, uint32_t now);
+    void _refill(Connection& connection);
+    void _finishResponse(Connection& connection);
+    void _streamEvents(Connection& connection, uint32_t now);
+    void _writeHead(Connection& connection, int status, const char* contentType, long contentLength);
+    void _sendError(uint8_t slot, int status, const char* message);
+    void _close(Connection& connection);
+    static int _sendSome(NetworkClient& client, const char* data, size_t length);
+};
+
+#endif // HttpServer_h
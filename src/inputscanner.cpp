@@ -0,0 +1,84 @@
+/**
+ * InputScanner.cpp - ESP32 Swing Gate Controller discrete input scanner
+ *
+ * Implementation of the register sampling and vertical counter debounce.
+ */
+
+#include "inputscanner.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <soc/gpio_reg.h>
+#endif
+
+// ============================================================================
+// INPUT SCANNER CLASS IMPLEMENTATION
+// ============================================================================
+
+InputScanner::InputScanner()
+    : _mask(0), _state(0), _count0(0), _count1(0), _changes(0), _callback(nullptr), _callbackContext(nullptr) {
+}
+
+void InputScanner::begin(const uint8_t* pins, size_t count) {
+    _mask = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (pins[i] < 40) {
+            _mask |= (PinMask)1 << pins[i];
+        } else {
+            Serial.print("[ERROR] Input scanner cannot read GPIO ");
+            Serial.println(pins[i]);
+        }
+    }
+    _state = _readPins();
+    _count0 = 0;
+    _count1 = 0;
+
+    Serial.print("[INPUT] Scanning ");
+    Serial.print(__builtin_popcountll(_mask));
+    Serial.println(" inputs");
+}
+
+void InputScanner::setCallback(InputChangeCallback callback, void* context) {
+    _callback = callback;
+    _callbackContext = context;
+}
+
+PinMask InputScanner::sample() {
+    // Pins that disagree with their debounced level count up; agreeing
+    // pins reset. The counter wraps to zero on the fourth disagreeing
+    // sample, which is when the level toggles.
+    PinMask delta = (_readPins() ^ _state) & _mask;
+    _count1 = (_count1 ^ _count0) & delta;
+    _count0 = ~_count0 & delta;
+    PinMask toggled = delta & ~(_count0 | _count1);
+    _state ^= toggled;
+
+    if (toggled) {
+        _changes += __builtin_popcountll(toggled);
+        for (PinMask pending = toggled; _callback && pending; pending &= pending - 1) {
+            uint8_t pin = __builtin_ctzll(pending);
+            _callback(pin, level(pin), _callbackContext);
+        }
+    }
+    return toggled;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+PinMask InputScanner::_readPins() const {
+#if defined(ARDUINO_ARCH_ESP32)
+    // GPIO_IN_REG holds GPIO 0-31, GPIO_IN1_REG GPIO 32-39 in its low byte
+    return ((PinMask)REG_READ(GPIO_IN_REG) | ((PinMask)(REG_READ(GPIO_IN1_REG) & 0xFF) << 32)) & _mask;
+#else
+    // Host: no registers to read, assemble the same word pin by pin
+    PinMask levels = 0;
+    for (PinMask pending = _mask; pending; pending &= pending - 1) {
+        uint8_t pin = __builtin_ctzll(pending);
+        if (digitalRead(pin)) {
+            levels |= (PinMask)1 << pin;
+        }
+    }
+    return levels;
+#endif
+}
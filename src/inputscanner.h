@@ -0,0 +1,89 @@
+/**
+ * InputScanner.h - ESP32 Swing Gate Controller discrete input scanner
+ *
+ * Samples every scanned input at once from the two GPIO input registers
+ * (GPIO 0-31 and 32-39) and debounces all of them together with a 2-bit
+ * vertical counter: each bit position of _count0/_count1 is the counter of
+ * the pin with that GPIO number, so one sample costs two register reads and
+ * a handful of 64-bit logic operations however many pins are scanned. A
+ * pin's debounced level changes after SAMPLES_TO_ACCEPT consecutive samples
+ * disagree with it; the change callback then runs once per changed pin.
+ */
+
+#ifndef InputScanner_h
+#define InputScanner_h
+
+#include "Arduino.h"
+
+/**
+ * Called from sample() for every debounced level change
+ * @param pin GPIO number
+ * @param level New debounced level (HIGH/LOW)
+ * @param context Opaque pointer given at registration
+ */
+typedef void (*InputChangeCallback)(uint8_t pin, bool level, void* context);
+
+// One bit per GPIO number (bit i = GPIO i)
+typedef uint64_t PinMask;
+
+// ============================================================================
+// INPUT SCANNER CLASS DECLARATION
+// ============================================================================
+class InputScanner {
+public:
+    static const uint8_t SAMPLES_TO_ACCEPT = 4;     // Consecutive samples before a level is taken
+
+    InputScanner();
+
+    /**
+     * Select the scanned pins and take their current levels as debounced
+     * (no change events for the levels found at boot)
+     * Must be called after the GPIO pins are configured
+     * @param pins GPIO numbers (0-39)
+     * @param count Number of entries in pins
+     */
+    void begin(const uint8_t* pins, size_t count);
+
+    /**
+     * Register the debounced change callback
+     * @param callback Callback, or nullptr to remove
+     * @param context Passed to the callback
+     */
+    void setCallback(InputChangeCallback callback, void* context);
+
+    /**
+     * Read all scanned pins and advance the debounce counters; call at a
+     * fixed period (debounce time = SAMPLES_TO_ACCEPT periods)
+     * @return Pins whose debounced level changed in this sample
+     */
+    PinMask sample();
+
+    /**
+     * Debounced level of a scanned pin
+     */
+    bool level(uint8_t pin) const { return (_state >> pin) & 1; }
+
+    /**
+     * Debounced levels of all scanned pins
+     */
+    PinMask levels() const { return _state; }
+
+    /**
+     * Debounced level changes since begin()
+     */
+    uint32_t changes() const { return _changes; }
+
+private:
+    PinMask _mask;          // Scanned pins
+    PinMask _state;         // Debounced levels
+    PinMask _count0;        // Vertical counter, low bit per pin
+    PinMask _count1;        // Vertical counter, high bit per pin
+    uint32_t _changes;
+
+    InputChangeCallback _callback;
+    void* _callbackContext;
+
+    PinMask _readPins() const;
+};
+
+#endif // InputScanner_h
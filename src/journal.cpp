@@ -0,0 +1,317 @@
+/**
+ * Journal.cpp - ESP32 Swing Gate Controller transition journal
+ *
+ * Implementation of the segment ring. Every append is flushed so at most
+ * the record being written is lost on power failure; a torn tail is
+ * detected by its check byte and the ring moves on to the next segment.
+ */
+
+#include "journal.h"
+#include <stdarg.h>
+
+const char JOURNAL_CSV_HEADER[] = "sequence,uptime_ms,from,to,source,gate\n";
+
+namespace {
+
+const size_t RECORD_SIZE = sizeof(JournalRecord);
+const size_t READ_BATCH = 16;   // Records read per flash access when streaming
+
+// Buffered CSV output handed to the sink in chunks
+class CsvWriter {
+public:
+    CsvWriter(JournalSink sink, void* context) : _sink(sink), _context(context), _length(0) {}
+
+    ~CsvWriter() { flush(); }
+
+    void printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char line[LINE_SIZE];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (length <= 0) {
+            return;
+        }
+        if ((size_t)length >= sizeof(line)) {
+            length = sizeof(line) - 1;
+        }
+        if (_length + length > sizeof(_buffer)) {
+            flush();
+        }
+        memcpy(_buffer + _length, line, length);
+        _length += length;
+    }
+
+    void flush() {
+        if (_length > 0) {
+            _sink(_buffer, _length, _context);
+            _length = 0;
+        }
+    }
+
+private:
+    static const size_t LINE_SIZE = 64;
+
+    JournalSink _sink;
+    void* _context;
+    char _buffer[512];
+    size_t _length;
+};
+
+const char* sourceName(uint8_t source) {
+    return source == JOURNAL_SOURCE_BOOT ? "boot" : commandSourceName((CommandSource)source);
+}
+
+const char* stateName(uint8_t state) {
+    return state < GATE_STATE_COUNT ? gateStateName((GateState)state) : "INVALID";
+}
+
+} // namespace
+
+// ============================================================================
+// JOURNAL CLASS IMPLEMENTATION
+// ============================================================================
+
+Journal::Journal(fs::FS& fs, const char* directory)
+    : _fs(fs), _ready(false), _segment(0), _segmentRecords(0), _nextSequence(1),
+      _failedWrites(0) {
+    strncpy(_directory, directory, sizeof(_directory) - 1);
+    _directory[sizeof(_directory) - 1] = '\0';
+    for (uint8_t i = 0; i < SEGMENT_COUNT; i++) {
+        _firstSequence[i] = 0;
+    }
+}
+
+bool Journal::begin() {
+    if (!_fs.exists(_directory) && !_fs.mkdir(_directory)) {
+        Serial.println("[ERROR] Journal directory could not be created");
+        return false;
+    }
+
+    // The newest segment is the one with the highest first sequence
+    bool found = false;
+    for (uint8_t i = 0; i < SEGMENT_COUNT; i++) {
+        char path[40];
+        _segmentPath(i, path, sizeof(path));
+        fs::File file = _fs.open(path, FILE_READ);
+        JournalRecord record;
+        if (file && file.read((uint8_t*)&record, RECORD_SIZE) == RECORD_SIZE && _valid(record)) {
+            _firstSequence[i] = record.sequence;
+            if (!found || record.sequence > _firstSequence[_segment]) {
+                _segment = i;
+                found = true;
+            }
+        }
+    }
+
+    if (found) {
+        uint32_t lastSequence = 0;
+        bool torn = false;
+        _segmentRecords = _scanSegment(_segment, lastSequence, torn);
+        _nextSequence = lastSequence + 1;
+        if (torn) {
+            // Never append behind a damaged record: continue in the next segment
+            Serial.println("[JOURNAL] Torn record at end of journal, starting new segment");
+            _segmentRecords = SEGMENT_RECORDS;
+        }
+    } else {
+        // Empty journal: segment 0 will be (re)created by the first append
+        _segment = SEGMENT_COUNT - 1;
+        _segmentRecords = SEGMENT_RECORDS;
+    }
+
+    if (_segmentRecords < SEGMENT_RECORDS) {
+        char path[40];
+        _segmentPath(_segment, path, sizeof(path));
+        _file = _fs.open(path, FILE_APPEND);
+        if (!_file) {
+            Serial.println("[ERROR] Journal segment could not be opened");
+            return false;
+        }
+    }
+    _ready = true;
+
+    Serial.print("[JOURNAL] Journal ready, next sequence ");
+    Serial.println(_nextSequence);
+
+    // Boot marker: timestamps of the following records restart from here
+    JournalRecord boot;
+    boot.sequence = _nextSequence;
+    boot.timestamp = millis();
+    boot.from = GATE_UNKNOWN;
+    boot.to = GATE_UNKNOWN;
+    boot.source = JOURNAL_SOURCE_BOOT;
+    return _write(boot);
+}
+
+bool Journal::append(const GateTransition& transition) {
+    if (!_ready) {
+        return false;
+    }
+
+    JournalRecord record;
+    record.sequence = _nextSequence;
+    record.timestamp = transition.timestamp;
+    record.from = (uint8_t)(transition.from | (transition.gate << 4));
+    record.to = transition.to;
+    record.source = transition.source;
+    return _write(record);
+}
+
+uint32_t Journal::streamCsv(uint32_t since, JournalSink sink, void* context) {
+    sink(JOURNAL_CSV_HEADER, strlen(JOURNAL_CSV_HEADER), context);
+    return streamCsv(since, UINT32_MAX, UINT16_MAX, sink, context);
+}
+
+uint32_t Journal::streamCsv(uint32_t since, uint32_t until, uint16_t maxRecords,
+                            JournalSink sink, void* context) {
+    if (!_ready) {
+        return since;
+    }
+    CsvWriter csv(sink, context);
+
+    // Visit segments oldest first; the current one is always the newest
+    uint8_t order[SEGMENT_COUNT];
+    for (uint8_t i = 0; i < SEGMENT_COUNT; i++) {
+        order[i] = (_segment + 1 + i) % SEGMENT_COUNT;
+    }
+
+    uint32_t last = since;
+    uint16_t written = 0;
+    for (uint8_t i = 0; i < SEGMENT_COUNT && written < maxRecords; i++) {
+        uint8_t segment = order[i];
+        uint32_t first = _firstSequence[segment];
+        if (first == 0 || first > until) {
+            continue;
+        }
+
+        char path[40];
+        _segmentPath(segment, path, sizeof(path));
+        fs::File file = _fs.open(path, FILE_READ);
+        if (!file) {
+            continue;
+        }
+
+        // Records are contiguous within a segment: jump straight to the cursor
+        uint32_t skip = since >= first ? since - first + 1 : 0;
+        if ((size_t)skip * RECORD_SIZE >= file.size() || !file.seek(skip * RECORD_SIZE)) {
+            continue;
+        }
+
+        JournalRecord batch[READ_BATCH];
+        bool done = false;
+        while (!done) {
+            size_t count = file.read((uint8_t*)batch, sizeof(batch)) / RECORD_SIZE;
+            for (size_t j = 0; j < count; j++) {
+                const JournalRecord& record = batch[j];
+                if (!_valid(record) || record.sequence > until || written >= maxRecords) {
+                    done = true;
+                    break;
+                }
+                if (record.sequence <= since) {
+                    continue;
+                }
+                csv.printf("%u,%u,%s,%s,%s,%u\n", (unsigned)record.sequence, (unsigned)record.timestamp,
+                           stateName(record.from & 0x0F), stateName(record.to), sourceName(record.source),
+                           (unsigned)(record.from >> 4));
+                last = record.sequence;
+                written++;
+            }
+            if (count < READ_BATCH) {
+                done = true;
+            }
+        }
+    }
+    return last;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+bool Journal::_write(const JournalRecord& record) {
+    if (_segmentRecords >= SEGMENT_RECORDS && !_rotate()) {
+        _failedWrites++;
+        return false;
+    }
+
+    JournalRecord stored = record;
+    stored.check = _check(stored);
+    if (_file.write((const uint8_t*)&stored, RECORD_SIZE) != RECORD_SIZE) {
+        // A partial record is caught by its check byte; don't write behind it
+        _failedWrites++;
+        _segmentRecords = SEGMENT_RECORDS;
+        return false;
+    }
+    _file.flush();
+
+    if (_segmentRecords == 0) {
+        _firstSequence[_segment] = stored.sequence;
+    }
+    _segmentRecords++;
+    _nextSequence++;
+    return true;
+}
+
+bool Journal::_rotate() {
+    _file.close();
+    _segment = (_segment + 1) % SEGMENT_COUNT;
+    _firstSequence[_segment] = 0;
+    _segmentRecords = 0;
+
+    // Truncate the oldest segment and start over in it
+    char path[40];
+    _segmentPath(_segment, path, sizeof(path));
+    _file = _fs.open(path, FILE_WRITE);
+    if (!_file) {
+        Serial.println("[ERROR] Journal segment could not be reused");
+        _segmentRecords = SEGMENT_RECORDS;
+        return false;
+    }
+    return true;
+}
+
+uint16_t Journal::_scanSegment(uint8_t segment, uint32_t& lastSequence, bool& torn) {
+    char path[40];
+    _segmentPath(segment, path, sizeof(path));
+    fs::File file = _fs.open(path, FILE_READ);
+    size_t size = file ? file.size() : 0;
+
+    uint16_t count = 0;
+    JournalRecord batch[READ_BATCH];
+    size_t read;
+    while (count < SEGMENT_RECORDS && (read = file.read((uint8_t*)batch, sizeof(batch)) / RECORD_SIZE) > 0) {
+        for (size_t j = 0; j < read; j++) {
+            if (!_valid(batch[j]) || batch[j].sequence != _firstSequence[segment] + count) {
+                torn = true;
+                return count;
+            }
+            lastSequence = batch[j].sequence;
+            count++;
+        }
+    }
+
+    torn = (size_t)count * RECORD_SIZE != size;
+    return count;
+}
+
+void Journal::_segmentPath(uint8_t segment, char* path, size_t size) const {
+    snprintf(path, size, "%s/%u.log", _directory, (unsigned)segment);
+}
+
+uint8_t Journal::_check(const JournalRecord& record) {
+    // CRC-8, polynomial 0x07
+    const uint8_t* bytes = (const uint8_t*)&record;
+    uint8_t crc = 0;
+    for (size_t i = 0; i < RECORD_SIZE - 1; i++) {
+        crc ^= bytes[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+bool Journal::_valid(const JournalRecord& record) {
+    return record.sequence != 0 && record.check == _check(record);
+}
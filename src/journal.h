@@ -0,0 +1,132 @@
+/**
+ * Journal.h - ESP32 Swing Gate Controller transition journal
+ *
+ * Append-only ring of fixed-size binary records on LittleFS, one per gate
+ * transition, so the history survives reboots without a serial cable. The
+ * ring is split into segment files; when the newest is full the oldest is
+ * truncated and reused, which keeps the flash footprint bounded and lets
+ * LittleFS spread the erase cycles.
+ *
+ * The journal is written and read by the network task only: the control
+ * task hands transitions over through ControlTask::pollTransition(), so a
+ * slow flash write never delays relay or sensor handling.
+ */
+
+#ifndef Journal_h
+#define Journal_h
+
+#include "Arduino.h"
+#include <FS.h>
+#include "controltask.h"
+
+// ============================================================================
+// RECORD FORMAT
+// ============================================================================
+/**
+ * One journal entry as stored on flash (little-endian, 12 bytes)
+ * The check byte is a CRC-8 of the other bytes, so a record torn by a power
+ * loss or an erased (0xFF) area is never mistaken for a transition.
+ */
+struct JournalRecord {
+    uint32_t sequence;      // Monotonic across reboots, starts at 1
+    uint32_t timestamp;     // millis() since the boot the record belongs to
+    uint8_t from;           // GateState before (low nibble), gate index (high nibble)
+    uint8_t to;             // GateState after
+    uint8_t source;         // CommandSource, or JOURNAL_SOURCE_BOOT
+    uint8_t check;          // CRC-8 of the preceding 11 bytes
+};
+static_assert(sizeof(JournalRecord) == 12, "Journal record layout changed");
+static_assert(Gate::GATE_COUNT <= 16 && GATE_STATE_COUNT <= 16,
+              "Journal packs the gate index and state into one byte");
+
+// Source of the marker record written once per boot
+const uint8_t JOURNAL_SOURCE_BOOT = 0xFF;
+
+/**
+ * Output chunk sink for streaming (e.g. WebServer::sendContent)
+ */
+typedef void (*JournalSink)(const char* data, size_t length, void* context);
+
+// First line of the CSV export
+extern const char JOURNAL_CSV_HEADER[];
+
+// ============================================================================
+// JOURNAL CLASS DECLARATION
+// ============================================================================
+class Journal {
+public:
+    static const uint8_t SEGMENT_COUNT = 4;         // Files in the ring
+    static const uint16_t SEGMENT_RECORDS = 512;    // Records per file (6 KB)
+
+    /**
+     * Constructor
+     * @param fs Mounted filesystem (LittleFS)
+     * @param directory Directory holding the segment files
+     */
+    Journal(fs::FS& fs, const char* directory);
+
+    /**
+     * Find the newest segment, resume the sequence and write a boot marker
+     * @return false if the filesystem is unusable (journal stays disabled)
+     */
+    bool begin();
+
+    /**
+     * Append one transition (network task only)
+     * @return false if the journal is disabled or the write failed
+     */
+    bool append(const GateTransition& transition);
+
+    /**
+     * Stream records newer than a cursor as CSV, a few records at a time
+     * Columns: sequence,uptime_ms,from,to,source,gate
+     * @param since Only records with a larger sequence are written (0 = all)
+     * @param sink Receives the output in chunks of at most 512 bytes
+     * @param context Passed to the sink
+     * @return Sequence of the last record written, or since if none
+     */
+    uint32_t streamCsv(uint32_t since, JournalSink sink, void* context);
+
+    /**
+     * Stream a bounded batch of records, without the header line
+     * For callers that send the output a piece at a time.
+     * @param since Only records with a larger sequence are written
+     * @param until Records with a larger sequence are not written
+     * @param maxRecords Stop after this many records
+     * @param sink Receives the output in chunks of at most 512 bytes
+     * @param context Passed to the sink
+     * @return Sequence of the last record written, or since if none
+     */
+    uint32_t streamCsv(uint32_t since, uint32_t until, uint16_t maxRecords,
+                       JournalSink sink, void* context);
+
+    /**
+     * Sequence of the newest record (0 if the journal is empty)
+     */
+    uint32_t lastSequence() const { return _nextSequence - 1; }
+
+    /**
+     * Appends that did not reach flash
+     */
+    uint32_t failedWrites() const { return _failedWrites; }
+
+private:
+    fs::FS& _fs;
+    char _directory[24];            // Segment directory
+    bool _ready;                    // begin() succeeded
+    uint8_t _segment;               // Segment being appended to
+    uint16_t _segmentRecords;       // Records in that segment
+    uint32_t _nextSequence;         // Sequence of the next record
+    uint32_t _firstSequence[SEGMENT_COUNT]; // First record of each segment, 0 = empty
+    fs::File _file;                 // Append handle of the current segment
+    uint32_t _failedWrites;
+
+    bool _write(const JournalRecord& record);
+    bool _rotate();
+    uint16_t _scanSegment(uint8_t segment, uint32_t& lastSequence, bool& torn);
+    void _segmentPath(uint8_t segment, char* path, size_t size) const;
+    static uint8_t _check(const JournalRecord& record);
+    static bool _valid(const JournalRecord& record);
+};
+
+#endif // Journal_h
@@ -6,14 +6,16 @@
  */
 
 #include "ledmanager.h"
+#include "logger.h"
 
 
 // ============================================================================
 // LED MANAGER CLASS IMPLEMENTATION
 // ============================================================================
 
-LEDManager::LEDManager(int redPin, int greenPin)
-    : _redPin(redPin), _greenPin(greenPin), _blinkState(false),
+LEDManager::LEDManager(Scheduler& scheduler, int redPin, int greenPin)
+    : _redPin(redPin), _greenPin(greenPin), _scheduler(scheduler),
+      _blinkTimer(NO_SCHEDULE), _blinkState(false),
       _redBlinking(false), _greenBlinking(false), _bothBlinking(false),
       _initialized(false), _redLedState(false), _greenLedState(false) {
   Serial.println("[LED] LEDManager constructor called");
@@ -39,46 +41,36 @@ void LEDManager::initialize() {
   Serial.println(_greenPin);
 }
 
-void LEDManager::update() {
-  if (!_initialized)
-    return;
-
-  // Tick the blink timer
-  _blinkTimer.tick();
-}
-
 void LEDManager::setStatus(GateState state) {
   if (!_initialized) {
-    Serial.println("[LED] LED manager not initialized, ignoring status update");
+    LOG_WARN("[LED] LED manager not initialized, ignoring status update");
     return;
   }
 
-  Serial.print("[LED] Setting LED status for gate state: ");
-
   switch (state) {
   case GATE_CLOSED:
-    Serial.println("CLOSED (solid red)");
+    LOG_INFO("[LED] Setting LED status for gate state: CLOSED (solid red)");
     solidRed();
     break;
 
   case GATE_OPEN:
-    Serial.println("OPEN (solid green)");
+    LOG_INFO("[LED] Setting LED status for gate state: OPEN (solid green)");
     solidGreen();
     break;
 
   case GATE_OPENING:
-    Serial.println("OPENING (blinking green)");
+    LOG_INFO("[LED] Setting LED status for gate state: OPENING (blinking green)");
     blinkGreen();
     break;
 
   case GATE_CLOSING:
-    Serial.println("CLOSING (blinking red)");
+    LOG_INFO("[LED] Setting LED status for gate state: CLOSING (blinking red)");
     blinkRed();
     break;
 
   case GATE_UNKNOWN:
   default:
-    Serial.println("UNKNOWN (blinking both LEDs)");
+    LOG_INFO("[LED] Setting LED status for gate state: UNKNOWN (blinking both LEDs)");
     blinkBoth();
     break;
   }
@@ -88,14 +80,14 @@ void LEDManager::solidRed() {
   _stopBlinking();
   _setRedLED(true);
   _setGreenLED(false);
-  Serial.println("[LED] Red LED set to solid ON");
+  LOG_DEBUG("[LED] Red LED set to solid ON");
 }
 
 void LEDManager::solidGreen() {
   _stopBlinking();
   _setRedLED(false);
   _setGreenLED(true);
-  Serial.println("[LED] Green LED set to solid ON");
+  LOG_DEBUG("[LED] Green LED set to solid ON");
 }
 
 void LEDManager::blinkRed() {
@@ -106,15 +98,9 @@ void LEDManager::blinkRed() {
   _blinkState = true;
   _setRedLED(true); // Start with LED on
 
-  // Set up timer for 500ms blinking interval
-  _blinkTimer.every(
-      500,
-      [](void *manager) -> bool {
-        return static_cast<LEDManager *>(manager)->_blinkTimerCallback(nullptr);
-      },
-      this);
+  _startBlinking();
 
-  Serial.println("[LED] Red LED set to BLINKING (500ms interval)");
+  LOG_DEBUG("[LED] Red LED set to BLINKING (500ms interval)");
 }
 
 void LEDManager::blinkGreen() {
@@ -125,15 +111,9 @@ void LEDManager::blinkGreen() {
   _blinkState = true;
   _setGreenLED(true); // Start with LED on
 
-  // Set up timer for 500ms blinking interval
-  _blinkTimer.every(
-      500,
-      [](void *manager) -> bool {
-        return static_cast<LEDManager *>(manager)->_blinkTimerCallback(nullptr);
-      },
-      this);
+  _startBlinking();
 
-  Serial.println("[LED] Green LED set to BLINKING (500ms interval)");
+  LOG_DEBUG("[LED] Green LED set to BLINKING (500ms interval)");
 }
 
 void LEDManager::blinkBoth() {
@@ -144,22 +124,16 @@ void LEDManager::blinkBoth() {
   _setRedLED(true);   // Start with both LEDs on
   _setGreenLED(true);
 
-  // Set up timer for 500ms blinking interval
-  _blinkTimer.every(
-      500,
-      [](void *manager) -> bool {
-        return static_cast<LEDManager *>(manager)->_blinkTimerCallback(nullptr);
-      },
-      this);
+  _startBlinking();
 
-  Serial.println("[LED] Both LEDs set to BLINKING (500ms interval)");
+  LOG_DEBUG("[LED] Both LEDs set to BLINKING (500ms interval)");
 }
 
 void LEDManager::allOff() {
   _stopBlinking();
   _setRedLED(false);
   _setGreenLED(false);
-  Serial.println("[LED] All LEDs turned OFF");
+  LOG_DEBUG("[LED] All LEDs turned OFF");
 }
 
 // ============================================================================
@@ -180,21 +154,33 @@ void LEDManager::_setGreenLED(bool state) {
   }
 }
 
+void LEDManager::_startBlinking() {
+  // Set up deadline for 500ms blinking interval
+  _blinkTimer = _scheduler.every(
+      500,
+      [](void *manager) -> bool {
+        return static_cast<LEDManager *>(manager)->_blinkTimerCallback(nullptr);
+      },
+      this);
+}
+
 void LEDManager::_stopBlinking() {
+  // Cancel the blink deadline so an idle LED pattern costs no wake-ups
+  _scheduler.cancel(_blinkTimer);
+
   if (_redBlinking || _greenBlinking || _bothBlinking) {
-    // Note: arduino-timer doesn't have cancel(), so we just reset our flags
-    // The timer callback will check these flags and stop automatically
     _redBlinking = false;
     _greenBlinking = false;
     _bothBlinking = false;
     _blinkState = false;
-    Serial.println("[LED] Blinking stopped");
+    LOG_DEBUG("[LED] Blinking stopped");
   }
 }
 
 bool LEDManager::_blinkTimerCallback(void *argument) {
   // Check if we should continue blinking
   if (!_redBlinking && !_greenBlinking && !_bothBlinking) {
+    _blinkTimer = NO_SCHEDULE;
     return false; // Stop the timer
   }
 
@@ -9,8 +9,8 @@
 #define LEDManager_h
 
 #include "Arduino.h"
-#include <arduino-timer.h>
 #include "gate.h"  // Include gate.h for GateState enum
+#include "scheduler.h"
 
 // ============================================================================
 // LED MANAGER CLASS DECLARATION
@@ -19,10 +19,11 @@ class LEDManager {
 public:
     /**
      * Constructor - Initialize LED manager
+     * @param scheduler Scheduler of the task owning the LEDs (blink deadlines)
      * @param redPin GPIO pin for red LED (gate closed indicator)
      * @param greenPin GPIO pin for green LED (gate open indicator)
      */
-    LEDManager(int redPin, int greenPin);
+    LEDManager(Scheduler& scheduler, int redPin, int greenPin);
     
     /**
      * Destructor - Clean up resources
@@ -35,12 +36,6 @@ public:
      */
     void initialize();
     
-    /**
-     * Update LED states and handle blinking
-     * Should be called regularly in main loop
-     */
-    void update();
-    
     /**
      * Set LED status based on gate state
      * @param state Current gate state to display
@@ -82,8 +77,9 @@ private:
     int _redPin;        // Red LED pin (closed/closing indicator)
     int _greenPin;      // Green LED pin (open/opening indicator)
     
-    // Timer management
-    Timer<> _blinkTimer;    // Timer for blinking control
+    // Deadline management
+    Scheduler& _scheduler;  // Owning task's scheduler
+    ScheduleId _blinkTimer; // Periodic blink toggle
     
     // State tracking
     bool _blinkState;       // Current blink state (on/off)
@@ -99,6 +95,7 @@ private:
     // Private methods
     void _setRedLED(bool state);
     void _setGreenLED(bool state);
+    void _startBlinking();
     void _stopBlinking();
     bool _blinkTimerCallback(void* argument);
 };
@@ -0,0 +1,169 @@
+/**
+ * LinkManager.cpp - ESP32 Swing Gate Controller network link manager
+ *
+ * Implementation of the link selection state machine.
+ */
+
+#include "linkmanager.h"
+#include "logger.h"
+
+// Link snapshot bits, kept alongside the queue so a lost event can be recovered
+static const uint8_t LINK_BIT_ETHERNET = 0x01;
+static const uint8_t LINK_BIT_WIFI = 0x02;
+
+const char* linkEventName(LinkEvent event) {
+    switch (event) {
+        case LINK_EVENT_ETH_UP:    return "ETH_UP";
+        case LINK_EVENT_ETH_DOWN:  return "ETH_DOWN";
+        case LINK_EVENT_WIFI_UP:   return "WIFI_UP";
+        case LINK_EVENT_WIFI_DOWN: return "WIFI_DOWN";
+        default:                   return "INVALID";
+    }
+}
+
+// ============================================================================
+// LINK MANAGER CLASS IMPLEMENTATION
+// ============================================================================
+
+LinkManager::LinkManager(NetworkClient* ethernetClient, NetworkClient* wifiClient)
+    : _ethernetClient(ethernetClient), _wifiClient(wifiClient),
+      _startWifi(nullptr), _stopWifi(nullptr), _wifiRetryInterval(10000),
+      _linkSnapshot(0), _droppedEvents(0),
+      _ethernetUp(false), _wifiUp(false), _handledDrops(0),
+      _state(LINK_DOWN), _activeClient(nullptr),
+      _wifiStarted(false), _lastWifiAttempt(0) {
+}
+
+void LinkManager::setWifiActions(LinkAction startWifi, LinkAction stopWifi) {
+    _startWifi = startWifi;
+    _stopWifi = stopWifi;
+}
+
+void LinkManager::setWifiRetryInterval(unsigned long interval) {
+    _wifiRetryInterval = interval;
+}
+
+void LinkManager::begin() {
+    // Give Ethernet one retry interval to come up before falling back to WiFi
+    _lastWifiAttempt = millis();
+    Serial.println("[LINK] Link manager started");
+}
+
+void LinkManager::postEvent(LinkEvent event) {
+    // Snapshot first, so it is never older than the queued events
+    uint8_t snapshot = _linkSnapshot.load(std::memory_order_relaxed);
+    switch (event) {
+        case LINK_EVENT_ETH_UP:    snapshot |= LINK_BIT_ETHERNET;           break;
+        case LINK_EVENT_ETH_DOWN:  snapshot &= (uint8_t)~LINK_BIT_ETHERNET; break;
+        case LINK_EVENT_WIFI_UP:   snapshot |= LINK_BIT_WIFI;               break;
+        case LINK_EVENT_WIFI_DOWN: snapshot &= (uint8_t)~LINK_BIT_WIFI;     break;
+    }
+    _linkSnapshot.store(snapshot, std::memory_order_release);
+
+    if (!_events.push(event)) {
+        _droppedEvents.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void LinkManager::update() {
+    unsigned long currentTime = millis();
+
+    // Apply every queued event once, in the order it was posted
+    LinkEvent event;
+    while (_events.pop(event)) {
+        _applyEvent(event);
+    }
+
+    // Queue overflowed: the applied sequence is incomplete, so take the
+    // link facts from the snapshot instead
+    uint32_t dropped = _droppedEvents.load(std::memory_order_acquire);
+    if (dropped != _handledDrops) {
+        LOG_WARN("[LINK] Event queue overflow (%u lost) - resynchronizing", dropped - _handledDrops);
+        _handledDrops = dropped;
+        uint8_t snapshot = _linkSnapshot.load(std::memory_order_acquire);
+        _ethernetUp = snapshot & LINK_BIT_ETHERNET;
+        _wifiUp = snapshot & LINK_BIT_WIFI;
+    }
+
+    if (_ethernetUp) {
+        // Ethernet is preferred - drop any WiFi attempt
+        if (_wifiStarted) {
+            if (_stopWifi) _stopWifi();
+            _wifiStarted = false;
+        }
+        _setState(LINK_ETHERNET);
+        return;
+    }
+
+    if (_wifiUp) {
+        _setState(LINK_WIFI);
+        return;
+    }
+
+    // No link: start (or restart) a WiFi attempt once the retry interval elapsed
+    if (currentTime - _lastWifiAttempt >= _wifiRetryInterval) {
+        _lastWifiAttempt = currentTime;
+        if (_startWifi) {
+            LOG_INFO("[LINK] No link - starting WiFi attempt");
+            _startWifi();
+            _wifiStarted = true;
+            _setState(LINK_WIFI_CONNECTING);
+            return;
+        }
+    }
+
+    if (_state != LINK_WIFI_CONNECTING) {
+        _setState(LINK_DOWN);
+    }
+}
+
+LinkState LinkManager::getState() const {
+    return _state;
+}
+
+NetworkClient* LinkManager::getActiveClient() const {
+    return _activeClient;
+}
+
+uint32_t LinkManager::droppedEvents() const {
+    return _droppedEvents.load(std::memory_order_relaxed);
+}
+
+const char* LinkManager::getStateString() const {
+    switch (_state) {
+        case LINK_DOWN:            return "DOWN";
+        case LINK_ETHERNET:        return "ETHERNET";
+        case LINK_WIFI_CONNECTING: return "WIFI_CONNECTING";
+        case LINK_WIFI:            return "WIFI";
+        default:                   return "INVALID";
+    }
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+void LinkManager::_applyEvent(LinkEvent event) {
+    LOG_INFO("[LINK] Event: %s", linkEventName(event));
+
+    switch (event) {
+        case LINK_EVENT_ETH_UP:    _ethernetUp = true;  break;
+        case LINK_EVENT_ETH_DOWN:  _ethernetUp = false; break;
+        case LINK_EVENT_WIFI_UP:   _wifiUp = true;      break;
+        case LINK_EVENT_WIFI_DOWN: _wifiUp = false;     break;
+    }
+}
+
+void LinkManager::_setState(LinkState newState) {
+    if (_state == newState) return;
+
+    const char* oldState = getStateString();
+    _state = newState;
+    LOG_INFO("[LINK] Link state changed: %s -> %s", oldState, getStateString());
+
+    switch (_state) {
+        case LINK_ETHERNET: _activeClient = _ethernetClient; break;
+        case LINK_WIFI:     _activeClient = _wifiClient;     break;
+        default:            _activeClient = nullptr;         break;
+    }
+}
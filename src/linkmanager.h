@@ -0,0 +1,139 @@
+/**
+ * LinkManager.h - ESP32 Swing Gate Controller network link manager
+ *
+ * Event-driven state machine that selects the active network link
+ * (Ethernet preferred, WiFi as fallback). Link events are posted by the
+ * network event task into a lock-free queue; update() applies them exactly
+ * once and in order, then derives the active client and starts WiFi
+ * attempts without ever waiting for them to complete. All state other than
+ * the queue is owned by the task calling update().
+ */
+
+#ifndef LinkManager_h
+#define LinkManager_h
+
+#include "Arduino.h"
+#include <Network.h>
+#include "spscqueue.h"
+
+// ============================================================================
+// LINK STATE AND EVENT ENUMERATIONS
+// ============================================================================
+enum LinkState : byte {
+    LINK_DOWN,              // No usable link
+    LINK_ETHERNET,          // Ethernet has an IP address
+    LINK_WIFI_CONNECTING,   // WiFi association/DHCP in progress
+    LINK_WIFI               // WiFi has an IP address
+};
+
+enum LinkEvent : byte {
+    LINK_EVENT_ETH_UP,      // Ethernet obtained an IP address
+    LINK_EVENT_ETH_DOWN,    // Ethernet lost link or IP address
+    LINK_EVENT_WIFI_UP,     // WiFi obtained an IP address
+    LINK_EVENT_WIFI_DOWN    // WiFi disconnected or lost its IP address
+};
+
+/**
+ * Get event name for logging without allocating
+ */
+const char* linkEventName(LinkEvent event);
+
+typedef void (*LinkAction)();
+
+// ============================================================================
+// LINK MANAGER CLASS DECLARATION
+// ============================================================================
+class LinkManager {
+public:
+    static const size_t EVENT_QUEUE_SIZE = 16;  // Events buffered between updates
+
+    /**
+     * Constructor
+     * @param ethernetClient Client used while Ethernet is the active link
+     * @param wifiClient Client used while WiFi is the active link
+     */
+    LinkManager(NetworkClient* ethernetClient, NetworkClient* wifiClient);
+
+    /**
+     * Set the non-blocking actions used to start and stop WiFi
+     * @param startWifi Begin association (e.g. WiFi.begin()), must return immediately
+     * @param stopWifi Drop WiFi (e.g. WiFi.disconnect())
+     */
+    void setWifiActions(LinkAction startWifi, LinkAction stopWifi);
+
+    /**
+     * Set how long to wait for Ethernet or a WiFi attempt before (re)trying WiFi
+     * @param interval Retry interval in milliseconds
+     */
+    void setWifiRetryInterval(unsigned long interval);
+
+    /**
+     * Start link management
+     */
+    void begin();
+
+    /**
+     * Report a link event
+     * Only call from the network event task (single producer); never blocks.
+     * @param event Link event
+     */
+    void postEvent(LinkEvent event);
+
+    /**
+     * Apply reported events and drive WiFi fallback
+     * Should be called regularly in main loop; never blocks.
+     */
+    void update();
+
+    /**
+     * Get current link state
+     * @return Current LinkState enumeration value
+     */
+    LinkState getState() const;
+
+    /**
+     * Get the client for the active link
+     * @return Active client, or nullptr if no link is up
+     */
+    NetworkClient* getActiveClient() const;
+
+    /**
+     * Get state as string for logging
+     */
+    const char* getStateString() const;
+
+    /**
+     * Number of events lost because the queue was full
+     * Lost events are recovered from the link snapshot, not replayed.
+     */
+    uint32_t droppedEvents() const;
+
+private:
+    // Clients per link
+    NetworkClient* _ethernetClient;
+    NetworkClient* _wifiClient;
+
+    // WiFi actions
+    LinkAction _startWifi;
+    LinkAction _stopWifi;
+    unsigned long _wifiRetryInterval;
+
+    // Written by the network event task, read by update()
+    SpscQueue<LinkEvent, EVENT_QUEUE_SIZE> _events;     // Ordered event hand-off
+    std::atomic<uint8_t> _linkSnapshot;                 // LINK_BIT_* after the last posted event
+    std::atomic<uint32_t> _droppedEvents;               // Events lost to a full queue
+
+    // State owned by the task calling update()
+    bool _ethernetUp;               // Ethernet has an IP address
+    bool _wifiUp;                   // WiFi has an IP address
+    uint32_t _handledDrops;         // _droppedEvents already resynchronized
+    LinkState _state;
+    NetworkClient* _activeClient;
+    bool _wifiStarted;              // WiFi attempt in progress or connected
+    unsigned long _lastWifiAttempt; // Timestamp of last WiFi start (or begin())
+
+    void _applyEvent(LinkEvent event);
+    void _setState(LinkState newState);
+};
+
+#endif // LinkManager_h
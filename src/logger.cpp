@@ -0,0 +1,185 @@
+/**
+ * Logger.cpp - ESP32 Swing Gate Controller asynchronous logger
+ *
+ * Implementation of the record formatter, the sinks and the log task.
+ */
+
+#include "logger.h"
+
+namespace {
+
+const char LEVEL_LETTERS[] = {'-', 'E', 'W', 'I', 'D'};
+
+// Format one conversion into out; returns the length it wanted
+int formatConversion(char* out, size_t size, const char* spec, size_t specLength,
+                     char conversion, const LogArg& arg) {
+    // spec holds '%' and the flags/width/precision; add the conversion
+    // with the length modifier matching the stored 64-bit value
+    char full[24];
+    memcpy(full, spec, specLength);
+    size_t n = specLength;
+
+    switch (conversion) {
+        case 'd': case 'i':
+            full[n++] = 'l'; full[n++] = 'l'; full[n++] = conversion; full[n] = '\0';
+            return snprintf(out, size, full, (long long)arg.i);
+        case 'u': case 'x': case 'X': case 'o':
+            full[n++] = 'l'; full[n++] = 'l'; full[n++] = conversion; full[n] = '\0';
+            return snprintf(out, size, full, (unsigned long long)arg.u);
+        case 'c':
+            full[n++] = 'c'; full[n] = '\0';
+            return snprintf(out, size, full, (int)arg.i);
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            full[n++] = conversion; full[n] = '\0';
+            return snprintf(out, size, full, arg.d);
+        case 's':
+            full[n++] = 's'; full[n] = '\0';
+            return snprintf(out, size, full, arg.s ? arg.s : "(null)");
+        default:
+            return snprintf(out, size, "%%%c", conversion);    // Unsupported: print as is
+    }
+}
+
+} // namespace
+
+Logger logger;
+
+// ============================================================================
+// LOGGER CLASS IMPLEMENTATION
+// ============================================================================
+
+Logger::Logger()
+    : _dropped(0),
+      _reportedDropped(0),
+      _sinkCount(0)
+#if defined(ARDUINO_ARCH_ESP32)
+      , _taskHandle(nullptr)
+#endif
+{
+}
+
+bool Logger::addSink(LogSink sink, void* context) {
+    if (_sinkCount >= MAX_SINKS) {
+        return false;
+    }
+    _sinks[_sinkCount] = sink;
+    _sinkContexts[_sinkCount] = context;
+    _sinkCount++;
+    return true;
+}
+
+size_t Logger::drain(size_t maxRecords) {
+    char line[LINE_SIZE];
+    size_t drained = 0;
+    LogRecord record;
+    while (drained < maxRecords && _queue.pop(record)) {
+        _emit(line, _format(record, line));
+        drained++;
+    }
+
+    // Report drops once the ring has room again, so the report itself fits
+    uint32_t dropped = _dropped.load(std::memory_order_relaxed);
+    if (dropped != _reportedDropped && _queue.empty()) {
+        int length = snprintf(line, sizeof(line), "%lu.%03lu W [LOG] %lu records dropped\n",
+                              (unsigned long)(millis() / 1000), (unsigned long)(millis() % 1000),
+                              (unsigned long)(dropped - _reportedDropped));
+        _reportedDropped = dropped;
+        _emit(line, length < (int)sizeof(line) ? length : sizeof(line) - 1);
+    }
+    return drained;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool Logger::start(uint8_t core, uint8_t priority) {
+    BaseType_t result = xTaskCreatePinnedToCore(_taskEntry, "log", STACK_SIZE,
+                                                this, priority, &_taskHandle, core);
+    if (result != pdPASS) {
+        Serial.println("[ERROR] Failed to create log task");
+        return false;
+    }
+
+    Serial.print("[LOG] Log task started on core ");
+    Serial.print(core);
+    Serial.print(", priority ");
+    Serial.println(priority);
+    return true;
+}
+
+void Logger::_taskEntry(void* argument) {
+    Logger* self = static_cast<Logger*>(argument);
+
+    for (;;) {
+        // Writing to a sink may block on the UART or socket; only this
+        // task waits, the producers keep queueing
+        if (self->drain(DRAIN_BATCH) == 0) {
+            vTaskDelay(pdMS_TO_TICKS(IDLE_MS));
+        }
+    }
+}
+#endif
+
+void Logger::serialSink(const char* line, size_t length, void*) {
+    Serial.write((const uint8_t*)line, length);
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+size_t Logger::_format(const LogRecord& record, char* line) const {
+    // Leave room for the newline
+    const size_t limit = LINE_SIZE - 1;
+    char level = LEVEL_LETTERS[record.level < sizeof(LEVEL_LETTERS) ? record.level : 0];
+    int written = snprintf(line, limit, "%lu.%03lu %c ", (unsigned long)(record.timestampMs / 1000),
+                           (unsigned long)(record.timestampMs % 1000), level);
+    size_t length = written > 0 ? (size_t)written < limit ? (size_t)written : limit - 1 : 0;
+
+    const char* p = record.format;
+    uint8_t next = 0;
+    while (*p && length < limit - 1) {
+        if (*p != '%') {
+            line[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            line[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Flags, width and precision are kept; length modifiers are dropped
+        char spec[16];
+        size_t specLength = 0;
+        spec[specLength++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && specLength < sizeof(spec) - 4) {
+            spec[specLength++] = *p++;
+        }
+        while (*p && strchr("hlLzjt", *p)) {
+            p++;
+        }
+        char conversion = *p;
+        if (!conversion) {
+            break;
+        }
+        p++;
+
+        if (next >= record.argCount) {
+            line[length++] = '?';   // Format asks for more arguments than were logged
+            continue;
+        }
+        written = formatConversion(line + length, limit - length, spec, specLength,
+                                   conversion, record.args[next++]);
+        if (written > 0) {
+            length += (size_t)written < limit - length ? (size_t)written : limit - length - 1;
+        }
+    }
+
+    line[length++] = '\n';
+    return length;
+}
+
+void Logger::_emit(const char* line, size_t length) {
+    for (uint8_t i = 0; i < _sinkCount; i++) {
+        _sinks[i](line, length, _sinkContexts[i]);
+    }
+}
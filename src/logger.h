@@ -0,0 +1,211 @@
+/**
+ * Logger.h - ESP32 Swing Gate Controller asynchronous logger
+ *
+ * Logging without blocking the caller. A LOG_* call stores a compact record
+ * (format string pointer, timestamp and up to LOG_MAX_ARGS raw arguments)
+ * in a lock-free ring buffer and returns; formatting and output happen
+ * later on a low-priority task that drains the ring into the registered
+ * sinks (Serial, a TCP client). A burst of state change messages therefore
+ * costs the control loop a few hundred nanoseconds instead of waiting for
+ * the UART FIFO to empty at 115200 baud. A full ring drops records and
+ * counts them; the drain reports the count.
+ *
+ * Records keep pointers, not copies: format strings and %s arguments must
+ * outlive the record (string literals, gateStateName() and the other
+ * static name tables). Conversions are printf-style; length modifiers are
+ * accepted and ignored since every argument is stored as 64 bits.
+ *
+ * Levels below LOG_LEVEL compile to nothing, arguments included. Set it
+ * with a build flag, e.g. -DLOG_LEVEL=LOG_LEVEL_WARN for release builds.
+ */
+
+#ifndef Logger_h
+#define Logger_h
+
+#include "Arduino.h"
+#include "mpscqueue.h"
+#include <type_traits>
+
+// ============================================================================
+// LOG LEVELS
+// ============================================================================
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Filtered calls are still type-checked, then removed as dead code
+#define LOG_DISCARD(...) do { if (false) logger.write(0, __VA_ARGS__); } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logger.write(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) logger.write(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) logger.write(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logger.write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISCARD(__VA_ARGS__)
+#endif
+
+const uint8_t LOG_MAX_ARGS = 4;
+
+// ============================================================================
+// LOG RECORD
+// ============================================================================
+union LogArg {
+    int64_t i;          // Signed integers (sign-extended)
+    uint64_t u;         // Unsigned integers, enums, bools
+    double d;           // Floating point
+    const char* s;      // Static strings only
+};
+
+struct LogRecord {
+    const char* format;             // Static printf-style format
+    uint32_t timestampMs;           // millis() when logged
+    uint8_t level;                  // LOG_LEVEL_*
+    uint8_t argCount;
+    LogArg args[LOG_MAX_ARGS];
+};
+
+template <typename T>
+inline LogArg logArg(T value) {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "Log arguments must be integers, floating point or static strings");
+    LogArg arg;
+    if (std::is_signed<T>::value) {
+        arg.i = (int64_t)value;
+    } else {
+        arg.u = (uint64_t)value;
+    }
+    return arg;
+}
+
+inline LogArg logArg(double value) { LogArg arg; arg.d = value; return arg; }
+inline LogArg logArg(float value) { LogArg arg; arg.d = value; return arg; }
+inline LogArg logArg(const char* value) { LogArg arg; arg.s = value; return arg; }
+inline LogArg logArg(char* value) { LogArg arg; arg.s = value; return arg; }
+
+/**
+ * Output for formatted lines (newline included)
+ * @param line Line text, not NUL-terminated
+ * @param length Line length in bytes
+ * @param context Opaque pointer given at registration
+ */
+typedef void (*LogSink)(const char* line, size_t length, void* context);
+
+// ============================================================================
+// LOGGER CLASS DECLARATION
+// ============================================================================
+class Logger {
+public:
+    static const size_t QUEUE_SIZE = 64;        // Records, power of two
+    static const size_t LINE_SIZE = 192;        // Longest formatted line
+    static const uint8_t MAX_SINKS = 2;
+    static const size_t DRAIN_BATCH = 16;       // Records per log task pass
+    static const uint32_t IDLE_MS = 10;         // Log task sleep when the ring is empty
+    static const uint32_t STACK_SIZE = 4096;
+
+    Logger();
+
+    /**
+     * Queue a record (any task; never blocks)
+     * Use the LOG_* macros so that filtered levels compile away
+     * @param level LOG_LEVEL_*
+     * @param format Static printf-style format
+     * @param args Integers, floating point or static strings
+     * @return false if the ring was full and the record was dropped
+     */
+    template <typename... Args>
+    bool write(uint8_t level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+        LogRecord record;
+        record.format = format;
+        record.timestampMs = millis();
+        record.level = level;
+        record.argCount = sizeof...(Args);
+        const LogArg values[] = {logArg(args)..., LogArg()};
+        for (uint8_t i = 0; i < sizeof...(Args); i++) {
+            record.args[i] = values[i];
+        }
+
+        if (!_queue.push(record)) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Add an output; call before start() (sinks are not locked)
+     * @return false if MAX_SINKS are already registered
+     */
+    bool addSink(LogSink sink, void* context);
+
+    /**
+     * Format queued records and write them to every sink (single consumer:
+     * the log task on the ESP32, the main loop on the host)
+     * @param maxRecords Records to format at most
+     * @return Records formatted
+     */
+    size_t drain(size_t maxRecords = QUEUE_SIZE);
+
+#if defined(ARDUINO_ARCH_ESP32)
+    /**
+     * Start the task that drains the ring
+     * @param core CPU core to pin the task to
+     * @param priority FreeRTOS priority (below the gate control task)
+     * @return false if the task could not be created
+     */
+    bool start(uint8_t core, uint8_t priority);
+#endif
+
+    /**
+     * Records dropped because the ring was full
+     */
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * Sink that writes lines to Serial
+     */
+    static void serialSink(const char* line, size_t length, void* context);
+
+private:
+    MpscQueue<LogRecord, QUEUE_SIZE> _queue;
+    std::atomic<uint32_t> _dropped;
+    uint32_t _reportedDropped;      // dropped() at the last drop report (consumer only)
+
+    LogSink _sinks[MAX_SINKS];
+    void* _sinkContexts[MAX_SINKS];
+    uint8_t _sinkCount;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    TaskHandle_t _taskHandle;
+    static void _taskEntry(void* argument);
+#endif
+
+    size_t _format(const LogRecord& record, char* line) const;
+    void _emit(const char* line, size_t length);
+};
+
+extern Logger logger;
+
+#endif // Logger_h
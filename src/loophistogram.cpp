@@ -0,0 +1,110 @@
+/**
+ * LoopHistogram.cpp - ESP32 Swing Gate Controller loop period histogram
+ *
+ * Single writer, any reader: the owning task updates each counter with a
+ * relaxed load/store pair, readers see every counter atomically but not
+ * necessarily a consistent set, which is fine for diagnostics.
+ */
+
+#include "loophistogram.h"
+
+// ============================================================================
+// LOOP HISTOGRAM CLASS IMPLEMENTATION
+// ============================================================================
+
+LoopHistogram::LoopHistogram() : _count(0), _sum(0), _max(0), _lastTickUs(0), _started(false) {
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void LoopHistogram::tick() {
+    uint32_t now = micros();
+    if (_started) {
+        record(now - _lastTickUs);
+    }
+    _lastTickUs = now;
+    _started = true;
+}
+
+void LoopHistogram::record(uint32_t periodUs) {
+    std::atomic<uint32_t>& slot = _buckets[_bucketIndex(periodUs)];
+    slot.store(slot.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _sum.store(_sum.load(std::memory_order_relaxed) + periodUs, std::memory_order_relaxed);
+    if (periodUs > _max.load(std::memory_order_relaxed)) {
+        _max.store(periodUs, std::memory_order_relaxed);
+    }
+}
+
+uint32_t LoopHistogram::count() const {
+    return _count.load(std::memory_order_relaxed);
+}
+
+uint64_t LoopHistogram::sumMicros() const {
+    return _sum.load(std::memory_order_relaxed);
+}
+
+uint32_t LoopHistogram::maxPeriod() const {
+    return _max.load(std::memory_order_relaxed);
+}
+
+uint32_t LoopHistogram::bucket(uint8_t index) const {
+    return index < BUCKET_COUNT ? _buckets[index].load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t LoopHistogram::percentile(float fraction) const {
+    uint32_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    uint32_t target = (uint32_t)(fraction * total);
+    if (target >= total) {
+        target = total - 1;
+    }
+
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += bucket(i);
+        if (seen > target) {
+            // The open-ended last bucket is bounded by the observed maximum
+            return i == BUCKET_COUNT - 1 ? maxPeriod() : (2UL << i);
+        }
+    }
+    return maxPeriod();
+}
+
+void LoopHistogram::print(const char* name, Print& out) const {
+    out.print("[LOOP] ");
+    out.print(name);
+    out.print(": periods ");
+    out.print(count());
+    out.print(", p50 <");
+    out.print(percentile(0.50f));
+    out.print("us, p99 <");
+    out.print(percentile(0.99f));
+    out.print("us, max ");
+    out.print(maxPeriod());
+    out.println("us");
+
+    out.print("[LOOP] ");
+    out.print(name);
+    out.print(" buckets:");
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        uint32_t n = bucket(i);
+        if (n == 0) {
+            continue;
+        }
+        out.print(" <");
+        out.print(2UL << i);
+        out.print("us:");
+        out.print(n);
+    }
+    out.println();
+}
+
+uint8_t LoopHistogram::_bucketIndex(uint32_t periodUs) {
+    uint8_t index = periodUs ? 31 - __builtin_clz(periodUs) : 0;
+    return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+}
@@ -0,0 +1,84 @@
+/**
+ * LoopHistogram.h - ESP32 Swing Gate Controller loop period histogram
+ *
+ * Records the time between successive iterations of a task loop into
+ * power-of-two microsecond buckets. One task records, any other task may
+ * read and print it, so the control loop's jitter bound can be observed
+ * without stopping it.
+ */
+
+#ifndef LoopHistogram_h
+#define LoopHistogram_h
+
+#include "Arduino.h"
+#include <atomic>
+
+// ============================================================================
+// LOOP HISTOGRAM CLASS DECLARATION
+// ============================================================================
+class LoopHistogram {
+public:
+    // Bucket i counts periods in [2^i, 2^(i+1)) us; the last one is open-ended
+    static const uint8_t BUCKET_COUNT = 22;
+
+    LoopHistogram();
+
+    /**
+     * Mark the start of a loop iteration (owning task only)
+     * Records the period since the previous call; the first call only
+     * starts the measurement.
+     */
+    void tick();
+
+    /**
+     * Record one period directly (owning task only)
+     * @param periodUs Period in microseconds
+     */
+    void record(uint32_t periodUs);
+
+    /**
+     * Number of recorded periods
+     */
+    uint32_t count() const;
+
+    /**
+     * Sum of all recorded periods in microseconds
+     */
+    uint64_t sumMicros() const;
+
+    /**
+     * Longest recorded period in microseconds
+     */
+    uint32_t maxPeriod() const;
+
+    /**
+     * Upper bound of the bucket containing the given percentile
+     * @param fraction Percentile as a fraction (0.99 = p99)
+     * @return Period bound in microseconds, 0 if nothing was recorded
+     */
+    uint32_t percentile(float fraction) const;
+
+    /**
+     * Count of a single bucket
+     */
+    uint32_t bucket(uint8_t index) const;
+
+    /**
+     * Print a one-line summary followed by the non-empty buckets
+     * @param name Task name used as the line prefix
+     * @param out Output stream (usually Serial)
+     */
+    void print(const char* name, Print& out) const;
+
+private:
+    std::atomic<uint32_t> _buckets[BUCKET_COUNT];  // Period counts
+    std::atomic<uint32_t> _count;                  // Total recorded periods
+    std::atomic<uint64_t> _sum;                    // Sum of periods (us)
+    std::atomic<uint32_t> _max;                    // Longest period (us)
+    uint32_t _lastTickUs;                          // micros() of previous tick
+    bool _started;                                 // First tick seen
+
+    static uint8_t _bucketIndex(uint32_t periodUs);
+};
+
+#endif // LoopHistogram_h
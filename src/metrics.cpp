@@ -0,0 +1,218 @@
+/**
+ * Metrics.cpp - ESP32 Swing Gate Controller performance metrics
+ *
+ * Implementation of the cycle histograms and the Prometheus exporter.
+ * The exporter formats into a small stack buffer and hands out chunks, so
+ * a scrape never allocates regardless of the number of series.
+ */
+
+#include "metrics.h"
+#include <stdarg.h>
+
+const uint32_t CycleHistogram::BOUNDS_US[CycleHistogram::BOUND_COUNT] = {
+    1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 10000, 100000
+};
+
+const char* metricsSubsystemName(MetricsSubsystem subsystem) {
+    switch (subsystem) {
+        case SUBSYSTEM_GATE:           return "gate";
+        case SUBSYSTEM_CONTROL_TIMERS: return "control_timers";
+        case SUBSYSTEM_MQTT:           return "mqtt";
+        case SUBSYSTEM_HTTP:           return "http";
+        case SUBSYSTEM_NETWORK_TIMERS: return "network_timers";
+        default:               return "invalid";
+    }
+}
+
+// ============================================================================
+// CYCLE HISTOGRAM CLASS IMPLEMENTATION
+// ============================================================================
+
+CycleHistogram::CycleHistogram() : _count(0), _sumCycles(0) {
+    for (uint8_t i = 0; i <= BOUND_COUNT; i++) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+    setCyclesPerMicro(240);
+}
+
+void CycleHistogram::setCyclesPerMicro(uint32_t cyclesPerMicro) {
+    for (uint8_t i = 0; i < BOUND_COUNT; i++) {
+        _boundCycles[i] = BOUNDS_US[i] * cyclesPerMicro;
+    }
+}
+
+void CycleHistogram::record(uint32_t cycles) {
+    uint8_t index = 0;
+    while (index < BOUND_COUNT && cycles > _boundCycles[index]) {
+        index++;
+    }
+
+    // Single writer: plain load/store instead of read-modify-write
+    std::atomic<uint32_t>& slot = _buckets[index];
+    slot.store(slot.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _sumCycles.store(_sumCycles.load(std::memory_order_relaxed) + cycles, std::memory_order_relaxed);
+    _count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+uint32_t CycleHistogram::count() const {
+    return _count.load(std::memory_order_relaxed);
+}
+
+uint64_t CycleHistogram::sumCycles() const {
+    return _sumCycles.load(std::memory_order_relaxed);
+}
+
+uint32_t CycleHistogram::bucket(uint8_t index) const {
+    return index <= BOUND_COUNT ? _buckets[index].load(std::memory_order_relaxed) : 0;
+}
+
+// ============================================================================
+// PROMETHEUS WRITER
+// ============================================================================
+namespace {
+
+class PrometheusWriter {
+public:
+    PrometheusWriter(MetricsSink sink, void* context) : _sink(sink), _context(context), _length(0) {}
+
+    ~PrometheusWriter() { flush(); }
+
+    void printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char line[LINE_SIZE];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (length <= 0) {
+            return;
+        }
+        if ((size_t)length >= sizeof(line)) {
+            length = sizeof(line) - 1;
+        }
+        if (_length + length > sizeof(_buffer)) {
+            flush();
+        }
+        memcpy(_buffer + _length, line, length);
+        _length += length;
+    }
+
+    void flush() {
+        if (_length > 0) {
+            _sink(_buffer, _length, _context);
+            _length = 0;
+        }
+    }
+
+private:
+    static const size_t LINE_SIZE = 160;
+
+    MetricsSink _sink;
+    void* _context;
+    char _buffer[512];
+    size_t _length;
+};
+
+} // namespace
+
+// ============================================================================
+// METRICS REGISTRY CLASS IMPLEMENTATION
+// ============================================================================
+
+Metrics::Metrics() : _cyclesPerMicro(240), _loopCount(0) {
+}
+
+void Metrics::begin() {
+    _cyclesPerMicro = ESP.getCpuFreqMHz();
+    for (uint8_t i = 0; i < SUBSYSTEM_COUNT; i++) {
+        _subsystems[i].setCyclesPerMicro(_cyclesPerMicro);
+    }
+}
+
+CycleHistogram* Metrics::subsystem(MetricsSubsystem subsystem) {
+    return subsystem < SUBSYSTEM_COUNT ? &_subsystems[subsystem] : nullptr;
+}
+
+void Metrics::addLoopHistogram(const char* task, const LoopHistogram* histogram) {
+    if (_loopCount >= MAX_LOOP_HISTOGRAMS) {
+        Serial.println("[ERROR] Too many loop histograms for metrics");
+        return;
+    }
+    _loopNames[_loopCount] = task;
+    _loopHistograms[_loopCount] = histogram;
+    _loopCount++;
+}
+
+void Metrics::writePrometheus(MetricsSink sink, void* context) const {
+    uint32_t section = 0;
+    while (writePrometheus(section, sink, context)) {
+    }
+}
+
+bool Metrics::writePrometheus(uint32_t& section, MetricsSink sink, void* context) const {
+    PrometheusWriter out(sink, context);
+    double cyclesPerSecond = (double)_cyclesPerMicro * 1e6;
+    uint32_t loopStart = SUBSYSTEM_COUNT + 1;
+    uint32_t maxSection = loopStart + _loopCount;
+    uint32_t lastSection = _loopCount > 0 ? maxSection : (uint32_t)SUBSYSTEM_COUNT;
+
+    if (section == 0) {
+        out.printf("# HELP gateguardian_uptime_seconds Time since boot.\n");
+        out.printf("# TYPE gateguardian_uptime_seconds gauge\n");
+        out.printf("gateguardian_uptime_seconds %lu\n", (unsigned long)(millis() / 1000));
+
+        // Subsystem execution time per call
+        out.printf("# HELP gateguardian_subsystem_duration_seconds Execution time per call of each subsystem update.\n");
+        out.printf("# TYPE gateguardian_subsystem_duration_seconds histogram\n");
+    } else if (section < loopStart) {
+        const CycleHistogram& histogram = _subsystems[section - 1];
+        const char* name = metricsSubsystemName((MetricsSubsystem)(section - 1));
+
+        // Count is derived from the buckets so +Inf always matches the
+        // finite buckets, even when the task records during a scrape
+        uint64_t sum = histogram.sumCycles();
+        uint32_t cumulative = 0;
+        for (uint8_t i = 0; i < CycleHistogram::BOUND_COUNT; i++) {
+            cumulative += histogram.bucket(i);
+            out.printf("gateguardian_subsystem_duration_seconds_bucket{subsystem=\"%s\",le=\"%g\"} %lu\n",
+                       name, CycleHistogram::BOUNDS_US[i] * 1e-6, (unsigned long)cumulative);
+        }
+        uint32_t count = cumulative + histogram.bucket(CycleHistogram::BOUND_COUNT);
+        out.printf("gateguardian_subsystem_duration_seconds_bucket{subsystem=\"%s\",le=\"+Inf\"} %lu\n",
+                   name, (unsigned long)count);
+        out.printf("gateguardian_subsystem_duration_seconds_sum{subsystem=\"%s\"} %.9g\n",
+                   name, sum / cyclesPerSecond);
+        out.printf("gateguardian_subsystem_duration_seconds_count{subsystem=\"%s\"} %lu\n",
+                   name, (unsigned long)count);
+    } else if (section < maxSection) {
+        // Task loop periods (time between iteration starts)
+        uint8_t t = section - loopStart;
+        if (t == 0) {
+            out.printf("# HELP gateguardian_loop_period_seconds Time between successive iterations of each task loop.\n");
+            out.printf("# TYPE gateguardian_loop_period_seconds histogram\n");
+        }
+        const LoopHistogram& histogram = *_loopHistograms[t];
+        const char* name = _loopNames[t];
+
+        uint64_t sum = histogram.sumMicros();
+        uint32_t cumulative = 0;
+        for (uint8_t i = 0; i + 1 < LoopHistogram::BUCKET_COUNT; i++) {
+            cumulative += histogram.bucket(i);
+            out.printf("gateguardian_loop_period_seconds_bucket{task=\"%s\",le=\"%g\"} %lu\n",
+                       name, (double)(2UL << i) * 1e-6, (unsigned long)cumulative);
+        }
+        uint32_t count = cumulative + histogram.bucket(LoopHistogram::BUCKET_COUNT - 1);
+        out.printf("gateguardian_loop_period_seconds_bucket{task=\"%s\",le=\"+Inf\"} %lu\n",
+                   name, (unsigned long)count);
+        out.printf("gateguardian_loop_period_seconds_sum{task=\"%s\"} %.9g\n", name, sum * 1e-6);
+        out.printf("gateguardian_loop_period_seconds_count{task=\"%s\"} %lu\n", name, (unsigned long)count);
+    } else if (section == maxSection) {
+        out.printf("# HELP gateguardian_loop_period_max_seconds Longest loop period since boot.\n");
+        out.printf("# TYPE gateguardian_loop_period_max_seconds gauge\n");
+        for (uint8_t t = 0; t < _loopCount; t++) {
+            out.printf("gateguardian_loop_period_max_seconds{task=\"%s\"} %g\n",
+                       _loopNames[t], _loopHistograms[t]->maxPeriod() * 1e-6);
+        }
+    }
+
+    return ++section <= lastSection;
+}
@@ -0,0 +1,160 @@
+/**
+ * Metrics.h - ESP32 Swing Gate Controller performance metrics
+ *
+ * Per-subsystem execution time histograms measured with the CPU cycle
+ * counter, plus the task loop period histograms, exported in Prometheus
+ * text format. Recording is allocation- and lock-free; each histogram has
+ * a single writer (the task running the subsystem) and may be read from
+ * the web server at any time.
+ */
+
+#ifndef Metrics_h
+#define Metrics_h
+
+#include "Arduino.h"
+#include <atomic>
+#include "loophistogram.h"
+
+// ============================================================================
+// SUBSYSTEM ENUMERATION
+// ============================================================================
+enum MetricsSubsystem : uint8_t {
+    SUBSYSTEM_GATE,             // Gate::update (control task)
+    SUBSYSTEM_CONTROL_TIMERS,   // Scheduler::tick incl. relay/LED deadlines (control task)
+    SUBSYSTEM_MQTT,             // MQTTManager::update (network task)
+    SUBSYSTEM_HTTP,             // HttpServer::update (network task)
+    SUBSYSTEM_NETWORK_TIMERS,   // Scheduler::tick (network task)
+    SUBSYSTEM_COUNT
+};
+
+/**
+ * Get subsystem label value without allocating
+ */
+const char* metricsSubsystemName(MetricsSubsystem subsystem);
+
+// ============================================================================
+// CYCLE HISTOGRAM CLASS DECLARATION
+// ============================================================================
+class CycleHistogram {
+public:
+    // Finite bucket upper bounds in microseconds; one more bucket is +Inf
+    static const uint8_t BOUND_COUNT = 13;
+    static const uint32_t BOUNDS_US[BOUND_COUNT];
+
+    CycleHistogram();
+
+    /**
+     * Set the cycle counter frequency used to place samples in buckets
+     * @param cyclesPerMicro CPU clock in MHz
+     */
+    void setCyclesPerMicro(uint32_t cyclesPerMicro);
+
+    /**
+     * Record one call duration (owning task only)
+     * @param cycles Elapsed CPU cycles
+     */
+    void record(uint32_t cycles);
+
+    uint32_t count() const;
+    uint64_t sumCycles() const;
+
+    /**
+     * Non-cumulative count of one bucket (index BOUND_COUNT is +Inf)
+     */
+    uint32_t bucket(uint8_t index) const;
+
+private:
+    uint32_t _boundCycles[BOUND_COUNT];             // BOUNDS_US in cycles
+    std::atomic<uint32_t> _buckets[BOUND_COUNT + 1];
+    std::atomic<uint32_t> _count;
+    std::atomic<uint64_t> _sumCycles;
+};
+
+// ============================================================================
+// CYCLE TIMER
+// ============================================================================
+/**
+ * Scoped timer: records the cycles spent between construction and
+ * destruction. A null histogram disables the measurement.
+ * Cycle counters are per core, so only time code in a pinned task.
+ */
+class CycleTimer {
+public:
+    explicit CycleTimer(CycleHistogram* histogram)
+        : _histogram(histogram), _start(ESP.getCycleCount()) {}
+
+    ~CycleTimer() {
+        if (_histogram) {
+            _histogram->record(ESP.getCycleCount() - _start);
+        }
+    }
+
+private:
+    CycleHistogram* _histogram;
+    uint32_t _start;
+};
+
+// ============================================================================
+// METRICS REGISTRY CLASS DECLARATION
+// ============================================================================
+/**
+ * Output callback for the exporter
+ * @param data Text chunk (not null-terminated)
+ * @param length Chunk length in bytes
+ * @param context Opaque pointer given to writePrometheus()
+ */
+typedef void (*MetricsSink)(const char* data, size_t length, void* context);
+
+class Metrics {
+public:
+    static const uint8_t MAX_LOOP_HISTOGRAMS = 4;
+
+    Metrics();
+
+    /**
+     * Read the CPU frequency for cycle conversion
+     * Call once from setup() before recording.
+     */
+    void begin();
+
+    /**
+     * Histogram for a subsystem, for use with CycleTimer
+     */
+    CycleHistogram* subsystem(MetricsSubsystem subsystem);
+
+    /**
+     * Export a task loop period histogram
+     * @param task Label value (static string)
+     * @param histogram Histogram owned by the task
+     */
+    void addLoopHistogram(const char* task, const LoopHistogram* histogram);
+
+    /**
+     * Write all metrics in Prometheus text exposition format (0.0.4)
+     * Output is produced in chunks of at most a few hundred bytes.
+     * @param sink Chunk consumer (e.g. WebServer::sendContent)
+     * @param context Opaque pointer passed to the sink
+     */
+    void writePrometheus(MetricsSink sink, void* context) const;
+
+    /**
+     * Write one section of the exposition (uptime, one histogram, ...)
+     * For callers that send the output a piece at a time; a section is at
+     * most about 2 KB.
+     * @param section Section to write (start at 0), advanced on return
+     * @param sink Chunk consumer
+     * @param context Opaque pointer passed to the sink
+     * @return true if more sections follow
+     */
+    bool writePrometheus(uint32_t& section, MetricsSink sink, void* context) const;
+
+private:
+    CycleHistogram _subsystems[SUBSYSTEM_COUNT];
+    uint32_t _cyclesPerMicro;
+
+    const char* _loopNames[MAX_LOOP_HISTOGRAMS];
+    const LoopHistogram* _loopHistograms[MAX_LOOP_HISTOGRAMS];
+    uint8_t _loopCount;
+};
+
+#endif // Metrics_h
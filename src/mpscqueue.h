@@ -0,0 +1,100 @@
+/**
+ * MpscQueue.h - ESP32 Swing Gate Controller lock-free queue
+ *
+ * Fixed-capacity multi-producer/single-consumer ring buffer. Producers on
+ * either core claim a slot with one compare-and-swap and publish it through
+ * the slot's sequence number, so push() never blocks, never disables
+ * interrupts and never allocates; a full queue drops the item instead.
+ *
+ * A producer preempted between claiming and publishing its slot holds back
+ * the consumer (not the other producers) until it resumes, so the queue
+ * suits task producers; ISRs should keep to SpscQueue.
+ */
+
+#ifndef MpscQueue_h
+#define MpscQueue_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// ============================================================================
+// MPSC QUEUE TEMPLATE
+// ============================================================================
+template <typename T, size_t Capacity>
+class MpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscQueue capacity must be a power of two");
+
+public:
+    MpscQueue() : _head(0), _tail(0) {
+        for (uint32_t i = 0; i < Capacity; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Append an item (any number of producers)
+     * @param item Item to copy into the queue
+     * @return false if the queue is full and the item was dropped
+     */
+    bool push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = _slots[head & (Capacity - 1)];
+            int32_t lag = (int32_t)(slot.sequence.load(std::memory_order_acquire) - head);
+            if (lag == 0) {
+                // Slot free for this position: claim it
+                if (_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    slot.item = item;
+                    slot.sequence.store(head + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;   // Not consumed yet one lap ago: full
+            } else {
+                head = _head.load(std::memory_order_relaxed);   // Another producer won
+            }
+        }
+    }
+
+    /**
+     * Remove the oldest item (single consumer)
+     * @param item Receives the item
+     * @return false if the queue is empty (or the oldest slot is still being written)
+     */
+    bool pop(T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        Slot& slot = _slots[tail & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+            return false;
+        }
+        item = slot.item;
+        slot.sequence.store(tail + Capacity, std::memory_order_release);
+        _tail.store(tail + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Number of claimed slots (approximate when called concurrently)
+     */
+    size_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;     // Position + 1 once written, + Capacity once read
+        T item;
+    };
+
+    Slot _slots[Capacity];
+    std::atomic<uint32_t> _head;    // Next position to claim (producers)
+    std::atomic<uint32_t> _tail;    // Next position to read (consumer)
+};
+
+#endif // MpscQueue_h
@@ -7,6 +7,7 @@
 
 #include "Arduino.h"
 #include "mqttmanager.h"
+#include "logger.h"
 #include <ETH.h>
 
 // Static instance pointer for callback handling
@@ -18,10 +19,12 @@ MQTTManager* MQTTManager::_instance = nullptr;
 
 MQTTManager::MQTTManager(const char* broker, int port, const char* clientId,
                          const char* statusTopic, const char* commandTopic)
-    : _port(port), _ethClient(nullptr), _mqttClient(nullptr),
+    : _port(port), _availabilityRetain(true), _ethClient(nullptr), _mqttClient(nullptr),
       _initialized(false), _wifiConnected(false), _autoPublishEnabled(true),
-      _lastPublish(0), _lastConnectionAttempt(0), _reconnectAttempts(0),
-      _gateController(nullptr) {
+      _changedGates(0), _lastPublish(0), _heartbeatInterval(60000),
+      _publishHoldoff(250), _statusFormat(STATUS_FORMAT_JSON), _statusQos(1),
+      _statusRetain(true), _lastConnectionAttempt(0), _reconnectAttempts(0),
+      _controlTask(nullptr) {
     
     // Copy configuration strings
     strncpy(_broker, broker, sizeof(_broker) - 1);
@@ -36,6 +39,21 @@ MQTTManager::MQTTManager(const char* broker, int port, const char* clientId,
     strncpy(_commandTopic, commandTopic, sizeof(_commandTopic) - 1);
     _commandTopic[sizeof(_commandTopic) - 1] = '\0';
     
+    // No availability topic until setAvailability()
+    _availabilityTopic[0] = '\0';
+    _onlinePayload[0] = '\0';
+    _offlinePayload[0] = '\0';
+    
+    // Status snapshot starts with no inputs or climate reading
+    memset(&_status, 0, sizeof(_status));
+    _status.deviceId = _clientId;
+    _status.state = GATE_UNKNOWN;
+    for (uint8_t gate = 0; gate < Gate::GATE_COUNT; gate++) {
+        _gateStates[gate] = GATE_UNKNOWN;
+    }
+    _sensorRaw = 0;
+    _statusMessage[0] = '\0';
+    
     // Set static instance for callback handling
     _instance = this;
     
@@ -46,6 +64,12 @@ MQTTManager::~MQTTManager() {
     Serial.println("[MQTT] MQTTManager destructor called");
     
     if (_mqttClient) {
+        // A clean disconnect discards the Last Will: report offline first
+        if (_availabilityTopic[0] && _mqttClient->connected()) {
+            _outbox.enqueue(_availabilityTopic, (const uint8_t*)_offlinePayload,
+                            strlen(_offlinePayload), 0, _availabilityRetain);
+            _outbox.transmit();
+        }
         _mqttClient->disconnect();
         delete _mqttClient;
     }
@@ -80,10 +104,16 @@ void MQTTManager::initialize(NetworkClient* activeClient) {
         return;
     }
     
-    // Configure MQTT client
+    // Configure MQTT client; it talks to the broker through the outbox
+    _mqttClient->setClient(_outbox);
     _mqttClient->setServer(_broker, _port);
     _mqttClient->setCallback(_messageCallback);
     
+    // Allocate the packet buffer once, sized for the status message
+    if (!_mqttClient->setBufferSize(PACKET_BUFFER_SIZE)) {
+        Serial.println("[ERROR] Failed to allocate MQTT packet buffer");
+    }
+    
     _initialized = true;
     
     Serial.print("[MQTT] MQTT manager initialized - Broker: ");
@@ -126,22 +156,27 @@ void MQTTManager::update() {
     // }
     // mqttClient.loop();
     
-    // Tick timers
-    _publishTimer.tick();
-    _reconnectTimer.tick();
-
     // Update the client reference in case connection switched between Ethernet/WiFi
     if (_ethClient) {
         if (debug) Serial.println("[MQTT] Setting client...");
-        _mqttClient->setClient(*_ethClient);
+        _outbox.setClient(_ethClient);
     }
     
-    // Handle MQTT client loop
+    // Handle MQTT client loop; loop() reads the PUBACKs, then everything
+    // queued goes out in one write
     if (_mqttClient && _mqttClient->connected()) {
         if (debug) Serial.println("[MQTT] Looping...");
         _mqttClient->loop();
+        // loop() reads one packet; the PUBACKs of a batch arrive together
+        for (uint8_t i = 0; i < MqttOutbox::CAPACITY && _outbox.available() > 0; i++) {
+            _mqttClient->loop();
+        }
+        _publishPendingStatus();
+        _outbox.transmit();
     } else {
         if (debug) Serial.println("[MQTT] Not connected...");
+        // State changes are still queued for delivery after the reconnect
+        _publishPendingStatus();
         // Connection lost, attempt reconnection
         unsigned long currentTime = millis();
         if (currentTime - _lastConnectionAttempt >= 10000) { // Retry every 10 seconds
@@ -164,28 +199,42 @@ bool MQTTManager::connect() {
     Serial.print(":");
     Serial.println(_port);
     
-    // Attempt MQTT connection
-    bool connected = _mqttClient->connect(_clientId);
+    // Attempt MQTT connection, registering the Last Will if configured
+    bool connected;
+    if (_availabilityTopic[0]) {
+        connected = _mqttClient->connect(_clientId, _availabilityTopic, 1,
+                                         _availabilityRetain, _offlinePayload);
+    } else {
+        connected = _mqttClient->connect(_clientId);
+    }
     
     if (connected) {
         Serial.println("[MQTT] Connected to broker successfully");
         _reconnectAttempts = 0;
         
-        // Subscribe to command topic
-        if (_mqttClient->subscribe(_commandTopic)) {
-            Serial.print("[MQTT] Subscribed to command topic: ");
-            Serial.println(_commandTopic);
-        } else {
-            Serial.print("[ERROR] Failed to subscribe to command topic: ");
-            Serial.println(_commandTopic);
+        // Subscribe to the command topic, plus one level per gate on
+        // multi-gate boards (the bare topic then addresses gate 0)
+        _subscribe(_commandTopic);
+        if (Gate::GATE_COUNT > 1) {
+            char subscription[TOPIC_SIZE];
+            snprintf(subscription, sizeof(subscription), "%s/+", _commandTopic);
+            _subscribe(subscription);
+        }
+        
+        // Birth message; overwrites the retained Last Will of a previous drop
+        if (_availabilityTopic[0]) {
+            _outbox.enqueue(_availabilityTopic, (const uint8_t*)_onlinePayload,
+                            strlen(_onlinePayload), 1, _availabilityRetain);
         }
         
-        // Set up periodic status publishing if enabled
+        // Publish current status right away; later publishes are event-driven
         if (_autoPublishEnabled) {
-            _publishTimer.every(10000, [](void* manager) -> bool {
-                return static_cast<MQTTManager*>(manager)->_publishTimerCallback(nullptr);
-            }, this);
-            Serial.println("[MQTT] Automatic status publishing enabled (10-second interval)");
+            // Existing gates only: a bit that no publish clears keeps
+            // msUntilNextPublish() at 0
+            _changedGates = (GateMask)(((uint64_t)1 << Gate::GATE_COUNT) - 1);
+            Serial.print("[MQTT] Automatic status publishing enabled (on change, ");
+            Serial.print(_heartbeatInterval / 1000);
+            Serial.println("-second heartbeat)");
         }
         
         _logConnectionStatus();
@@ -196,44 +245,46 @@ bool MQTTManager::connect() {
         Serial.print(_mqttClient->state());
         Serial.print(", attempt #");
         Serial.println(_reconnectAttempts);
-        
-        // Set up reconnection timer if not already running
-        if (_reconnectAttempts == 1) {
-            _reconnectTimer.every(30000, [](void* manager) -> bool {
-                return static_cast<MQTTManager*>(manager)->_reconnectTimerCallback(nullptr);
-            }, this);
-        }
+        // update() retries every 10 seconds while disconnected
     }
     
     return connected;
 }
 
-bool MQTTManager::publishStatus(const String& status) {
-    Serial.println("[MQTT] publish status...");
-    if (!_initialized || !_mqttClient || !_mqttClient->connected()) {
-        Serial.println("[ERROR] MQTT not connected, cannot publish status");
+bool MQTTManager::publishStatus() {
+    LOG_DEBUG("[MQTT] publish status...");
+    if (!_initialized || !_mqttClient) {
+        LOG_ERROR("[ERROR] MQTT manager not initialized, cannot publish status");
         return false;
     }
     
-    // Create status message
-    String message;
-    if (_gateController) {
-        message = _formatStatusMessage(_gateController->getState());
-    } else {
-        message = status; // Use provided status if no gate controller
+    bool success = true;
+    for (uint8_t gate = 0; gate < Gate::GATE_COUNT; gate++) {
+        success = _publishGate(gate) && success;
     }
-    
-    // Publish message
-    bool success = _mqttClient->publish(_statusTopic, message.c_str());
-    
-    if (success) {
-        _lastPublish = millis();
-    }
-    
-    _logPublishEvent(message, success);
     return success;
 }
 
+void MQTTManager::updateInputs(bool gateLights, bool gateLock, bool externalRelay, bool photoEye) {
+    _status.gateLights = gateLights;
+    _status.gateLock = gateLock;
+    _status.externalRelay = externalRelay;
+    _status.photoEye = photoEye;
+}
+
+void MQTTManager::updateClimate(float temperature, float humidity, bool valid) {
+    _status.climateValid = valid;
+    if (valid) {
+        _status.temperature = temperature;
+        _status.humidity = humidity;
+    }
+}
+
+void MQTTManager::updateTraffic(uint32_t passes, uint32_t lastPassMs) {
+    _status.passes = passes;
+    _status.lastPassMs = lastPassMs;
+}
+
 bool MQTTManager::isConnected() {
     return _initialized && _mqttClient && _mqttClient->connected();
 }
@@ -243,9 +294,9 @@ void MQTTManager::setClient(NetworkClient* client) {
     // Serial.println("[MQTT] Client set");
 }
 
-void MQTTManager::setGateController(Gate* gate) {
-    _gateController = gate;
-    Serial.println("[MQTT] Gate controller reference set");
+void MQTTManager::setControlTask(ControlTask* controlTask) {
+    _controlTask = controlTask;
+    Serial.println("[MQTT] Control task reference set");
 }
 
 void MQTTManager::setAutoPublish(bool enabled) {
@@ -254,6 +305,60 @@ void MQTTManager::setAutoPublish(bool enabled) {
     Serial.println(enabled ? "enabled" : "disabled");
 }
 
+void MQTTManager::setHeartbeatInterval(unsigned long interval) {
+    _heartbeatInterval = interval;
+}
+
+void MQTTManager::setPublishHoldoff(unsigned long holdoff) {
+    _publishHoldoff = holdoff;
+}
+
+void MQTTManager::setStatusFormat(StatusFormat format) {
+    _statusFormat = format;
+    Serial.print("[MQTT] Status format: ");
+    Serial.println(statusFormatName(format));
+}
+
+void MQTTManager::setStatusQos(uint8_t qos) {
+    _statusQos = qos ? 1 : 0;
+    Serial.print("[MQTT] Status QoS: ");
+    Serial.println(_statusQos);
+}
+
+void MQTTManager::setStatusRetain(bool retain) {
+    _statusRetain = retain;
+    Serial.print("[MQTT] Status retain: ");
+    Serial.println(retain ? "on" : "off");
+}
+
+void MQTTManager::setAvailability(const char* topic, const char* online, const char* offline,
+                                  bool retain) {
+    strncpy(_availabilityTopic, topic, sizeof(_availabilityTopic) - 1);
+    _availabilityTopic[sizeof(_availabilityTopic) - 1] = '\0';
+    strncpy(_onlinePayload, online, sizeof(_onlinePayload) - 1);
+    _onlinePayload[sizeof(_onlinePayload) - 1] = '\0';
+    strncpy(_offlinePayload, offline, sizeof(_offlinePayload) - 1);
+    _offlinePayload[sizeof(_offlinePayload) - 1] = '\0';
+    _availabilityRetain = retain;
+    
+    if (_availabilityTopic[0]) {
+        Serial.print("[MQTT] Availability topic: ");
+        Serial.println(_availabilityTopic);
+    }
+}
+
+void MQTTManager::updateGateState(const GateSnapshot& snapshot) {
+    if (snapshot.gate >= Gate::GATE_COUNT) {
+        return;
+    }
+    GateMask bit = (GateMask)1 << snapshot.gate;
+    if (snapshot.state != _gateStates[snapshot.gate] || snapshot.sensorState != (bool)(_sensorRaw & bit)) {
+        _changedGates |= bit;
+    }
+    _gateStates[snapshot.gate] = snapshot.state;
+    _sensorRaw = snapshot.sensorState ? (_sensorRaw | bit) : (_sensorRaw & ~bit);
+}
+
 // ============================================================================
 // PRIVATE METHODS
 // ============================================================================
@@ -310,21 +415,35 @@ void MQTTManager::setAutoPublish(bool enabled) {
 // }
 
 void MQTTManager::_onMessageReceived(char* topic, byte* payload, unsigned int length) {
-    // Convert payload to string
-    String command;
-    command.reserve(length + 1);
-    for (unsigned int i = 0; i < length; i++) {
-        command += (char)payload[i];
+    // The payload is parsed in place in PubSubClient's buffer (not NUL-terminated)
+    // The topic lives in PubSubClient's buffer too: log its length only
+    LOG_DEBUG("[MQTT] Message received (%u byte topic, %u byte payload)",
+              strlen(topic), length);
+    
+    // Handle command if it's on the command topic (or a gate's level below it)
+    size_t baseLength = strlen(_commandTopic);
+    if (strncmp(topic, _commandTopic, baseLength) != 0) {
+        return;
     }
-    
-    Serial.print("[MQTT] Message received on topic: ");
-    Serial.println(topic);
-    Serial.print("[MQTT] Payload: ");
-    Serial.println(command);
-    
-    // Handle command if it's on the command topic
-    if (strcmp(topic, _commandTopic) == 0) {
-        _handleCommand(command);
+    const char* suffix = topic + baseLength;
+    uint8_t gate = 0;
+    if (suffix[0] == '\0') {
+        _handleCommand((const char*)payload, length, gate);
+    } else if (Gate::GATE_COUNT > 1 && suffix[0] == '/' &&
+               parseGateIndex(suffix + 1, strlen(suffix + 1), gate)) {
+        _handleCommand((const char*)payload, length, gate);
+    } else {
+        LOG_ERROR("[ERROR] Command topic names no valid gate");
+    }
+}
+
+void MQTTManager::_subscribe(const char* topic) {
+    if (_mqttClient->subscribe(topic)) {
+        Serial.print("[MQTT] Subscribed to command topic: ");
+        Serial.println(topic);
+    } else {
+        Serial.print("[ERROR] Failed to subscribe to command topic: ");
+        Serial.println(topic);
     }
 }
 
@@ -334,66 +453,120 @@ void MQTTManager::_messageCallback(char* topic, byte* payload, unsigned int leng
     }
 }
 
-bool MQTTManager::_publishTimerCallback(void* argument) {
-    // Publish current gate status
-    if (_gateController && isConnected()) {
-        publishStatus(_gateController->getStateString());
+uint32_t MQTTManager::msUntilNextPublish() const {
+    if (!_mqttClient || !_mqttClient->connected()) {
+        return SCHEDULE_IDLE;
+    }
+    
+    // Queued messages and retransmissions
+    uint32_t wait = _outbox.msUntilNextTransmit();
+    if (!_autoPublishEnabled || !_controlTask) {
+        return wait;
     }
-    return true; // Continue periodic publishing
+    
+    unsigned long elapsed = millis() - _lastPublish;
+    unsigned long due = _changedGates && _publishHoldoff < _heartbeatInterval
+                            ? _publishHoldoff : _heartbeatInterval;
+    uint32_t publishWait = elapsed >= due ? 0 : (uint32_t)(due - elapsed);
+    return publishWait < wait ? publishWait : wait;
 }
 
-bool MQTTManager::_reconnectTimerCallback(void* argument) {
-    // Attempt reconnection
-    if (!isConnected()) {
-        connect();
+void MQTTManager::_publishPendingStatus() {
+    if (!_autoPublishEnabled || !_controlTask) {
+        return;
     }
     
-    // Stop timer if connected, continue if still disconnected
-    return !isConnected();
+    unsigned long elapsed = millis() - _lastPublish;
+    
+    // Event-driven publish: every change since the last publish goes out as
+    // one message per changed gate carrying its latest state
+    bool changePending = _changedGates && elapsed >= _publishHoldoff;
+    
+    // Heartbeat fallback when nothing changed for a while: every gate
+    // (only while connected; offline, only changes are worth queueing)
+    bool heartbeatDue = elapsed >= _heartbeatInterval && isConnected();
+    
+    if (!changePending && !heartbeatDue) {
+        return;
+    }
+    for (uint8_t gate = 0; gate < Gate::GATE_COUNT; gate++) {
+        GateMask bit = (GateMask)1 << gate;
+        if ((heartbeatDue || (_changedGates & bit)) && _publishGate(gate)) {
+            _changedGates &= ~bit;
+        }
+    }
 }
 
-void MQTTManager::_handleCommand(const String& command) {
-    _logCommandReceived(command);
+bool MQTTManager::_publishGate(uint8_t gate) {
+    _status.state = _gateStates[gate];
+    _status.sensorRaw = _sensorRaw & ((GateMask)1 << gate);
     
-    if (!_gateController) {
-        Serial.println("[ERROR] No gate controller available for command handling");
-        return;
+    // Create status message
+    size_t length = _formatStatusMessage();
+    if (length == 0) {
+        LOG_ERROR("[ERROR] Status message does not fit in buffer");
+        return false;
     }
     
-    // Parse and execute command (Requirements 7.4, 4.2)
-    String upperCommand = command;
-    upperCommand.toUpperCase();
-    upperCommand.trim();
-    
-    if (upperCommand == "OPEN") {
-        Serial.println("[MQTT] Executing OPEN command");
-        _gateController->openGate();
-    } else if (upperCommand == "CLOSE") {
-        Serial.println("[MQTT] Executing CLOSE command");
-        _gateController->closeGate();
-    } else if (upperCommand == "STOP") {
-        Serial.println("[MQTT] Executing STOP command");
-        _gateController->stopGate();
-    } else if (upperCommand == "TOGGLE") {
-        Serial.println("[MQTT] Executing TOGGLE command");
-        _gateController->toggle();
+    // Queue message; the outbox copies it and sends it on the next transmit()
+    char topic[TOPIC_SIZE];
+    _gateTopic(_statusTopic, gate, topic);
+    bool success = _outbox.enqueue(topic, (const uint8_t*)_statusMessage, length, _statusQos, _statusRetain);
+    
+    if (success) {
+        _lastPublish = millis();
+    }
+    
+    _logPublishEvent(length, success);
+    return success;
+}
+
+void MQTTManager::_gateTopic(const char* base, uint8_t gate, char* topic) const {
+    if (Gate::GATE_COUNT > 1) {
+        snprintf(topic, TOPIC_SIZE, "%s/%u", base, (unsigned)gate);
     } else {
-        Serial.print("[ERROR] Unknown MQTT command: ");
-        Serial.println(command);
+        snprintf(topic, TOPIC_SIZE, "%s", base);
+    }
+}
+
+void MQTTManager::_handleCommand(const char* command, size_t length, uint8_t gate) {
+    _logCommandReceived(length);
+    
+    if (!_controlTask) {
+        LOG_ERROR("[ERROR] No control task available for command handling");
+        return;
+    }
+    
+    // Parse and queue command (Requirements 7.4, 4.2); executed by the
+    // control task on its next iteration
+    GateCommand gateCommand;
+    switch (dispatchGateCommand(_controlTask, command, length, COMMAND_SOURCE_MQTT, gate, gateCommand)) {
+        case COMMAND_QUEUED:
+            LOG_INFO("[MQTT] Queued %s command for gate %u", gateCommandName(gateCommand), gate);
+            break;
+        case COMMAND_UNKNOWN:
+            LOG_ERROR("[ERROR] Unknown MQTT command (%u bytes)", length);
+            break;
+        case COMMAND_QUEUE_FULL:
+            LOG_ERROR("[ERROR] Command queue full, MQTT command dropped");
+            break;
+        case COMMAND_UNKNOWN_GATE:
+            LOG_ERROR("[ERROR] Unknown gate, MQTT command dropped");
+            break;
     }
 }
 
-String MQTTManager::_formatStatusMessage(GateState state) {
+size_t MQTTManager::_formatStatusMessage() {
     // Create JSON-formatted status message as per design document
-    String message = "{";
-    message += "\"device_id\":\"" + String(_clientId) + "\",";
-    message += "\"timestamp\":" + String(millis() / 1000) + ",";
-    message += "\"state\":\"" + String(_gateController ? _gateController->getStateString() : "UNKNOWN") + "\",";
-    message += "\"sensor_raw\":" + String(_gateController ? "true" : "false") + ",";
-    message += "\"uptime\":" + String(millis() / 1000);
-    message += "}";
-    
-    return message;
+    uint32_t seconds = millis() / 1000;
+    _status.timestamp = seconds;
+    _status.uptime = seconds;
+    
+    static_assert(STATUS_CBOR_MAX_SIZE <= sizeof(_statusMessage), "Status buffer too small for CBOR");
+    if (_statusFormat == STATUS_FORMAT_CBOR) {
+        return serializeStatusCbor(_status, (uint8_t*)_statusMessage, sizeof(_statusMessage));
+    }
+    return serializeStatusJson(_status, _statusMessage, sizeof(_statusMessage));
 }
 
 void MQTTManager::_logConnectionStatus() {
@@ -408,17 +581,18 @@ void MQTTManager::_logConnectionStatus() {
     Serial.println(_port);
 }
 
-void MQTTManager::_logPublishEvent(const String& message, bool success) {
+void MQTTManager::_logPublishEvent(size_t length, bool success) {
+    // The payload is rewritten by the next publish: log what describes it
     if (success) {
-        Serial.print("[MQTT] Status published: ");
-        Serial.println(message);
+        LOG_INFO("[MQTT] Status queued: %s, %u bytes %s", gateStateName(_status.state),
+                 length, statusFormatName(_statusFormat));
     } else {
-        Serial.print("[ERROR] Failed to publish status: ");
-        Serial.println(message);
+        LOG_ERROR("[ERROR] Failed to queue status: %s, %u bytes %s", gateStateName(_status.state),
+                  length, statusFormatName(_statusFormat));
     }
 }
 
-void MQTTManager::_logCommandReceived(const String& command) {
-    Serial.print("[MQTT] Command received: ");
-    Serial.println(command);
+void MQTTManager::_logCommandReceived(size_t length) {
+    // The payload is parsed in place and not kept: log its size only
+    LOG_INFO("[MQTT] Command received: %u bytes", length);
 }
\ No newline at end of file
@@ -3,6 +3,21 @@
  * 
  * Defines the MQTTManager class interface for MQTT communication
  * over Ethernet using W5500 shield for remote gate control and status reporting.
+ *
+ * With a single gate the status and command topics are used as configured.
+ * When the board drives several gates, every gate gets its own pair:
+ * <status topic>/<index> and <command topic>/<index>. The bare command
+ * topic still addresses gate 0.
+ *
+ * Status is published retained, and an optional availability topic carries
+ * a birth message on every connect and the Last Will the broker publishes
+ * when the device drops off, so a new subscriber gets state and liveness
+ * at once.
+ *
+ * Status messages go through an MqttOutbox: they are queued even while the
+ * broker is unreachable, sent at the configured QoS (1 by default, retried
+ * until the broker acknowledges them) and batched into one write per
+ * update().
  */
 
 #ifndef MQTTManager_h
@@ -11,8 +26,11 @@
 #include "Arduino.h"
 #include <Network.h>
 #include <PubSubClient.h>
-#include <arduino-timer.h>
 #include "gate.h"  // Include gate.h for GateState enum
+#include "controltask.h"
+#include "commandparser.h"
+#include "statusserializer.h"
+#include "mqttoutbox.h"
 
 #define WOKWI_SIMULATION 1
 
@@ -60,11 +78,32 @@ public:
     bool connect();
     
     /**
-     * Publish gate status to MQTT broker
-     * @param status Gate status string to publish
-     * @return true if publish successful
+     * Queue the status of every gate for the MQTT broker
+     * Serializes into a fixed buffer; does not allocate. Sent on the next
+     * update() while connected, or after the reconnect.
+     * @return true if every message was queued
      */
-    bool publishStatus(const String& status);
+    bool publishStatus();
+    
+    /**
+     * Update discrete input levels reported in the status message
+     */
+    void updateInputs(bool gateLights, bool gateLock, bool externalRelay, bool photoEye);
+    
+    /**
+     * Update DHT22 reading reported in the status message
+     * @param temperature Temperature in degrees Celsius
+     * @param humidity Relative humidity in percent
+     * @param valid false if the last reading failed
+     */
+    void updateClimate(float temperature, float humidity, bool valid);
+    
+    /**
+     * Update photo-eye traffic reported in the status message
+     * @param passes Beam interruptions since boot
+     * @param lastPassMs Duration of the latest timed pass
+     */
+    void updateTraffic(uint32_t passes, uint32_t lastPassMs);
     
     void setClient(NetworkClient* client);
 
@@ -75,55 +114,137 @@ public:
     bool isConnected();
     
     /**
-     * Set gate controller reference for command handling
-     * @param gate Pointer to gate controller instance
+     * Set control task used for command handling
+     * Commands are queued to the control task, never executed here.
+     * @param controlTask Pointer to the gate control task
      */
-    void setGateController(Gate* gate);
+    void setControlTask(ControlTask* controlTask);
     
     /**
      * Enable/disable automatic status publishing
-     * @param enabled true to enable periodic publishing
+     * @param enabled true to enable event-driven and heartbeat publishing
      */
     void setAutoPublish(bool enabled);
+    
+    /**
+     * Set the heartbeat interval
+     * Status is republished when nothing was published for this long.
+     * @param interval Interval in milliseconds
+     */
+    void setHeartbeatInterval(unsigned long interval);
+    
+    /**
+     * Set the minimum spacing between event-driven publishes
+     * Transitions arriving within the hold-off are coalesced into one publish.
+     * @param holdoff Hold-off in milliseconds (0 = coalesce per update only)
+     */
+    void setPublishHoldoff(unsigned long holdoff);
+    
+    /**
+     * Select the status payload encoding
+     * @param format STATUS_FORMAT_JSON (default) or STATUS_FORMAT_CBOR
+     */
+    void setStatusFormat(StatusFormat format);
+    
+    /**
+     * Set the QoS of status messages
+     * @param qos 0 (sent once) or 1 (retried until acknowledged, default)
+     */
+    void setStatusQos(uint8_t qos);
+    
+    /**
+     * Set the retain flag of status messages
+     * @param retain true (default) to have the broker keep the latest status
+     */
+    void setStatusRetain(bool retain);
+    
+    /**
+     * Set the availability topic; takes effect on the next connect()
+     * @param topic Topic for the birth message and Last Will ("" disables both)
+     * @param online Birth message, published (QoS 1) after every connect
+     * @param offline Last Will, published by the broker if the connection drops
+     * @param retain Retain flag of both messages
+     */
+    void setAvailability(const char* topic, const char* online, const char* offline, bool retain);
+    
+    /**
+     * Apply a gate state snapshot from the control task
+     * The gate's status is published on the next update() if it changed.
+     * @param snapshot Snapshot taken from ControlTask::pollState()
+     */
+    void updateGateState(const GateSnapshot& snapshot);
+    
+    /**
+     * Time until update() next has a status publish to make
+     * Lets the network task sleep through the hold-off and heartbeat.
+     * @return Milliseconds until the next publish, SCHEDULE_IDLE if none
+     */
+    uint32_t msUntilNextPublish() const;
+    
+    /**
+     * Delivery counters and latency of the status outbox
+     */
+    OutboxStats outboxStats() const { return _outbox.stats(); }
 
 private:
+    // PubSubClient packet buffer: status document plus topic and header
+    static const uint16_t PACKET_BUFFER_SIZE = 512;
+    
+    // Configured topic plus "/<index>" (or "/+" for the subscription)
+    static const size_t TOPIC_SIZE = MqttOutbox::TOPIC_SIZE;
+    
     // MQTT configuration
     char _broker[64];           // MQTT broker hostname
     int _port;                  // MQTT broker port
     char _clientId[32];         // Unique client ID
     char _statusTopic[64];      // Status publishing topic
     char _commandTopic[64];     // Command subscription topic
+    char _availabilityTopic[64];    // Birth and Last Will topic ("" = none)
+    char _onlinePayload[16];        // Birth message
+    char _offlinePayload[16];       // Last Will message
+    bool _availabilityRetain;       // Retain flag of birth and Last Will
     
     // Network and MQTT clients
     NetworkClient* _ethClient;    // WiFi client for network connection
     PubSubClient* _mqttClient;  // MQTT client for broker communication
-    
-    // Timer management
-    Timer<> _publishTimer;      // Timer for periodic status publishing
-    Timer<> _reconnectTimer;    // Timer for connection retry attempts
+    MqttOutbox _outbox;         // Status messages awaiting delivery; PubSubClient's socket
     
     // State tracking
     bool _initialized;          // Flag indicating initialization complete
     bool _wifiConnected;        // Flag indicating WiFi connection status
     bool _autoPublishEnabled;   // Flag for automatic status publishing
+    GateMask _changedGates;     // Gates with an unpublished status change
     unsigned long _lastPublish; // Timestamp of last status publish
+    unsigned long _heartbeatInterval;   // Republish interval without changes
+    unsigned long _publishHoldoff;      // Minimum spacing of event publishes
+    StatusFormat _statusFormat;         // Status payload encoding
+    uint8_t _statusQos;                 // Status message QoS (0 or 1)
+    bool _statusRetain;                 // Status message retain flag
     unsigned long _lastConnectionAttempt; // Timestamp of last connection attempt
     int _reconnectAttempts;     // Number of consecutive reconnection attempts
     
-    // Gate controller reference
-    Gate* _gateController;      // Pointer to gate controller for command handling
+    // Control task reference
+    ControlTask* _controlTask;  // Command queue owner for command handling
+    
+    // Status publishing
+    GateStatus _status;                         // Shared fields, filled per gate on publish
+    GateState _gateStates[Gate::GATE_COUNT];    // Latest state of each gate
+    GateMask _sensorRaw;                        // Latest sensor level of each gate
+    char _statusMessage[STATUS_JSON_MAX_SIZE];  // Serialized status message (JSON or CBOR)
     
     // Private methods
     // bool _initializeWiFi();
     void _onMessageReceived(char* topic, byte* payload, unsigned int length);
     static void _messageCallback(char* topic, byte* payload, unsigned int length);
-    bool _publishTimerCallback(void* argument);
-    bool _reconnectTimerCallback(void* argument);
-    void _handleCommand(const String& command);
-    String _formatStatusMessage(GateState state);
+    void _subscribe(const char* topic);
+    void _publishPendingStatus();
+    bool _publishGate(uint8_t gate);
+    void _gateTopic(const char* base, uint8_t gate, char* topic) const;
+    void _handleCommand(const char* command, size_t length, uint8_t gate);
+    size_t _formatStatusMessage();
     void _logConnectionStatus();
-    void _logPublishEvent(const String& message, bool success);
-    void _logCommandReceived(const String& command);
+    void _logPublishEvent(size_t length, bool success);
+    void _logCommandReceived(size_t length);
     
     // Static instance pointer for callback handling
     static MQTTManager* _instance;
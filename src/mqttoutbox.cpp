@@ -0,0 +1,399 @@
+/**
+ * MqttOutbox.cpp - ESP32 Swing Gate Controller outbound MQTT queue
+ *
+ * Implementation of the PUBLISH encoder, the batched sends and the PUBACK
+ * scanner.
+ */
+
+#include "mqttoutbox.h"
+
+namespace {
+
+// MQTT control packet types (upper nibble of the fixed header)
+const uint8_t PACKET_PUBLISH = 0x30;
+const uint8_t PACKET_PUBACK = 0x40;
+
+// PUBLISH fixed header flags
+const uint8_t FLAG_DUP = 0x08;
+const uint8_t FLAG_RETAIN = 0x01;
+
+size_t remainingLengthBytes(size_t length) {
+    return length < 128 ? 1 : length < 16384 ? 2 : 3;
+}
+
+} // namespace
+
+static_assert(MqttOutbox::WRITE_BUFFER_SIZE >=
+                  1 + 3 + 2 + MqttOutbox::TOPIC_SIZE + 2 + MqttOutbox::PAYLOAD_SIZE,
+              "Write buffer must hold the largest PUBLISH packet");
+
+// ============================================================================
+// MQTT OUTBOX CLASS IMPLEMENTATION
+// ============================================================================
+
+MqttOutbox::MqttOutbox()
+    : _client(nullptr),
+      _count(0),
+      _nextPacketId(1),
+      _queued(0),
+      _delivered(0),
+      _retransmits(0),
+      _dropped(0),
+      _expired(0),
+      _writes(0),
+      _packets(0),
+      _acked(0),
+      _totalLatencyMs(0),
+      _lastLatencyMs(0),
+      _maxLatencyMs(0) {
+    for (uint8_t i = 0; i < CAPACITY; i++) {
+        _order[i] = i;
+    }
+    _resetScanner();
+}
+
+void MqttOutbox::setClient(Client* client) {
+    _client = client;
+}
+
+bool MqttOutbox::enqueue(const char* topic, const uint8_t* payload, size_t length,
+                         uint8_t qos, bool retained) {
+    size_t topicLength = strlen(topic);
+    if (topicLength >= TOPIC_SIZE || length > PAYLOAD_SIZE) {
+        return false;
+    }
+
+    // Drop policy: the oldest message makes room, sent or not; its late
+    // PUBACK (if any) no longer matches a packet id and is ignored
+    if (_count == CAPACITY) {
+        _remove(0);
+        _dropped++;
+    }
+
+    // Slots past _count in _order are the free ones
+    Message& message = _messages[_order[_count]];
+    memcpy(message.topic, topic, topicLength + 1);
+    memcpy(message.payload, payload, length);
+    message.length = (uint16_t)length;
+    message.qos = qos ? 1 : 0;
+    message.retained = retained;
+    message.packetId = 0;
+    if (message.qos) {
+        message.packetId = _nextPacketId;
+        _nextPacketId = _nextPacketId == 0xFFFF ? 1 : _nextPacketId + 1;
+    }
+    message.due = true;
+    message.attempts = 0;
+    message.queuedMs = millis();
+    message.sentMs = 0;
+    _count++;
+    _queued++;
+    return true;
+}
+
+uint8_t MqttOutbox::transmit() {
+    if (!_client || !_client->connected() || _count == 0) {
+        return 0;
+    }
+
+    uint32_t now = millis();
+    size_t used = 0;
+    uint8_t sent = 0;
+    uint8_t position = 0;
+    while (position < _count) {
+        Message& message = _messages[_order[position]];
+        bool resend = message.qos && !message.due && now - message.sentMs >= ACK_TIMEOUT_MS;
+        if (!message.due && !resend) {
+            position++;
+            continue;
+        }
+        if (message.qos && message.attempts >= MAX_ATTEMPTS) {
+            _remove(position);
+            _expired++;
+            continue;
+        }
+
+        // Full buffer: send it and start the next one. The QoS 0 messages it
+        // carried are done and leave the queue, all of them ahead of position.
+        size_t size = _encodedSize(message);
+        if (used + size > WRITE_BUFFER_SIZE) {
+            bool written = _write(used);
+            position -= _settleWritten(written);
+            if (!written) {
+                return sent;
+            }
+            used = 0;
+        }
+        used += _encode(message, _writeBuffer + used);
+        if (message.attempts > 0) {
+            _retransmits++;
+        }
+        message.attempts++;
+        message.sentMs = now;
+        message.due = false;
+        sent++;
+        _packets++;
+        position++;
+    }
+
+    if (used > 0) {
+        _settleWritten(_write(used));
+    }
+    return sent;
+}
+
+uint32_t MqttOutbox::msUntilNextTransmit() const {
+    uint32_t wait = SCHEDULE_IDLE;
+    uint32_t now = millis();
+    for (uint8_t position = 0; position < _count; position++) {
+        const Message& message = _messages[_order[position]];
+        if (message.due) {
+            return 0;
+        }
+        uint32_t elapsed = now - message.sentMs;
+        uint32_t remaining = elapsed >= ACK_TIMEOUT_MS ? 0 : ACK_TIMEOUT_MS - elapsed;
+        if (remaining < wait) {
+            wait = remaining;
+        }
+    }
+    return wait;
+}
+
+OutboxStats MqttOutbox::stats() const {
+    OutboxStats stats;
+    stats.queued = _queued;
+    stats.delivered = _delivered;
+    stats.retransmits = _retransmits;
+    stats.dropped = _dropped;
+    stats.expired = _expired;
+    stats.pending = _count;
+    stats.writes = _writes;
+    stats.packets = _packets;
+    stats.lastLatencyMs = _lastLatencyMs;
+    stats.meanLatencyMs = _acked ? (uint32_t)(_totalLatencyMs / _acked) : 0;
+    stats.maxLatencyMs = _maxLatencyMs;
+    return stats;
+}
+
+// ============================================================================
+// CLIENT INTERFACE
+// ============================================================================
+
+int MqttOutbox::connect(IPAddress ip, uint16_t port) {
+    // New connection (PubSubClient is about to send CONNECT): nothing of
+    // the old stream is left to scan, and everything in flight goes again
+    _resetScanner();
+    for (uint8_t position = 0; position < _count; position++) {
+        _messages[_order[position]].due = true;
+    }
+    return _client ? _client->connect(ip, port) : 0;
+}
+
+int MqttOutbox::connect(const char* host, uint16_t port) {
+    _resetScanner();
+    for (uint8_t position = 0; position < _count; position++) {
+        _messages[_order[position]].due = true;
+    }
+    return _client ? _client->connect(host, port) : 0;
+}
+
+// Client has no timeout variant to forward to: the wrapped client connects
+// with its own timeout
+int MqttOutbox::connect(IPAddress ip, uint16_t port, int32_t) {
+    return connect(ip, port);
+}
+
+int MqttOutbox::connect(const char* host, uint16_t port, int32_t) {
+    return connect(host, port);
+}
+
+size_t MqttOutbox::write(uint8_t c) {
+    return _client ? _client->write(c) : 0;
+}
+
+size_t MqttOutbox::write(const uint8_t* buffer, size_t size) {
+    return _client ? _client->write(buffer, size) : 0;
+}
+
+int MqttOutbox::available() {
+    return _client ? _client->available() : 0;
+}
+
+int MqttOutbox::read() {
+    int c = _client ? _client->read() : -1;
+    if (c >= 0) {
+        _scan((uint8_t)c);
+    }
+    return c;
+}
+
+int MqttOutbox::read(uint8_t* buffer, size_t size) {
+    int count = _client ? _client->read(buffer, size) : 0;
+    for (int i = 0; i < count; i++) {
+        _scan(buffer[i]);
+    }
+    return count;
+}
+
+int MqttOutbox::peek() {
+    return _client ? _client->peek() : -1;
+}
+
+void MqttOutbox::flush() {
+    if (_client) {
+        _client->flush();
+    }
+}
+
+void MqttOutbox::stop() {
+    if (_client) {
+        _client->stop();
+    }
+}
+
+uint8_t MqttOutbox::connected() {
+    return _client ? _client->connected() : 0;
+}
+
+MqttOutbox::operator bool() {
+    return _client && (bool)*_client;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+uint8_t MqttOutbox::_settleWritten(bool written) {
+    // QoS 0 messages sent but still queued are the ones in the write just made
+    uint8_t removed = 0;
+    uint8_t position = 0;
+    while (position < _count) {
+        Message& message = _messages[_order[position]];
+        if (message.qos || message.due) {
+            position++;
+        } else if (written) {
+            _remove(position);
+            _delivered++;
+            removed++;
+        } else {
+            // Never reached the broker: send again, as new, after the reconnect
+            message.due = true;
+            message.attempts = 0;
+            position++;
+        }
+    }
+    return removed;
+}
+
+void MqttOutbox::_remove(uint8_t position) {
+    // Keep the order, move the freed slot behind the used ones
+    uint8_t slot = _order[position];
+    for (uint8_t i = position; i + 1 < _count; i++) {
+        _order[i] = _order[i + 1];
+    }
+    _count--;
+    _order[_count] = slot;
+}
+
+size_t MqttOutbox::_encodedSize(const Message& message) {
+    size_t remaining = 2 + strlen(message.topic) + (message.qos ? 2 : 0) + message.length;
+    return 1 + remainingLengthBytes(remaining) + remaining;
+}
+
+size_t MqttOutbox::_encode(const Message& message, uint8_t* out) const {
+    size_t topicLength = strlen(message.topic);
+    size_t remaining = 2 + topicLength + (message.qos ? 2 : 0) + message.length;
+    size_t n = 0;
+
+    out[n++] = PACKET_PUBLISH | (message.attempts > 0 ? FLAG_DUP : 0) |
+               (message.qos << 1) | (message.retained ? FLAG_RETAIN : 0);
+    do {
+        uint8_t digit = remaining % 128;
+        remaining /= 128;
+        out[n++] = remaining > 0 ? digit | 0x80 : digit;
+    } while (remaining > 0);
+
+    out[n++] = topicLength >> 8;
+    out[n++] = topicLength & 0xFF;
+    memcpy(out + n, message.topic, topicLength);
+    n += topicLength;
+    if (message.qos) {
+        out[n++] = message.packetId >> 8;
+        out[n++] = message.packetId & 0xFF;
+    }
+    memcpy(out + n, message.payload, message.length);
+    return n + message.length;
+}
+
+bool MqttOutbox::_write(size_t length) {
+    _writes++;
+    size_t written = _client->write(_writeBuffer, length);
+    if (written == length) {
+        return true;
+    }
+
+    // A short write leaves a broken packet on the stream: the connection is
+    // no good. Drop it; QoS 1 messages are due again after the reconnect.
+    _client->stop();
+    return false;
+}
+
+void MqttOutbox::_scan(uint8_t byte) {
+    switch (_scanState) {
+        case SCAN_HEADER:
+            _scanType = byte & 0xF0;
+            _scanRemaining = 0;
+            _scanShift = 0;
+            _scanState = SCAN_LENGTH;
+            break;
+
+        case SCAN_LENGTH:
+            _scanRemaining |= (uint32_t)(byte & 0x7F) << _scanShift;
+            _scanShift += 7;
+            if (!(byte & 0x80)) {
+                _scanIndex = 0;
+                _scanPacketId = 0;
+                _scanState = _scanRemaining ? SCAN_BODY : SCAN_HEADER;
+            } else if (_scanShift > 21) {
+                _resetScanner();    // Malformed length; PubSubClient drops the connection too
+            }
+            break;
+
+        case SCAN_BODY:
+            if (_scanIndex < 2) {
+                _scanPacketId = (_scanPacketId << 8) | byte;
+            }
+            if (++_scanIndex == _scanRemaining) {
+                if (_scanType == PACKET_PUBACK && _scanRemaining == 2) {
+                    _acknowledge(_scanPacketId);
+                }
+                _scanState = SCAN_HEADER;
+            }
+            break;
+    }
+}
+
+void MqttOutbox::_acknowledge(uint16_t packetId) {
+    for (uint8_t position = 0; position < _count; position++) {
+        Message& message = _messages[_order[position]];
+        if (message.qos && message.attempts > 0 && message.packetId == packetId) {
+            uint32_t latency = millis() - message.queuedMs;
+            _lastLatencyMs = latency;
+            _totalLatencyMs += latency;
+            if (latency > _maxLatencyMs) _maxLatencyMs = latency;
+            _acked++;
+            _delivered++;
+            _remove(position);
+            return;
+        }
+    }
+}
+
+void MqttOutbox::_resetScanner() {
+    _scanState = SCAN_HEADER;
+    _scanType = 0;
+    _scanRemaining = 0;
+    _scanShift = 0;
+    _scanIndex = 0;
+    _scanPacketId = 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * MqttOutbox.h - ESP32 Swing Gate Controller outbound MQTT queue
+ *
+ * Fixed-capacity queue of outgoing PUBLISH packets with QoS 1 delivery.
+ * PubSubClient only publishes at QoS 0 and ignores PUBACKs, so the outbox
+ * sits between it and the socket: PubSubClient is given the outbox as its
+ * Client, its own packets pass straight through, and the bytes it reads
+ * are scanned for PUBACKs on the way.
+ *
+ * Messages are queued whether or not the broker is reachable. transmit()
+ * encodes every packet that is due (new, unacknowledged past
+ * ACK_TIMEOUT_MS, or in flight when the connection dropped) into one
+ * buffer and hands it to the socket in a single write. A QoS 1 message
+ * leaves the queue on its PUBACK or after MAX_ATTEMPTS sends, a QoS 0
+ * message once the write carrying it succeeds (a failed write leaves it
+ * due for the next connection); a full queue drops its oldest message for
+ * the new one.
+ *
+ * Single task only (the network task); nothing here allocates.
+ */
+
+#ifndef MqttOutbox_h
+#define MqttOutbox_h
+
+#include "Arduino.h"
+#include <Client.h>
+#include "scheduler.h"
+#include "statusserializer.h"
+
+// ============================================================================
+// OUTBOX STATISTICS
+// ============================================================================
+struct OutboxStats {
+    uint32_t queued;            // Messages accepted
+    uint32_t delivered;         // Acknowledged (QoS 1) or written to the socket (QoS 0)
+    uint32_t retransmits;       // Sends after the first (DUP set)
+    uint32_t dropped;           // Oldest message dropped from a full queue
+    uint32_t expired;           // No PUBACK after MAX_ATTEMPTS sends
+    uint32_t pending;           // Messages in the queue now
+    uint32_t writes;            // Socket writes made by transmit()
+    uint32_t packets;           // Packets carried by those writes
+    uint32_t lastLatencyMs;     // Queued to PUBACK, latest QoS 1 delivery
+    uint32_t meanLatencyMs;
+    uint32_t maxLatencyMs;
+};
+
+// ============================================================================
+// MQTT OUTBOX CLASS DECLARATION
+// ============================================================================
+class MqttOutbox : public Client {
+public:
+    static const uint8_t CAPACITY = 8;
+    static const size_t TOPIC_SIZE = 68;                    // Topic plus "/<gate>"
+    static const size_t PAYLOAD_SIZE = STATUS_JSON_MAX_SIZE;
+    static const size_t WRITE_BUFFER_SIZE = 1460;           // One Ethernet TCP segment
+    static const uint32_t ACK_TIMEOUT_MS = 5000;
+    static const uint8_t MAX_ATTEMPTS = 5;
+
+    MqttOutbox();
+
+    /**
+     * Set the socket to the broker (may change between Ethernet and WiFi)
+     */
+    void setClient(Client* client);
+
+    /**
+     * Queue a message; if the queue is full the oldest message is dropped
+     * @param topic Topic (shorter than TOPIC_SIZE)
+     * @param payload Payload bytes (at most PAYLOAD_SIZE)
+     * @param length Payload length
+     * @param qos 0 or 1
+     * @param retained Retain flag
+     * @return false if the message does not fit a slot
+     */
+    bool enqueue(const char* topic, const uint8_t* payload, size_t length, uint8_t qos, bool retained);
+
+    /**
+     * Send every packet that is due, batched into as few writes as fit
+     * WRITE_BUFFER_SIZE; call after PubSubClient::loop() while connected
+     * @return Packets sent
+     */
+    uint8_t transmit();
+
+    /**
+     * Time until transmit() next has a packet to send
+     * @return 0 if one is due now, SCHEDULE_IDLE if the queue is empty
+     */
+    uint32_t msUntilNextTransmit() const;
+
+    OutboxStats stats() const;
+
+    uint8_t pending() const { return _count; }
+
+    // Client interface used by PubSubClient
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    int connect(IPAddress ip, uint16_t port, int32_t timeout);     // timeout ignored (see .cpp)
+    int connect(const char* host, uint16_t port, int32_t timeout);
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override;
+
+private:
+    struct Message {
+        char topic[TOPIC_SIZE];
+        uint8_t payload[PAYLOAD_SIZE];
+        uint16_t length;
+        uint16_t packetId;      // QoS 1 only
+        uint8_t qos;
+        bool retained;
+        bool due;               // Not sent on the current connection yet
+        uint8_t attempts;       // Sends so far
+        uint32_t queuedMs;
+        uint32_t sentMs;        // Latest send
+    };
+
+    // Parser state for PUBACKs in the inbound stream
+    enum ScanState : uint8_t { SCAN_HEADER, SCAN_LENGTH, SCAN_BODY };
+
+    Client* _client;
+    Message _messages[CAPACITY];
+    uint8_t _order[CAPACITY];   // Slot indices, oldest first
+    uint8_t _count;
+    uint16_t _nextPacketId;
+    uint8_t _writeBuffer[WRITE_BUFFER_SIZE];
+
+    ScanState _scanState;
+    uint8_t _scanType;
+    uint32_t _scanRemaining;
+    uint8_t _scanShift;
+    uint32_t _scanIndex;
+    uint16_t _scanPacketId;
+
+    uint32_t _queued;
+    uint32_t _delivered;
+    uint32_t _retransmits;
+    uint32_t _dropped;
+    uint32_t _expired;
+    uint32_t _writes;
+    uint32_t _packets;
+    uint32_t _acked;
+    uint64_t _totalLatencyMs;
+    uint32_t _lastLatencyMs;
+    uint32_t _maxLatencyMs;
+
+    void _remove(uint8_t position);
+    uint8_t _settleWritten(bool written);
+    size_t _encode(const Message& message, uint8_t* out) const;
+    static size_t _encodedSize(const Message& message);
+    bool _write(size_t length);
+    void _scan(uint8_t byte);
+    void _acknowledge(uint16_t packetId);
+    void _resetScanner();
+};
+
+#endif // MqttOutbox_h
@@ -0,0 +1,180 @@
+/**
+ * PassCounter.cpp - ESP32 Swing Gate Controller photo-eye pass counter
+ *
+ * Implementation of the PCNT setup and the pass duration bookkeeping.
+ */
+
+#include "passcounter.h"
+
+// ============================================================================
+// PASS COUNTER CLASS IMPLEMENTATION
+// ============================================================================
+
+PassCounter::PassCounter(int pin, uint8_t activeLevel)
+    : _pin(pin),
+      _activeLevel(activeLevel),
+      _edges(pin),
+      _passes(0),
+      _timedPasses(0),
+      _lastDurationMs(0),
+      _longestMs(0),
+      _totalDurationMs(0),
+      _lastPassMs(0),
+      _blocked(false),
+      _timing(false),
+      _blockedSinceUs(0),
+      _lastDropped(0),
+      _hardwareCounting(false),
+      _callback(nullptr),
+      _callbackContext(nullptr)
+#if defined(ARDUINO_ARCH_ESP32)
+      , _unit(nullptr),
+      _channel(nullptr)
+#endif
+{
+}
+
+PassCounter::~PassCounter() {
+    _edges.end();
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_unit) {
+        pcnt_unit_stop(_unit);
+        pcnt_unit_disable(_unit);
+        if (_channel) pcnt_del_channel(_channel);
+        pcnt_del_unit(_unit);
+    }
+#endif
+}
+
+bool PassCounter::begin() {
+    // A beam already interrupted at boot is neither counted nor timed
+    _blocked = digitalRead(_pin) == _activeLevel;
+    _edges.begin();
+
+#if defined(ARDUINO_ARCH_ESP32)
+    _hardwareCounting = _beginPulseCounter();
+    if (!_hardwareCounting) {
+        Serial.println("[ERROR] Pulse counter unavailable - counting photo-eye passes from interrupts");
+        return false;
+    }
+    Serial.print("[PASS] Pulse counter counting photo-eye passes on pin ");
+    Serial.println(_pin);
+#endif
+    return true;
+}
+
+uint32_t PassCounter::update() {
+    uint32_t nowUs = micros();
+    uint32_t nowMs = millis();
+    uint32_t ended = 0;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // Read first: a pass drained below was counted at its start edge
+    if (_hardwareCounting) {
+        _passes = _hardwareCount();
+    }
+#endif
+
+    InputEdge edge;
+    while (_edges.pop(edge)) {
+        bool active = edge.level == _activeLevel;
+        if (active == _blocked) {
+            continue;   // Repeated level (edge shorter than the ISR latency)
+        }
+        _blocked = active;
+
+        if (active) {
+            _timing = true;
+            _blockedSinceUs = edge.timestampUs;
+            _lastPassMs = nowMs - (nowUs - edge.timestampUs) / 1000;
+            if (!_hardwareCounting) {
+                _passes++;
+            }
+        } else if (_timing) {
+            uint32_t durationMs = (edge.timestampUs - _blockedSinceUs) / 1000;
+            _timing = false;
+            _timedPasses++;
+            _lastDurationMs = durationMs;
+            _totalDurationMs += durationMs;
+            if (durationMs > _longestMs) _longestMs = durationMs;
+            ended++;
+            if (_callback) {
+                _callback(durationMs, _callbackContext);
+            }
+        }
+    }
+
+    // Edges lost to a full buffer: the drained sequence has a gap, so take
+    // the level from the pin and leave the pass in progress untimed
+    uint32_t dropped = _edges.droppedEdges();
+    if (dropped != _lastDropped) {
+        _lastDropped = dropped;
+        _blocked = digitalRead(_pin) == _activeLevel;
+        _timing = false;
+    }
+
+    return ended;
+}
+
+void PassCounter::setCallback(PassCallback callback, void* context) {
+    _callback = callback;
+    _callbackContext = context;
+}
+
+PassStats PassCounter::stats() const {
+    PassStats stats;
+    stats.passes = _passes;
+    stats.timedPasses = _timedPasses;
+    stats.lastDurationMs = _lastDurationMs;
+    stats.longestMs = _longestMs;
+    stats.meanDurationMs = _timedPasses ? (uint32_t)(_totalDurationMs / _timedPasses) : 0;
+    stats.lastPassMs = _lastPassMs;
+    stats.blocked = _blocked;
+    return stats;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool PassCounter::_beginPulseCounter() {
+    // The 16-bit counter wraps at the high limit; with accum_count the
+    // driver carries the wraps (one interrupt per 32767 passes)
+    pcnt_unit_config_t unitConfig = {};
+    unitConfig.low_limit = -1;
+    unitConfig.high_limit = INT16_MAX;
+    unitConfig.flags.accum_count = 1;
+    if (pcnt_new_unit(&unitConfig, &_unit) != ESP_OK) {
+        _unit = nullptr;
+        return false;
+    }
+
+    pcnt_glitch_filter_config_t filterConfig = {};
+    filterConfig.max_glitch_ns = GLITCH_FILTER_NS;
+
+    pcnt_chan_config_t channelConfig = {};
+    channelConfig.edge_gpio_num = _pin;
+    channelConfig.level_gpio_num = -1;
+
+    // Count the edge into the interrupted level only: one count per pass
+    pcnt_channel_edge_action_t rising = _activeLevel ? PCNT_CHANNEL_EDGE_ACTION_INCREASE
+                                                     : PCNT_CHANNEL_EDGE_ACTION_HOLD;
+    pcnt_channel_edge_action_t falling = _activeLevel ? PCNT_CHANNEL_EDGE_ACTION_HOLD
+                                                      : PCNT_CHANNEL_EDGE_ACTION_INCREASE;
+
+    return pcnt_unit_set_glitch_filter(_unit, &filterConfig) == ESP_OK &&
+           pcnt_new_channel(_unit, &channelConfig, &_channel) == ESP_OK &&
+           pcnt_channel_set_edge_action(_channel, rising, falling) == ESP_OK &&
+           pcnt_unit_add_watch_point(_unit, INT16_MAX) == ESP_OK &&
+           pcnt_unit_enable(_unit) == ESP_OK &&
+           pcnt_unit_clear_count(_unit) == ESP_OK &&
+           pcnt_unit_start(_unit) == ESP_OK;
+}
+
+uint32_t PassCounter::_hardwareCount() const {
+    int count = 0;
+    pcnt_unit_get_count(_unit, &count);
+    return (uint32_t)count;
+}
+#endif
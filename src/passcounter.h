@@ -0,0 +1,125 @@
+/**
+ * PassCounter.h - ESP32 Swing Gate Controller photo-eye pass counter
+ *
+ * Counts interruptions of the photo-eye beam (a vehicle or pedestrian
+ * passing the gate) and measures how long each one blocked the beam.
+ *
+ * On the ESP32 the count is kept by the pulse counter (PCNT) peripheral:
+ * it counts beam-interrupted edges in hardware behind its glitch filter,
+ * so a pass costs no CPU time and none is missed however busy the tasks
+ * are. The durations come from an EdgeCapture on the same pin, drained by
+ * update(); if its buffer overflows the durations of those passes are lost
+ * but the count stays exact. On the host, where there is no PCNT, the count
+ * is taken from the captured edges.
+ */
+
+#ifndef PassCounter_h
+#define PassCounter_h
+
+#include "Arduino.h"
+#include "edgecapture.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <driver/pulse_cnt.h>
+#endif
+
+/**
+ * Called from update() when the beam clears at the end of a pass
+ * @param durationMs Time the beam was interrupted
+ * @param context Opaque pointer given at registration
+ */
+typedef void (*PassCallback)(uint32_t durationMs, void* context);
+
+// ============================================================================
+// PASS STATISTICS
+// ============================================================================
+struct PassStats {
+    uint32_t passes;            // Beam interruptions since boot
+    uint32_t timedPasses;       // Passes with a measured duration
+    uint32_t lastDurationMs;    // Duration of the latest timed pass
+    uint32_t longestMs;         // Longest timed pass
+    uint32_t meanDurationMs;    // Mean of the timed passes
+    uint32_t lastPassMs;        // millis() when the latest pass began (0 = none yet)
+    bool blocked;               // Beam interrupted right now
+};
+
+// ============================================================================
+// PASS COUNTER CLASS DECLARATION
+// ============================================================================
+class PassCounter {
+public:
+    static const uint32_t GLITCH_FILTER_NS = 10000;     // PCNT ignores shorter pulses
+
+    /**
+     * Constructor
+     * @param pin Photo-eye input pin
+     * @param activeLevel Pin level while the beam is interrupted
+     */
+    PassCounter(int pin, uint8_t activeLevel);
+
+    ~PassCounter();
+
+    /**
+     * Start the pulse counter and the edge capture
+     * Must be called after the GPIO pin is configured
+     * @return false if the PCNT unit could not be set up (passes are then
+     *         counted from the captured edges)
+     */
+    bool begin();
+
+    /**
+     * Drain captured edges into the duration statistics and fold in the
+     * hardware count (network task; call a few times per second)
+     * @return Passes that ended since the last call
+     */
+    uint32_t update();
+
+    /**
+     * Register the end-of-pass callback
+     * @param callback Callback, or nullptr to remove
+     * @param context Passed to the callback
+     */
+    void setCallback(PassCallback callback, void* context);
+
+    /**
+     * Statistics as of the last update()
+     */
+    PassStats stats() const;
+
+    uint32_t passes() const { return _passes; }
+
+    /**
+     * Edges the capture buffer dropped (passes left untimed)
+     */
+    uint32_t droppedEdges() const { return _edges.droppedEdges(); }
+
+private:
+    int _pin;
+    uint8_t _activeLevel;
+    EdgeCapture _edges;             // Timestamps for the durations
+
+    uint32_t _passes;
+    uint32_t _timedPasses;
+    uint32_t _lastDurationMs;
+    uint32_t _longestMs;
+    uint64_t _totalDurationMs;
+    uint32_t _lastPassMs;
+    bool _blocked;                  // Beam interrupted as of the last drained edge
+    bool _timing;                   // The current pass began with a captured edge
+    uint32_t _blockedSinceUs;       // Edge timestamp the current pass began
+    uint32_t _lastDropped;          // droppedEdges() at the last resync
+    bool _hardwareCounting;         // _passes comes from the PCNT unit
+
+    PassCallback _callback;
+    void* _callbackContext;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    pcnt_unit_handle_t _unit;
+    pcnt_channel_handle_t _channel;
+
+    bool _beginPulseCounter();
+    uint32_t _hardwareCount() const;
+#endif
+};
+
+#endif // PassCounter_h
@@ -0,0 +1,134 @@
+/**
+ * Scheduler.cpp - ESP32 Swing Gate Controller deadline scheduler
+ *
+ * Implementation of the deadline table. All arithmetic is on millis()
+ * differences, so deadlines survive the 49-day wrap.
+ */
+
+#include "scheduler.h"
+
+// ============================================================================
+// SCHEDULER CLASS IMPLEMENTATION
+// ============================================================================
+
+Scheduler::Scheduler() {
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        _tasks[i].handler = nullptr;
+        _tasks[i].context = nullptr;
+        _tasks[i].start = 0;
+        _tasks[i].interval = 0;
+        _tasks[i].periodic = false;
+        _tasks[i].generation = 0;
+    }
+}
+
+ScheduleId Scheduler::in(uint32_t delayMs, ScheduledHandler handler, void* context) {
+    return _add(delayMs, handler, context, false);
+}
+
+ScheduleId Scheduler::every(uint32_t intervalMs, ScheduledHandler handler, void* context) {
+    return _add(intervalMs, handler, context, true);
+}
+
+void Scheduler::cancel(ScheduleId& id) {
+    int index = _indexOf(id);
+    if (index >= 0) {
+        _tasks[index].handler = nullptr;
+    }
+    id = NO_SCHEDULE;
+}
+
+bool Scheduler::isScheduled(ScheduleId id) const {
+    return _indexOf(id) >= 0;
+}
+
+uint32_t Scheduler::tick() {
+    uint32_t now = millis();
+
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        Task& task = _tasks[i];
+        if (!task.handler || now - task.start < task.interval) {
+            continue;
+        }
+
+        // Handlers may cancel or add deadlines, including their own slot
+        uint8_t generation = task.generation;
+        bool repeat = task.handler(task.context);
+        if (!task.handler || task.generation != generation) {
+            continue;
+        }
+
+        if (task.periodic && repeat) {
+            // Keep the period drift-free, but don't replay missed periods
+            task.start += task.interval;
+            if (now - task.start >= task.interval) {
+                task.start = now;
+            }
+        } else {
+            task.handler = nullptr;
+        }
+    }
+
+    return msUntilNext();
+}
+
+uint32_t Scheduler::msUntilNext() const {
+    uint32_t now = millis();
+    uint32_t next = SCHEDULE_IDLE;
+
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        const Task& task = _tasks[i];
+        if (!task.handler) {
+            continue;
+        }
+        uint32_t elapsed = now - task.start;
+        if (elapsed >= task.interval) {
+            return 0;
+        }
+        uint32_t remaining = task.interval - elapsed;
+        if (remaining < next) {
+            next = remaining;
+        }
+    }
+    return next;
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+ScheduleId Scheduler::_add(uint32_t intervalMs, ScheduledHandler handler, void* context, bool periodic) {
+    if (!handler) {
+        return NO_SCHEDULE;
+    }
+
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        Task& task = _tasks[i];
+        if (task.handler) {
+            continue;
+        }
+
+        task.generation = task.generation == 0xFF ? 1 : task.generation + 1;
+        task.handler = handler;
+        task.context = context;
+        task.start = millis();
+        task.interval = intervalMs;
+        task.periodic = periodic;
+        return (ScheduleId)((task.generation << 8) | i);
+    }
+
+    Serial.println("[ERROR] Scheduler full, deadline dropped");
+    return NO_SCHEDULE;
+}
+
+int Scheduler::_indexOf(ScheduleId id) const {
+    if (id == NO_SCHEDULE) {
+        return -1;
+    }
+    uint8_t index = id & 0xFF;
+    uint8_t generation = id >> 8;
+    if (index >= MAX_TASKS || !_tasks[index].handler || _tasks[index].generation != generation) {
+        return -1;
+    }
+    return index;
+}
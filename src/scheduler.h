@@ -0,0 +1,97 @@
+/**
+ * Scheduler.h - ESP32 Swing Gate Controller deadline scheduler
+ *
+ * Fixed-capacity one-shot and periodic deadlines for all modules running
+ * in one task. Unlike polling a Timer<> per module, tick() reports how long
+ * the task may sleep until the earliest deadline, so the task can block
+ * until then (or until an input event wakes it) instead of waking on a
+ * fixed cadence.
+ */
+
+#ifndef Scheduler_h
+#define Scheduler_h
+
+#include "Arduino.h"
+
+/**
+ * Deadline handler
+ * @param context Opaque pointer given when scheduling
+ * @return true to run again after the interval (periodic), false to stop
+ */
+typedef bool (*ScheduledHandler)(void* context);
+
+// Handle of a scheduled deadline; 0 is never a valid handle
+typedef uint16_t ScheduleId;
+static const ScheduleId NO_SCHEDULE = 0;
+
+// Returned by tick()/msUntilNext() when nothing is scheduled
+static const uint32_t SCHEDULE_IDLE = 0xFFFFFFFFUL;
+
+// ============================================================================
+// SCHEDULER CLASS DECLARATION
+// ============================================================================
+class Scheduler {
+public:
+    static const uint8_t MAX_TASKS = 8;    // Deadlines per scheduler
+
+    Scheduler();
+
+    /**
+     * Run a handler once after a delay
+     * @param delayMs Delay in milliseconds
+     * @param handler Handler to call (its return value is ignored)
+     * @param context Passed to the handler
+     * @return Handle, or NO_SCHEDULE if all slots are taken
+     */
+    ScheduleId in(uint32_t delayMs, ScheduledHandler handler, void* context);
+
+    /**
+     * Run a handler periodically until it returns false or is cancelled
+     * @param intervalMs Interval in milliseconds (first run after one interval)
+     * @param handler Handler to call
+     * @param context Passed to the handler
+     * @return Handle, or NO_SCHEDULE if all slots are taken
+     */
+    ScheduleId every(uint32_t intervalMs, ScheduledHandler handler, void* context);
+
+    /**
+     * Cancel a deadline and clear the handle
+     * Stale or NO_SCHEDULE handles are ignored.
+     * @param id Handle returned by in()/every()
+     */
+    void cancel(ScheduleId& id);
+
+    /**
+     * Check whether a handle still refers to a pending deadline
+     */
+    bool isScheduled(ScheduleId id) const;
+
+    /**
+     * Run every handler whose deadline has passed
+     * @return Milliseconds until the next deadline, SCHEDULE_IDLE if none
+     */
+    uint32_t tick();
+
+    /**
+     * Milliseconds until the next deadline without running anything
+     * @return 0 if a deadline is due, SCHEDULE_IDLE if none
+     */
+    uint32_t msUntilNext() const;
+
+private:
+    struct Task {
+        ScheduledHandler handler;   // nullptr = free slot
+        void* context;
+        uint32_t start;             // millis() the interval counts from
+        uint32_t interval;          // Delay/period in milliseconds
+        bool periodic;              // every() vs in()
+        uint8_t generation;         // Bumped on reuse so stale handles miss
+    };
+
+    Task _tasks[MAX_TASKS];
+
+    ScheduleId _add(uint32_t intervalMs, ScheduledHandler handler, void* context, bool periodic);
+    int _indexOf(ScheduleId id) const;
+};
+
+#endif // Scheduler_h
@@ -0,0 +1,77 @@
+/**
+ * SpscQueue.h - ESP32 Swing Gate Controller lock-free queue
+ *
+ * Fixed-capacity single-producer/single-consumer ring buffer. push() and
+ * pop() never block or allocate, so the producer may be an ISR or another
+ * FreeRTOS task while the consumer runs in the main loop.
+ */
+
+#ifndef SpscQueue_h
+#define SpscQueue_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Force inlining so calls made from IRAM interrupt handlers stay in IRAM
+#define SPSC_INLINE inline __attribute__((always_inline))
+
+// ============================================================================
+// SPSC QUEUE TEMPLATE
+// ============================================================================
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() : _head(0), _tail(0) {}
+
+    /**
+     * Append an item (producer side only)
+     * @param item Item to copy into the queue
+     * @return false if the queue is full and the item was dropped
+     */
+    SPSC_INLINE bool push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        _items[head & (Capacity - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the oldest item (consumer side only)
+     * @param item Receives the item
+     * @return false if the queue is empty
+     */
+    SPSC_INLINE bool pop(T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[tail & (Capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Number of queued items (approximate when called concurrently)
+     */
+    size_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    T _items[Capacity];
+    std::atomic<uint32_t> _head;  // Next slot to write (producer)
+    std::atomic<uint32_t> _tail;  // Next slot to read (consumer)
+};
+
+#endif // SpscQueue_h
@@ -0,0 +1,277 @@
+/**
+ * StatusSerializer.cpp - ESP32 Swing Gate Controller status serializer
+ *
+ * Implementation of the allocation-free JSON and CBOR status writers.
+ */
+
+#include "statusserializer.h"
+
+// ============================================================================
+// BOUNDED BUFFER WRITER
+// ============================================================================
+namespace {
+
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t size)
+        : _buffer(buffer), _size(size), _length(0), _overflow(size == 0) {}
+
+    void raw(const char* text) {
+        while (*text) put(*text++);
+    }
+
+    void string(const char* text) {
+        put('"');
+        for (; text && *text; text++) {
+            char c = *text;
+            if (c == '"' || c == '\\') {
+                put('\\');
+                put(c);
+            } else if ((unsigned char)c < 0x20) {
+                // Control characters never occur in our fields; drop them
+                continue;
+            } else {
+                put(c);
+            }
+        }
+        put('"');
+    }
+
+    void key(const char* name) {
+        string(name);
+        put(':');
+    }
+
+    void boolean(bool value) {
+        raw(value ? "true" : "false");
+    }
+
+    void unsignedInt(uint32_t value) {
+        char digits[10];
+        int count = 0;
+        do {
+            digits[count++] = '0' + value % 10;
+            value /= 10;
+        } while (value > 0);
+        while (count > 0) put(digits[--count]);
+    }
+
+    void fixed(float value, uint8_t decimals) {
+        if (isnan(value) || isinf(value)) {
+            raw("null");
+            return;
+        }
+        uint32_t scale = 1;
+        for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+
+        if (value < 0) {
+            put('-');
+            value = -value;
+        }
+        uint32_t scaled = (uint32_t)(value * scale + 0.5f);
+        unsignedInt(scaled / scale);
+        if (decimals == 0) return;
+
+        put('.');
+        uint32_t fraction = scaled % scale;
+        for (uint32_t divisor = scale / 10; divisor > 0; divisor /= 10) {
+            put('0' + (fraction / divisor) % 10);
+        }
+    }
+
+    size_t finish() {
+        if (_overflow || _length >= _size) {
+            if (_size > 0) _buffer[0] = '\0';
+            return 0;
+        }
+        _buffer[_length] = '\0';
+        return _length;
+    }
+
+private:
+    void put(char c) {
+        // Keep one byte for the terminating NUL
+        if (_length + 1 >= _size) {
+            _overflow = true;
+            return;
+        }
+        _buffer[_length++] = c;
+    }
+
+    char* _buffer;
+    size_t _size;
+    size_t _length;
+    bool _overflow;
+};
+
+// CBOR major types (RFC 8949 section 3.1)
+const uint8_t CBOR_UNSIGNED = 0;
+const uint8_t CBOR_NEGATIVE = 1;
+const uint8_t CBOR_TEXT = 3;
+const uint8_t CBOR_MAP = 5;
+const uint8_t CBOR_FALSE = 0xF4;
+const uint8_t CBOR_TRUE = 0xF5;
+const uint8_t CBOR_NULL = 0xF6;
+
+class CborWriter {
+public:
+    CborWriter(uint8_t* buffer, size_t size)
+        : _buffer(buffer), _size(size), _length(0), _overflow(false) {}
+
+    void map(uint8_t entries) {
+        head(CBOR_MAP, entries);
+    }
+
+    void unsignedInt(uint32_t value) {
+        head(CBOR_UNSIGNED, value);
+    }
+
+    void signedInt(int32_t value) {
+        if (value >= 0) {
+            head(CBOR_UNSIGNED, (uint32_t)value);
+        } else {
+            head(CBOR_NEGATIVE, (uint32_t)(-1 - value));
+        }
+    }
+
+    void string(const char* text) {
+        size_t length = text ? strlen(text) : 0;
+        head(CBOR_TEXT, (uint32_t)length);
+        for (size_t i = 0; i < length; i++) put((uint8_t)text[i]);
+    }
+
+    void boolean(bool value) {
+        put(value ? CBOR_TRUE : CBOR_FALSE);
+    }
+
+    void null() {
+        put(CBOR_NULL);
+    }
+
+    size_t finish() {
+        return _overflow ? 0 : _length;
+    }
+
+private:
+    // Shortest-form head: argument inline below 24, else 1/2/4 bytes follow
+    void head(uint8_t major, uint32_t value) {
+        uint8_t type = major << 5;
+        if (value < 24) {
+            put(type | value);
+        } else if (value <= 0xFF) {
+            put(type | 24);
+            put(value);
+        } else if (value <= 0xFFFF) {
+            put(type | 25);
+            put(value >> 8);
+            put(value);
+        } else {
+            put(type | 26);
+            put(value >> 24);
+            put(value >> 16);
+            put(value >> 8);
+            put(value);
+        }
+    }
+
+    void put(uint8_t byte) {
+        if (_length >= _size) {
+            _overflow = true;
+            return;
+        }
+        _buffer[_length++] = byte;
+    }
+
+    uint8_t* _buffer;
+    size_t _size;
+    size_t _length;
+    bool _overflow;
+};
+
+// Round to a scaled integer; NaN/inf are reported as null by the caller
+int32_t scaled(float value, int32_t scale) {
+    float result = value * scale;
+    return (int32_t)(result < 0 ? result - 0.5f : result + 0.5f);
+}
+
+} // namespace
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+const char* statusFormatName(StatusFormat format) {
+    switch (format) {
+        case STATUS_FORMAT_JSON: return "JSON";
+        case STATUS_FORMAT_CBOR: return "CBOR";
+        default:                 return "INVALID";
+    }
+}
+
+size_t serializeStatusJson(const GateStatus& status, char* buffer, size_t size) {
+    JsonWriter json(buffer, size);
+
+    json.raw("{");
+    json.key("device_id");      json.string(status.deviceId);
+    json.raw(",");
+    json.key("timestamp");      json.unsignedInt(status.timestamp);
+    json.raw(",");
+    json.key("state");          json.string(gateStateName(status.state));
+    json.raw(",");
+    json.key("sensor_raw");     json.boolean(status.sensorRaw);
+    json.raw(",");
+    json.key("inputs");
+    json.raw("{");
+    json.key("gate_lights");    json.boolean(status.gateLights);
+    json.raw(",");
+    json.key("gate_lock");      json.boolean(status.gateLock);
+    json.raw(",");
+    json.key("external_relay"); json.boolean(status.externalRelay);
+    json.raw(",");
+    json.key("photo_eye");      json.boolean(status.photoEye);
+    json.raw("},");
+    json.key("temperature");
+    if (status.climateValid) json.fixed(status.temperature, 2); else json.raw("null");
+    json.raw(",");
+    json.key("humidity");
+    if (status.climateValid) json.fixed(status.humidity, 1); else json.raw("null");
+    json.raw(",");
+    json.key("uptime");         json.unsignedInt(status.uptime);
+    json.raw(",");
+    json.key("traffic");
+    json.raw("{");
+    json.key("passes");         json.unsignedInt(status.passes);
+    json.raw(",");
+    json.key("last_pass_ms");   json.unsignedInt(status.lastPassMs);
+    json.raw("}}");
+
+    return json.finish();
+}
+
+size_t serializeStatusCbor(const GateStatus& status, uint8_t* buffer, size_t size) {
+    CborWriter cbor(buffer, size);
+
+    uint8_t inputs = (status.gateLights ? STATUS_INPUT_GATE_LIGHTS : 0) |
+                     (status.gateLock ? STATUS_INPUT_GATE_LOCK : 0) |
+                     (status.externalRelay ? STATUS_INPUT_EXTERNAL_RELAY : 0) |
+                     (status.photoEye ? STATUS_INPUT_PHOTO_EYE : 0);
+    bool temperatureValid = status.climateValid && isfinite(status.temperature);
+    bool humidityValid = status.climateValid && isfinite(status.humidity) && status.humidity >= 0;
+
+    cbor.map(11);
+    cbor.unsignedInt(STATUS_KEY_VERSION);     cbor.unsignedInt(STATUS_CBOR_VERSION);
+    cbor.unsignedInt(STATUS_KEY_DEVICE_ID);   cbor.string(status.deviceId);
+    cbor.unsignedInt(STATUS_KEY_TIMESTAMP);   cbor.unsignedInt(status.timestamp);
+    cbor.unsignedInt(STATUS_KEY_STATE);       cbor.unsignedInt(status.state);
+    cbor.unsignedInt(STATUS_KEY_SENSOR_RAW);  cbor.boolean(status.sensorRaw);
+    cbor.unsignedInt(STATUS_KEY_INPUTS);      cbor.unsignedInt(inputs);
+    cbor.unsignedInt(STATUS_KEY_TEMPERATURE);
+    if (temperatureValid) cbor.signedInt(scaled(status.temperature, 100)); else cbor.null();
+    cbor.unsignedInt(STATUS_KEY_HUMIDITY);
+    if (humidityValid) cbor.unsignedInt(scaled(status.humidity, 10)); else cbor.null();
+    cbor.unsignedInt(STATUS_KEY_UPTIME);      cbor.unsignedInt(status.uptime);
+    cbor.unsignedInt(STATUS_KEY_PASSES);      cbor.unsignedInt(status.passes);
+    cbor.unsignedInt(STATUS_KEY_LAST_PASS_MS); cbor.unsignedInt(status.lastPassMs);
+
+    return cbor.finish();
+}
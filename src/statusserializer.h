@@ -0,0 +1,115 @@
+/**
+ * StatusSerializer.h - ESP32 Swing Gate Controller status serializer
+ *
+ * Serializes a gate status snapshot to JSON or to a compact CBOR map in a
+ * caller-provided buffer. Numbers are formatted by hand (no printf, no
+ * String) so publishing never touches the heap.
+ *
+ * CBOR layout (RFC 8949), version 1: one map with small unsigned keys so a
+ * status fits in about 40 bytes. Decoders must skip keys they don't know;
+ * incompatible changes bump STATUS_CBOR_VERSION.
+ *
+ *   0  version          uint (STATUS_CBOR_VERSION)
+ *   1  device_id        text
+ *   2  timestamp        uint, seconds since boot
+ *   3  state            uint, GateState value
+ *   4  sensor_raw       bool
+ *   5  inputs           uint bit field, see STATUS_INPUT_*
+ *   6  temperature      int, hundredths of a degree Celsius, or null
+ *   7  humidity         uint, tenths of a percent, or null
+ *   8  uptime           uint, seconds since boot
+ *   9  passes           uint, photo-eye passes since boot
+ *  10  last_pass_ms     uint, duration of the latest timed pass
+ */
+
+#ifndef StatusSerializer_h
+#define StatusSerializer_h
+
+#include "Arduino.h"
+#include "gate.h"  // Include gate.h for GateState enum
+
+// ============================================================================
+// STATUS SNAPSHOT
+// ============================================================================
+struct GateStatus {
+    const char* deviceId;   // MQTT client ID
+    uint32_t timestamp;     // Seconds since boot at time of publish
+    GateState state;        // Current gate state
+    bool sensorRaw;         // Debounced position sensor level (HIGH = closed)
+
+    // Discrete inputs
+    bool gateLights;        // Gate warning lights input
+    bool gateLock;          // Gate lock input
+    bool externalRelay;     // External relay input
+    bool photoEye;          // Photo eye input
+
+    // DHT22 climate reading
+    bool climateValid;      // false until a reading succeeded
+    float temperature;      // Degrees Celsius
+    float humidity;         // Relative humidity in percent
+
+    uint32_t uptime;        // Seconds since boot
+
+    // Photo-eye traffic
+    uint32_t passes;        // Beam interruptions since boot
+    uint32_t lastPassMs;    // Duration of the latest timed pass
+};
+
+// Large enough for the JSON document with a 31-character device ID
+const size_t STATUS_JSON_MAX_SIZE = 384;
+
+// Large enough for the CBOR document with a 31-character device ID
+const size_t STATUS_CBOR_MAX_SIZE = 96;
+const uint8_t STATUS_CBOR_VERSION = 1;
+
+// CBOR map keys
+enum StatusCborKey : uint8_t {
+    STATUS_KEY_VERSION = 0,
+    STATUS_KEY_DEVICE_ID = 1,
+    STATUS_KEY_TIMESTAMP = 2,
+    STATUS_KEY_STATE = 3,
+    STATUS_KEY_SENSOR_RAW = 4,
+    STATUS_KEY_INPUTS = 5,
+    STATUS_KEY_TEMPERATURE = 6,
+    STATUS_KEY_HUMIDITY = 7,
+    STATUS_KEY_UPTIME = 8,
+    STATUS_KEY_PASSES = 9,
+    STATUS_KEY_LAST_PASS_MS = 10
+};
+
+// Bits of the CBOR inputs field
+const uint8_t STATUS_INPUT_GATE_LIGHTS = 0x01;
+const uint8_t STATUS_INPUT_GATE_LOCK = 0x02;
+const uint8_t STATUS_INPUT_EXTERNAL_RELAY = 0x04;
+const uint8_t STATUS_INPUT_PHOTO_EYE = 0x08;
+
+// Status payload encoding on the MQTT status topic
+enum StatusFormat : uint8_t {
+    STATUS_FORMAT_JSON,
+    STATUS_FORMAT_CBOR
+};
+
+/**
+ * Get format name for logging without allocating
+ */
+const char* statusFormatName(StatusFormat format);
+
+/**
+ * Serialize status as JSON
+ * @param status Snapshot to serialize
+ * @param buffer Destination buffer
+ * @param size Size of destination buffer in bytes
+ * @return Length of the NUL-terminated document, or 0 if it did not fit
+ */
+size_t serializeStatusJson(const GateStatus& status, char* buffer, size_t size);
+
+/**
+ * Serialize status as a version 1 CBOR map (see layout above)
+ * @param status Snapshot to serialize
+ * @param buffer Destination buffer
+ * @param size Size of destination buffer in bytes
+ * @return Length of the encoded document, or 0 if it did not fit
+ */
+size_t serializeStatusCbor(const GateStatus& status, uint8_t* buffer, size_t size);
+
+#endif // StatusSerializer_h
@@ -0,0 +1,160 @@
+/**
+ * TravelEstimator.cpp - ESP32 Swing Gate Controller travel time learning
+ *
+ * Implementation of the smoothed estimator and its flash file.
+ */
+
+#include "travelestimator.h"
+
+namespace {
+
+// On-flash layout (little-endian, 8 bytes)
+struct TravelFile {
+    uint8_t magic;
+    uint8_t version;
+    uint16_t meanMs;
+    uint16_t deviationMs;
+    uint16_t samples;
+};
+static_assert(sizeof(TravelFile) == 8, "Travel estimate file layout changed");
+
+const uint8_t TRAVEL_FILE_MAGIC = 0x54;     // 'T'
+const uint8_t TRAVEL_FILE_VERSION = 1;
+
+} // namespace
+
+// ============================================================================
+// TRAVEL ESTIMATOR CLASS IMPLEMENTATION
+// ============================================================================
+
+TravelEstimator::TravelEstimator(uint32_t defaultMs)
+    : _defaultMs(defaultMs), _meanMs(defaultMs), _deviationMs(0), _samples(0),
+      _published(0), _publishedSamples(0) {
+    _publish();
+}
+
+TravelEstimator::TravelEstimator() : TravelEstimator(0) {
+}
+
+void TravelEstimator::setDefault(uint32_t defaultMs) {
+    _defaultMs = defaultMs;
+    if (_samples == 0) {
+        _meanMs = defaultMs;
+        _publish();
+    }
+}
+
+bool TravelEstimator::addSample(uint32_t travelMs) {
+    if (travelMs < MIN_SAMPLE_MS || travelMs > MAX_SAMPLE_MS) {
+        return false;
+    }
+
+    int32_t sample = (int32_t)travelMs;
+    if (_samples == 0) {
+        _meanMs = sample;
+        _deviationMs = sample / 4;
+    } else {
+        // Clip outliers to a few deviations so one odd cycle can't swing the mean
+        int32_t limit = 3 * _deviationMs + (int32_t)MIN_DEVIATION_MS;
+        int32_t error = sample - _meanMs;
+        if (error > limit) error = limit;
+        if (error < -limit) error = -limit;
+
+        // The deviation rises fast and decays slowly: it sets the margin
+        // of every timeout, so it follows the spread, not the last few cycles
+        int32_t deviationError = (error < 0 ? -error : error) - _deviationMs;
+        _meanMs += error / 8;
+        _deviationMs += deviationError / (deviationError > 0 ? 4 : 16);
+    }
+    if (_deviationMs < (int32_t)MIN_DEVIATION_MS) {
+        _deviationMs = MIN_DEVIATION_MS;
+    }
+    if (_samples < 0xFFFF) {
+        _samples++;
+    }
+
+    _publish();
+    return true;
+}
+
+uint32_t TravelEstimator::expectedMs() const {
+    return _samples ? (uint32_t)_meanMs : _defaultMs;
+}
+
+uint32_t TravelEstimator::timeoutMs() const {
+    // Before the first sample the default carries the deviation a first
+    // sample starts with (a quarter of it)
+    uint32_t timeout = _samples ? (uint32_t)(_meanMs + MARGIN_DEVIATIONS * _deviationMs)
+                                : _defaultMs + MARGIN_DEVIATIONS * (_defaultMs / 4);
+    return timeout > MAX_SAMPLE_MS ? MAX_SAMPLE_MS : timeout;
+}
+
+TravelEstimate TravelEstimator::estimate() const {
+    uint32_t packed = _published.load(std::memory_order_relaxed);
+    TravelEstimate estimate;
+    estimate.meanMs = packed & 0xFFFF;
+    estimate.deviationMs = packed >> 16;
+    estimate.samples = _publishedSamples.load(std::memory_order_relaxed);
+    return estimate;
+}
+
+bool TravelEstimator::load(fs::FS& fs, const char* path) {
+    fs::File file = fs.open(path, FILE_READ);
+    if (!file) {
+        return false;
+    }
+
+    TravelFile record;
+    size_t read = file.read((uint8_t*)&record, sizeof(record));
+    file.close();
+
+    if (read != sizeof(record) || record.magic != TRAVEL_FILE_MAGIC ||
+        record.version != TRAVEL_FILE_VERSION || record.samples == 0 ||
+        record.meanMs < MIN_SAMPLE_MS || record.meanMs > MAX_SAMPLE_MS) {
+        Serial.println("[TRAVEL] Ignoring invalid travel estimate file");
+        return false;
+    }
+
+    _meanMs = record.meanMs;
+    _deviationMs = record.deviationMs < MIN_DEVIATION_MS ? MIN_DEVIATION_MS : record.deviationMs;
+    _samples = record.samples;
+    _publish();
+
+    Serial.print("[TRAVEL] Loaded travel time ");
+    Serial.print(_meanMs);
+    Serial.print(" ms +/- ");
+    Serial.print(_deviationMs);
+    Serial.print(" ms from ");
+    Serial.print(_samples);
+    Serial.println(" samples");
+    return true;
+}
+
+bool TravelEstimator::save(fs::FS& fs, const char* path) const {
+    TravelEstimate current = estimate();
+
+    TravelFile record;
+    record.magic = TRAVEL_FILE_MAGIC;
+    record.version = TRAVEL_FILE_VERSION;
+    record.meanMs = current.meanMs;
+    record.deviationMs = current.deviationMs;
+    record.samples = current.samples;
+
+    fs::File file = fs.open(path, FILE_WRITE);
+    if (!file) {
+        return false;
+    }
+    size_t written = file.write((const uint8_t*)&record, sizeof(record));
+    file.close();
+    return written == sizeof(record);
+}
+
+// ============================================================================
+// PRIVATE METHODS
+// ============================================================================
+
+void TravelEstimator::_publish() {
+    uint32_t packed = (uint32_t)(uint16_t)_meanMs | ((uint32_t)(uint16_t)_deviationMs << 16);
+    _published.store(packed, std::memory_order_relaxed);
+    _publishedSamples.store(_samples, std::memory_order_relaxed);
+}
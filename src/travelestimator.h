@@ -0,0 +1,111 @@
+/**
+ * TravelEstimator.h - ESP32 Swing Gate Controller travel time learning
+ *
+ * Running estimate of how long the gate takes to travel end to end,
+ * learned from closes that start fully open and end on the closed-position
+ * sensor. The sensor only sees the closed end, so the opening time is taken
+ * to be the same (the Sommer operator drives both leaves at one speed in
+ * either direction).
+ *
+ * The estimator follows the classic smoothed mean / mean deviation scheme:
+ * the expected travel time tracks the mean, while timeouts that declare a
+ * move over (or failed) add a margin of several deviations. The mean alone
+ * is no end of travel: about half of all moves take longer. A single outlier (a leaf
+ * held back by hand, wind) is clipped before it moves the mean, but a
+ * lasting change (winter grease) is followed within a few cycles.
+ *
+ * Samples are added by the control task only; estimate() may be read from
+ * any task, e.g. by the network task persisting it to flash.
+ */
+
+#ifndef TravelEstimator_h
+#define TravelEstimator_h
+
+#include "Arduino.h"
+#include <FS.h>
+#include <atomic>
+
+/**
+ * Estimator state as persisted and reported
+ */
+struct TravelEstimate {
+    uint16_t meanMs;        // Smoothed travel time
+    uint16_t deviationMs;   // Smoothed mean absolute deviation
+    uint16_t samples;       // Accepted samples (saturates), 0 = default
+};
+
+// ============================================================================
+// TRAVEL ESTIMATOR CLASS DECLARATION
+// ============================================================================
+class TravelEstimator {
+public:
+    static const uint32_t MIN_SAMPLE_MS = 3000;     // Shorter: not a full travel
+    static const uint32_t MAX_SAMPLE_MS = 60000;    // Longer: closed by hand later
+    static const uint32_t MIN_DEVIATION_MS = 250;   // Floor of the margin unit
+    static const uint8_t MARGIN_DEVIATIONS = 4;     // Timeout = mean + 4 deviations
+
+    /**
+     * Constructor
+     * @param defaultMs Travel time used until the first sample (the timeout adds a margin)
+     */
+    explicit TravelEstimator(uint32_t defaultMs);
+
+    /**
+     * Constructor for arrays of estimators; set the default before use
+     */
+    TravelEstimator();
+
+    /**
+     * Set the travel time used until the first sample
+     */
+    void setDefault(uint32_t defaultMs);
+
+    /**
+     * Add one measured end-to-end travel time
+     * @param travelMs Time from the close command to the sensor closing
+     * @return false if the sample was outside the plausible range
+     */
+    bool addSample(uint32_t travelMs);
+
+    /**
+     * Expected travel time (best guess for when a move has finished)
+     */
+    uint32_t expectedMs() const;
+
+    /**
+     * Time after which a move has ended: OPENING is taken as open, a
+     * CLOSING that did not reach the sensor as failed
+     */
+    uint32_t timeoutMs() const;
+
+    /**
+     * Current estimate, safe to call from any task
+     */
+    TravelEstimate estimate() const;
+
+    /**
+     * Load a persisted estimate; call before the control task starts
+     * @return false if the file is missing or invalid (defaults are kept)
+     */
+    bool load(fs::FS& fs, const char* path);
+
+    /**
+     * Persist the current estimate (any task; not the control task)
+     * @return false on a write error
+     */
+    bool save(fs::FS& fs, const char* path) const;
+
+private:
+    uint32_t _defaultMs;
+    int32_t _meanMs;
+    int32_t _deviationMs;
+    uint16_t _samples;
+
+    // Published copy for other tasks: mean | deviation << 16, and samples
+    std::atomic<uint32_t> _published;
+    std::atomic<uint16_t> _publishedSamples;
+
+    void _publish();
+};
+
+#endif // TravelEstimator_h